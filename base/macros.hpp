@@ -69,6 +69,16 @@ char const* const kArchitecture = "x86-64";
 #error "Have you tried a Cray-1?"
 #endif
 
+// Vector instruction sets that the compiler is allowed to emit.  MSVC doesn't
+// define |__SSE2__|, so we have to look at the target architecture.
+#if defined(__AVX__)
+#define ARCH_CPU_HAS_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARCH_CPU_HAS_SSE2 1
+#endif
+
 #if defined(CDECL)
 #  error "CDECL already defined"
 #else
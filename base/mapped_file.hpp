@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+
+// A read-only mapping of an entire file in memory.  The file is mapped at
+// construction and unmapped at destruction; the pages are only read from disk
+// when they are first accessed, so the cost of the construction doesn't depend
+// on the size of the file.
+class MappedFile {
+ public:
+  // Maps the file |filename|, which must exist and must not be empty.
+  explicit MappedFile(std::string const& filename);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile(MappedFile&&) = delete;  // NOLINT(build/c++11)
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;  // NOLINT(build/c++11)
+
+  // The first byte of the mapping, which is aligned at least on a page
+  // boundary.
+  char const* data() const;
+  std::size_t size() const;
+
+ private:
+  char const* data_ = nullptr;
+  std::size_t size_ = 0;
+#if OS_WIN
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/mapped_file_body.hpp"
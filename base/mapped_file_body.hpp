@@ -0,0 +1,92 @@
+#pragma once
+
+#include "base/mapped_file.hpp"
+
+#if OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+
+#if OS_WIN
+
+inline MappedFile::MappedFile(std::string const& filename) {
+  file_ = CreateFileA(filename.c_str(),
+                      GENERIC_READ,
+                      FILE_SHARE_READ,
+                      nullptr /*lpSecurityAttributes*/,
+                      OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL,
+                      nullptr /*hTemplateFile*/);
+  CHECK(file_ != INVALID_HANDLE_VALUE) << "Cannot open " << filename;
+  LARGE_INTEGER size;
+  CHECK(GetFileSizeEx(file_, &size)) << "Cannot get the size of " << filename;
+  CHECK_LT(0, size.QuadPart) << filename << " is empty";
+  size_ = static_cast<std::size_t>(size.QuadPart);
+  mapping_ = CreateFileMappingA(file_,
+                                nullptr /*lpFileMappingAttributes*/,
+                                PAGE_READONLY,
+                                0 /*dwMaximumSizeHigh*/,
+                                0 /*dwMaximumSizeLow*/,
+                                nullptr /*lpName*/);
+  CHECK_NOTNULL(mapping_);
+  data_ = static_cast<char const*>(MapViewOfFile(mapping_,
+                                                 FILE_MAP_READ,
+                                                 0 /*dwFileOffsetHigh*/,
+                                                 0 /*dwFileOffsetLow*/,
+                                                 0 /*dwNumberOfBytesToMap*/));
+  CHECK_NOTNULL(data_);
+}
+
+inline MappedFile::~MappedFile() {
+  UnmapViewOfFile(data_);
+  CloseHandle(mapping_);
+  CloseHandle(file_);
+}
+
+#else
+
+inline MappedFile::MappedFile(std::string const& filename) {
+  int const file = open(filename.c_str(), O_RDONLY);
+  CHECK_LE(0, file) << "Cannot open " << filename;
+  struct stat status;
+  CHECK_EQ(0, fstat(file, &status)) << "Cannot get the size of " << filename;
+  CHECK_LT(0, status.st_size) << filename << " is empty";
+  size_ = static_cast<std::size_t>(status.st_size);
+  void* const data = mmap(nullptr /*addr*/,
+                          size_,
+                          PROT_READ,
+                          MAP_SHARED,
+                          file,
+                          0 /*offset*/);
+  CHECK(data != MAP_FAILED) << "Cannot map " << filename;
+  data_ = static_cast<char const*>(data);
+  // The mapping remains valid after the file descriptor is closed.
+  close(file);
+}
+
+inline MappedFile::~MappedFile() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+inline char const* MappedFile::data() const {
+  return data_;
+}
+
+inline std::size_t MappedFile::size() const {
+  return size_;
+}
+
+}  // namespace base
+}  // namespace principia
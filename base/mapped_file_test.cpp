@@ -0,0 +1,56 @@
+#include "base/mapped_file.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+
+using ::testing::Eq;
+
+namespace base {
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  MappedFileTest()
+      : filename_("mapped_file_test.bin") {}
+
+  ~MappedFileTest() override {
+    std::remove(filename_.c_str());
+  }
+
+  std::string const filename_;
+};
+
+TEST_F(MappedFileTest, Contents) {
+  std::string contents;
+  for (int i = 0; i < 10000; ++i) {
+    contents.push_back(static_cast<char>(i % 251));
+  }
+  {
+    std::ofstream file(filename_, std::ios::binary);
+    file.write(contents.data(), contents.size());
+  }
+  MappedFile const mapped_file(filename_);
+  EXPECT_THAT(mapped_file.size(), Eq(contents.size()));
+  EXPECT_THAT(std::string(mapped_file.data(), mapped_file.size()),
+              Eq(contents));
+}
+
+using MappedFileDeathTest = MappedFileTest;
+
+TEST_F(MappedFileDeathTest, Error) {
+  EXPECT_DEATH({
+    MappedFile const mapped_file(filename_ + ".does_not_exist");
+  }, "Cannot open");
+  EXPECT_DEATH({
+    { std::ofstream file(filename_, std::ios::binary); }
+    MappedFile const mapped_file(filename_);
+  }, "is empty");
+}
+
+}  // namespace base
+}  // namespace principia
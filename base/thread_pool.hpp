@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <list>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+
+// A pool of threads that are created at construction and joined at
+// destruction.  Clients add functions to be executed by the pool, and obtain
+// futures that they may wait on to get the results.  The functions are
+// executed in the order in which they were added, but since there are
+// multiple threads they may complete in any order.
+template<typename T>
+class ThreadPool {
+ public:
+  // Creates a pool with |pool_size| threads.
+  explicit ThreadPool(int const pool_size);
+
+  // Waits for all the functions that were added to complete, and then joins
+  // the threads.
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const&) = delete;
+  ThreadPool(ThreadPool&&) = delete;  // NOLINT(build/c++11)
+  ThreadPool& operator=(ThreadPool const&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;  // NOLINT(build/c++11)
+
+  // Adds a |function| to be executed by a thread of the pool.  Returns a future
+  // which becomes ready when the |function| has been executed.  Exceptions
+  // thrown by |function| are propagated through the future.
+  std::future<T> Add(std::function<T()> function);
+
+  int size() const;
+
+ private:
+  // The body of each thread: dequeues the calls in order and executes them
+  // until |shutdown_| is set and there are no calls left.
+  void DequeueCallAndExecute();
+
+  std::mutex lock_;
+  std::condition_variable has_calls_or_shutdown_;
+
+  bool shutdown_ GUARDED_BY(lock_) = false;
+  std::list<std::packaged_task<T()>> calls_ GUARDED_BY(lock_);
+
+  // Not modified after construction.
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/thread_pool_body.hpp"
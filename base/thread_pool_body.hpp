@@ -0,0 +1,77 @@
+#pragma once
+
+#include "base/thread_pool.hpp"
+
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+
+template<typename T>
+ThreadPool<T>::ThreadPool(int const pool_size) {
+  CHECK_LT(0, pool_size);
+  threads_.reserve(pool_size);
+  for (int i = 0; i < pool_size; ++i) {
+    threads_.emplace_back(&ThreadPool::DequeueCallAndExecute, this);
+  }
+}
+
+template<typename T>
+ThreadPool<T>::~ThreadPool() {
+  {
+    std::unique_lock<std::mutex> l(lock_);
+    shutdown_ = true;
+  }
+  has_calls_or_shutdown_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+template<typename T>
+std::future<T> ThreadPool<T>::Add(std::function<T()> function) {
+  std::future<T> result;
+  {
+    std::unique_lock<std::mutex> l(lock_);
+    CHECK(!shutdown_);
+    calls_.emplace_back(std::move(function));
+    result = calls_.back().get_future();
+  }
+  has_calls_or_shutdown_.notify_one();
+  return result;
+}
+
+template<typename T>
+int ThreadPool<T>::size() const {
+  return static_cast<int>(threads_.size());
+}
+
+template<typename T>
+void ThreadPool<T>::DequeueCallAndExecute() {
+  for (;;) {
+    std::packaged_task<T()> this_call;
+
+    // Wait until either there is a call to execute or the pool is being shut
+    // down.  In the latter case, the remaining calls are still executed.
+    {
+      std::unique_lock<std::mutex> l(lock_);
+      has_calls_or_shutdown_.wait(l, [this]() {
+        return shutdown_ || !calls_.empty();
+      });
+      if (calls_.empty()) {
+        return;
+      }
+      this_call = std::move(calls_.front());
+      calls_.pop_front();
+    }
+
+    // Execute the call outside of the lock.  The packaged task takes care of
+    // storing the result (or the exception) in the future.
+    this_call();
+  }
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,88 @@
+#include "base/thread_pool.hpp"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <future>  // NOLINT(build/c++11)
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <stdexcept>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::Le;
+
+namespace base {
+
+class ThreadPoolTest : public ::testing::Test {
+ protected:
+  ThreadPoolTest() : pool_(7) {}
+
+  ThreadPool<int> pool_;
+};
+
+// Check that the calls are executed and that their results are propagated
+// through the futures.
+TEST_F(ThreadPoolTest, Results) {
+  EXPECT_THAT(pool_.size(), Eq(7));
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 1000; ++i) {
+    futures.push_back(pool_.Add([i]() { return i * i; }));
+  }
+  std::vector<int> expected;
+  std::vector<int> actual;
+  for (int i = 0; i < 1000; ++i) {
+    expected.push_back(i * i);
+    actual.push_back(futures[i].get());
+  }
+  EXPECT_THAT(actual, ElementsAreArray(expected));
+}
+
+// Check that the calls are executed on at most |pool_size| threads, none of
+// which is the calling thread.
+TEST_F(ThreadPoolTest, ParallelExecution) {
+  std::mutex lock;
+  std::set<std::thread::id> thread_ids;
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(pool_.Add([&lock, &thread_ids]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      std::unique_lock<std::mutex> l(lock);
+      thread_ids.insert(std::this_thread::get_id());
+      return 0;
+    }));
+  }
+  for (auto& future : futures) {
+    future.wait();
+  }
+  EXPECT_THAT(thread_ids.size(), Le(7));
+  EXPECT_EQ(0, thread_ids.count(std::this_thread::get_id()));
+}
+
+TEST_F(ThreadPoolTest, Exception) {
+  std::future<int> future =
+      pool_.Add([]() -> int { throw std::runtime_error("Boom"); });
+  EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+// Check that the destructor doesn't drop the pending calls.
+TEST_F(ThreadPoolTest, Destruction) {
+  std::vector<int> results(100);
+  {
+    ThreadPool<void> pool(3);
+    for (int i = 0; i < 100; ++i) {
+      pool.Add([i, &results]() { results[i] = i + 1; });
+    }
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(results[i], Eq(i + 1));
+  }
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,146 @@
+// .\Release\benchmarks.exe --benchmark_filter=Gravity  // NOLINT(whitespace/line_length)
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "physics/barnes_hut_tree.hpp"
+#include "physics/pairwise_gravity.hpp"
+#include "quantities/numbers.hpp"
+
+// Must come last to avoid conflicts when defining the CHECK macros.
+#include "benchmark/benchmark.h"
+
+namespace principia {
+
+using base::not_null;
+using physics::internal::AddGravitationalAccelerationsBetweenPointMasses;
+using physics::internal::BarnesHutTree;
+using physics::internal::R3ElementsSoA;
+
+namespace benchmarks {
+
+namespace {
+
+double const kOpeningAngle = 0.5;
+
+// A disc of |number_of_bodies| minor bodies with semimajor axes between 2 and
+// 4 AU, roughly like the main belt.
+void FillMainBelt(
+    int const number_of_bodies,
+    not_null<R3ElementsSoA*> const positions,
+    not_null<std::vector<double>*> const gravitational_parameters) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> radius_distribution(3E11, 6E11);
+  std::uniform_real_distribution<> angle_distribution(0, 2 * π);
+  std::uniform_real_distribution<> height_distribution(-3E10, 3E10);
+  std::uniform_real_distribution<> μ_distribution(1E6, 1E10);
+  positions->resize(number_of_bodies);
+  gravitational_parameters->clear();
+  for (int b = 0; b < number_of_bodies; ++b) {
+    double const r = radius_distribution(random);
+    double const θ = angle_distribution(random);
+    positions->x[b] = r * std::cos(θ);
+    positions->y[b] = r * std::sin(θ);
+    positions->z[b] = height_distribution(random);
+    gravitational_parameters->push_back(μ_distribution(random));
+  }
+}
+
+void ComputeDirectAccelerations(
+    int const number_of_bodies,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations) {
+  accelerations->Clear(0, number_of_bodies);
+  for (int b1 = 0; b1 < number_of_bodies; ++b1) {
+    AddGravitationalAccelerationsBetweenPointMasses(b1,
+                                                    b1 + 1,
+                                                    number_of_bodies,
+                                                    positions,
+                                                    gravitational_parameters,
+                                                    accelerations);
+  }
+}
+
+void ComputeTreeAccelerations(
+    int const number_of_bodies,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<BarnesHutTree*> const tree,
+    not_null<R3ElementsSoA*> const accelerations) {
+  accelerations->Clear(0, number_of_bodies);
+  tree->Build(0, number_of_bodies, positions, gravitational_parameters);
+  tree->AddAccelerations(kOpeningAngle,
+                         0, number_of_bodies,
+                         positions,
+                         gravitational_parameters,
+                         accelerations);
+}
+
+}  // namespace
+
+// The label is the norm of the acceleration of the first body.
+void BM_DirectGravity(benchmark::State& state) {  // NOLINT(runtime/references)
+  int const number_of_bodies = state.range_x();
+  R3ElementsSoA positions;
+  std::vector<double> gravitational_parameters;
+  FillMainBelt(number_of_bodies, &positions, &gravitational_parameters);
+  R3ElementsSoA accelerations(number_of_bodies);
+  while (state.KeepRunning()) {
+    ComputeDirectAccelerations(number_of_bodies,
+                               positions,
+                               gravitational_parameters,
+                               &accelerations);
+  }
+  std::stringstream ss;
+  ss << std::sqrt(accelerations.x[0] * accelerations.x[0] +
+                  accelerations.y[0] * accelerations.y[0] +
+                  accelerations.z[0] * accelerations.z[0]) << " m s^-2";
+  state.SetLabel(ss.str());
+}
+
+// The label is the mean relative error of the accelerations with respect to
+// the direct sum.
+void BM_TreeGravity(benchmark::State& state) {  // NOLINT(runtime/references)
+  int const number_of_bodies = state.range_x();
+  R3ElementsSoA positions;
+  std::vector<double> gravitational_parameters;
+  FillMainBelt(number_of_bodies, &positions, &gravitational_parameters);
+  BarnesHutTree tree;
+  R3ElementsSoA accelerations(number_of_bodies);
+  while (state.KeepRunning()) {
+    ComputeTreeAccelerations(number_of_bodies,
+                             positions,
+                             gravitational_parameters,
+                             &tree,
+                             &accelerations);
+  }
+
+  R3ElementsSoA direct_accelerations(number_of_bodies);
+  ComputeDirectAccelerations(number_of_bodies,
+                             positions,
+                             gravitational_parameters,
+                             &direct_accelerations);
+  double total_relative_error = 0;
+  for (int b = 0; b < number_of_bodies; ++b) {
+    double const Δx = accelerations.x[b] - direct_accelerations.x[b];
+    double const Δy = accelerations.y[b] - direct_accelerations.y[b];
+    double const Δz = accelerations.z[b] - direct_accelerations.z[b];
+    total_relative_error +=
+        std::sqrt((Δx * Δx + Δy * Δy + Δz * Δz) /
+                  (direct_accelerations.x[b] * direct_accelerations.x[b] +
+                   direct_accelerations.y[b] * direct_accelerations.y[b] +
+                   direct_accelerations.z[b] * direct_accelerations.z[b]));
+  }
+  state.SetLabel(std::to_string(total_relative_error / number_of_bodies));
+}
+
+BENCHMARK(BM_DirectGravity)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_TreeGravity)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace benchmarks
+}  // namespace principia
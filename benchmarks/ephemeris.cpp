@@ -50,7 +50,110 @@
 // BM_EphemerisLEOProbeAllBodiesAndOblateness_mean    17535248654 17196510233          1                                 750001 steps, +9.99958313425507670e-01 ua, +9.99469266237663870e+01 nmi  // NOLINT(whitespace/line_length)
 // BM_EphemerisLEOProbeAllBodiesAndOblateness_stddev     80019061    51477704          0                                 750001 steps, +9.99958313425507670e-01 ua, +9.99469266237663870e+01 nmi  // NOLINT(whitespace/line_length)
 
+// ./bm_eph --benchmark_repetitions=3 --benchmark_filter='LEOProbeMajorBodiesOnly(|PI|RKN646FM|RKN646FMPI)$'                                             // NOLINT(whitespace/line_length)
+// g++ 12.2.0 -O3 -march=native, Linux, 1 X 2000 MHz CPU
+// 2026/10/16
+// Benchmark                                                  Time(ns)      CPU(ns) Iterations                                                           // NOLINT(whitespace/line_length)
+// -------------------------------------------------------------------------------------                                                                 // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnly                  2404198960   2356065149            1 750001 steps, +9.99958336078923371e-01 ua, +9.99470404109436856e+01 nmi, 3 rejected, 12/2250013 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnly                  2833051196   2781873484            1 750001 steps, +9.99958336078923371e-01 ua, +9.99470404109436856e+01 nmi, 3 rejected, 12/2250013 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnly                  2627144508   2580653295            1 750001 steps, +9.99958336078923371e-01 ua, +9.99470404109436856e+01 nmi, 3 rejected, 12/2250013 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnly_mean             2621464888   2572863976            3 750001 steps, +9.99958336078923371e-01 ua, +9.99470404109436856e+01 nmi, 3 rejected, 12/2250013 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnly_stddev            214482525    213011008            3 750001 steps, +9.99958336078923371e-01 ua, +9.99470404109436856e+01 nmi, 3 rejected, 12/2250013 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM           640808354    636350737            1 161544 steps, +9.99964031062668957e-01 ua, +9.99648865159690416e+01 nmi, 3 rejected, 18/807734 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM           673110570    667413446            1 161544 steps, +9.99964031062668957e-01 ua, +9.99648865159690416e+01 nmi, 3 rejected, 18/807734 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM           644188462    620332416            1 161544 steps, +9.99964031062668957e-01 ua, +9.99648865159690416e+01 nmi, 3 rejected, 18/807734 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM_mean      652702462    641365533            3 161544 steps, +9.99964031062668957e-01 ua, +9.99648865159690416e+01 nmi, 3 rejected, 18/807734 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM_stddev     17754561     23937773            3 161544 steps, +9.99964031062668957e-01 ua, +9.99648865159690416e+01 nmi, 3 rejected, 18/807734 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyPI                2924811850   2852766296            1 959020 steps, +9.99969612201819569e-01 ua, +9.99814101933183821e+01 nmi, 3 rejected, 12/2877070 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyPI                2708884253   2682907924            1 959020 steps, +9.99969612201819569e-01 ua, +9.99814101933183821e+01 nmi, 3 rejected, 12/2877070 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyPI                3432420725   3369848417            1 959020 steps, +9.99969612201819569e-01 ua, +9.99814101933183821e+01 nmi, 3 rejected, 12/2877070 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyPI_mean           3022038943   2968507546            3 959020 steps, +9.99969612201819569e-01 ua, +9.99814101933183821e+01 nmi, 3 rejected, 12/2877070 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyPI_stddev          371437865    357797202            3 959020 steps, +9.99969612201819569e-01 ua, +9.99814101933183821e+01 nmi, 3 rejected, 12/2877070 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI        1176190321   1159346557            1 206676 steps, +9.99972571314931447e-01 ua, +9.99895684944604568e+01 nmi, 3 rejected, 18/1033394 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI        1346403134   1333775190            1 206676 steps, +9.99972571314931447e-01 ua, +9.99895684944604568e+01 nmi, 3 rejected, 18/1033394 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI        1404078656   1384505516            1 206676 steps, +9.99972571314931447e-01 ua, +9.99895684944604568e+01 nmi, 3 rejected, 18/1033394 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI_mean   1308890704   1292542421            3 206676 steps, +9.99972571314931447e-01 ua, +9.99895684944604568e+01 nmi, 3 rejected, 18/1033394 evaluations wasted  // NOLINT(whitespace/line_length)
+// BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI_stddev  118484852    118106922            3 206676 steps, +9.99972571314931447e-01 ua, +9.99895684944604568e+01 nmi, 3 rejected, 18/1033394 evaluations wasted  // NOLINT(whitespace/line_length)
+
+// ./bm_eph --benchmark_repetitions=3 --benchmark_filter=SolarSystemMajorBodiesOnly                                                                                                                       // NOLINT(whitespace/line_length)
+// g++ 12.2.0 -O3 -march=native -DNDEBUG, Debian 12 Linux x86-64, 1 X 2000 MHz CPU                                                                                                                        // NOLINT(whitespace/line_length)
+// 2026/10/17
+// Benchmark                                                               Time(ns)      CPU(ns) Iterations                                                                                               // NOLINT(whitespace/line_length)
+// -------------------------------------------------------------------------------------                                                                                                                  // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/45                                  1.0799e+10   1.0613e+10            1 +1.00027592626771655e+00 ua, +7.37869884514367129e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/45                                  9423631134   9246358194            1 +1.00027592626771655e+00 ua, +7.37869884514367129e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/45                                  1.0010e+10   9850262886            1 +1.00027592626771655e+00 ua, +7.37869884514367129e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/45_mean                             1.0078e+10   9903203371            3 +1.00027592626771655e+00 ua, +7.37869884514367129e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/45_stddev                            690012260    684851797            3 +1.00027592626771655e+00 ua, +7.37869884514367129e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/180                                 2860969456   2814107995            1 +1.00027592626852679e+00 ua, +7.38325241643542824e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/180                                 2580472203   2551001949            1 +1.00027592626852679e+00 ua, +7.38325241643542824e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/180                                 2563058661   2527297034            1 +1.00027592626852679e+00 ua, +7.38325241643542824e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/180_mean                            2668166773   2630802326            3 +1.00027592626852679e+00 ua, +7.38325241643542824e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/180_stddev                           167198875    159189217            3 +1.00027592626852679e+00 ua, +7.38325241643542824e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/360                                 1122886313   1112231565            1 +1.00027592633214191e+00 ua, +7.66053164528152593e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/360                                 1191401592   1179046306            1 +1.00027592633214191e+00 ua, +7.66053164528152593e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/360                                 1358062657   1320375360            1 +1.00027592633214191e+00 ua, +7.66053164528152593e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/360_mean                            1224116854   1203884410            3 +1.00027592633214191e+00 ua, +7.66053164528152593e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/360_stddev                           120953274    106271626            3 +1.00027592633214191e+00 ua, +7.66053164528152593e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/720                                  645708926    641794547            1 +1.00027593038395302e+00 ua, +6.51895034344832197e+02 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/720                                  610840898    603397752            1 +1.00027593038395302e+00 ua, +6.51895034344832197e+02 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/720                                  663790498    660769862            1 +1.00027593038395302e+00 ua, +6.51895034344832197e+02 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/720_mean                             640113441    635320720            3 +1.00027593038395302e+00 ua, +6.51895034344832197e+02 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnly/720_stddev                            26914627     29228797            3 +1.00027593038395302e+00 ua, +6.51895034344832197e+02 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/45         5669373959   5600642435            1 +1.00027592625443384e+00 ua, +5.56839424928706261e+00 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/45         5300171598   5214531684            1 +1.00027592625443384e+00 ua, +5.56839424928706261e+00 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/45         5868271219   5780260812            1 +1.00027592625443384e+00 ua, +5.56839424928706261e+00 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/45_mean    5612605592   5531811644            3 +1.00027592625443384e+00 ua, +5.56839424928706261e+00 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/45_stddev   288272927    289077187            3 +1.00027592625443384e+00 ua, +5.56839424928706261e+00 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/90         3030413226   2994446956            1 +1.00027592626771367e+00 ua, +9.14120327271436111e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/90         2780675435   2737272339            1 +1.00027592626771367e+00 ua, +9.14120327271436111e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/90         2695723369   2660659341            1 +1.00027592626771367e+00 ua, +9.14120327271436111e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/90_mean    2835604010   2797459545            3 +1.00027592626771367e+00 ua, +9.14120327271436111e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/90_stddev   173974672    174843981            3 +1.00027592626771367e+00 ua, +9.14120327271436111e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/180        1275581376   1265216647            1 +1.00027592626651818e+00 ua, +8.40317182535608538e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/180        1302636917   1287400510            1 +1.00027592626651818e+00 ua, +8.40317182535608538e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/180        1496859436   1476838845            1 +1.00027592626651818e+00 ua, +8.40317182535608538e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/180_mean   1358359243   1343152001            3 +1.00027592626651818e+00 ua, +8.40317182535608538e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/180_stddev  120705129    116306321            3 +1.00027592626651818e+00 ua, +8.40317182535608538e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/240        1118256514   1105603534            1 +1.00027582089588174e+00 ua, +1.20833686054025718e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/240        1181697916   1147198860            1 +1.00027582089588174e+00 ua, +1.20833686054025718e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/240        1097819664   1084312361            1 +1.00027582089588174e+00 ua, +1.20833686054025718e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/240_mean   1132591365   1112371585            3 +1.00027582089588174e+00 ua, +1.20833686054025718e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8/240_stddev   43737927     31984884            3 +1.00027582089588174e+00 ua, +1.20833686054025718e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/45        5266335572   5127054711            1 +1.00027592626635764e+00 ua, +7.38386581851990371e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/45        5678287951   5567411765            1 +1.00027592626635764e+00 ua, +7.38386581851990371e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/45        6277392277   6161687635            1 +1.00027592626635764e+00 ua, +7.38386581851990371e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/45_mean   5740671933   5618718037            3 +1.00027592626635764e+00 ua, +7.38386581851990371e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/45_stddev  508407058    519221121            3 +1.00027592626635764e+00 ua, +7.38386581851990371e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/60        5125501157   5020594481            1 +1.00027675249666870e+00 ua, +1.59942313009916781e+06 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/60        4700493628   4615027624            1 +1.00027675249666870e+00 ua, +1.59942313009916781e+06 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/60        4363077111   4275932232            1 +1.00027675249666870e+00 ua, +1.59942313009916781e+06 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/60_mean   4729690632   4637184779            3 +1.00027675249666870e+00 ua, +1.59942313009916781e+06 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/60_stddev  382049676    372825255            3 +1.00027675249666870e+00 ua, +1.59942313009916781e+06 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/90        3355764768   3286732852            1 +1.00027580639952407e+00 ua, +1.34261281528133753e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/90        3144899083   3079193337            1 +1.00027580639952407e+00 ua, +1.34261281528133753e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/90        3478962297   3426035609            1 +1.00027580639952407e+00 ua, +1.34261281528133753e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/90_mean   3326542049   3263987266            3 +1.00027580639952407e+00 ua, +1.34261281528133753e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10/90_stddev  168937957    174536276            3 +1.00027580639952407e+00 ua, +1.34261281528133753e+05 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/45        6405684082   6297377443            1 +1.00027592626461037e+00 ua, +5.54270648876322127e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/45        5172997283   5090989233            1 +1.00027592626461037e+00 ua, +5.54270648876322127e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/45        5748004640   5626720604            1 +1.00027592626461037e+00 ua, +5.54270648876322127e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/45_mean   5775562002   5671695760            3 +1.00027592626461037e+00 ua, +5.54270648876322127e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/45_stddev  616805271    604450330            3 +1.00027592626461037e+00 ua, +5.54270648876322127e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/60        4598033651   4502190757            1 +1.00027592626773232e+00 ua, +9.97157721365595648e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/60        4488357569   4407503337            1 +1.00027592626773232e+00 ua, +9.97157721365595648e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/60        5553766221   5423103460            1 +1.00027592626773232e+00 ua, +9.97157721365595648e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/60_mean   4880052480   4777599185            3 +1.00027592626773232e+00 ua, +9.97157721365595648e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/60_stddev  586024627    561024290            3 +1.00027592626773232e+00 ua, +9.97157721365595648e+01 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/90        4003503572   3916815262            1 +1.00027577950297952e+00 ua, +4.21487935476953498e+04 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/90        3393752709   3331448829            1 +1.00027577950297952e+00 ua, +4.21487935476953498e+04 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/90        3202260500   3150431099            1 +1.00027577950297952e+00 ua, +4.21487935476953498e+04 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/90_mean   3533172260   3466231730            3 +1.00027577950297952e+00 ua, +4.21487935476953498e+04 m                                // NOLINT(whitespace/line_length)
+// BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12/90_stddev  418420809    400575828            3 +1.00027577950297952e+00 ua, +4.21487935476953498e+04 m                                // NOLINT(whitespace/line_length)
+
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "base/not_null.hpp"
@@ -58,6 +161,8 @@
 #include "geometry/quaternion.hpp"
 #include "geometry/rotation.hpp"
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/gragg_bulirsch_stoer_integrator.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
@@ -77,16 +182,30 @@ namespace principia {
 using astronomy::JulianYear;
 using base::not_null;
 using bipm::NauticalMile;
+using geometry::Displacement;
 using geometry::Position;
 using geometry::Quaternion;
 using geometry::Rotation;
+using integrators::AdaptiveStepSizeIntegrator;
+using integrators::AdaptiveStepSizeStatistics;
 using integrators::DormandElMikkawyPrince1986RKN434FM;
+using integrators::DormandElMikkawyPrince1986RKN646FM;
+using integrators::FixedStepSizeIntegrator;
+using integrators::HairerNørsettWanner1993ODEX2;
 using integrators::McLachlanAtela1992Order5Optimal;
+using integrators::QuinlanTremaine1990Order10;
+using integrators::QuinlanTremaine1990Order12;
+using integrators::QuinlanTremaine1990Order8;
+using integrators::StepSizeController;
+using integrators::kElementary;
+using integrators::kProportionalIntegral;
 using physics::Ephemeris;
 using physics::MasslessBody;
 using quantities::DebugString;
 using quantities::Sqrt;
+using quantities::Time;
 using si::AstronomicalUnit;
+using si::Hour;
 using si::Metre;
 using si::Milli;
 using si::Minute;
@@ -97,9 +216,59 @@ namespace benchmarks {
 
 namespace {
 
-void EphemerisSolarSystemBenchmark(SolarSystem::Accuracy const accuracy,
-                                   not_null<benchmark::State*> const state) {
-  Length error;
+using PlanetaryIntegrator = FixedStepSizeIntegrator<
+    Ephemeris<ICRFJ2000Ecliptic>::NewtonianMotionEquation>;
+using ProbeIntegrator = AdaptiveStepSizeIntegrator<
+    Ephemeris<ICRFJ2000Ecliptic>::NewtonianMotionEquation>;
+
+// The position of the Earth with respect to the Sun at |final_time| in the
+// given |ephemeris|, which must have been prolonged that far.
+Displacement<ICRFJ2000Ecliptic> SunEarthDisplacement(
+    Ephemeris<ICRFJ2000Ecliptic> const& ephemeris,
+    Instant const& final_time) {
+  return ephemeris.trajectory(ephemeris.bodies()[SolarSystem::kEarth]).
+             EvaluatePosition(final_time, nullptr) -
+         ephemeris.trajectory(ephemeris.bodies()[SolarSystem::kSun]).
+             EvaluatePosition(final_time, nullptr);
+}
+
+// The displacement above for the major bodies, integrated by an order 12
+// multistep method with a 20 min step, which serves as the reference for the
+// accuracy of the benchmarks.  Its truncation error is negligible, but
+// round-off alone makes integrations differ by about 100 m after 100 years, so
+// smaller errors are not significant.  Computed once, the first time it is
+// needed; a shorter step would not fit in memory.
+Displacement<ICRFJ2000Ecliptic> const& ReferenceSunEarthDisplacement() {
+  static Displacement<ICRFJ2000Ecliptic> const reference = []() {
+    not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+        SolarSystem::AtСпутник1Launch(SolarSystem::Accuracy::kMajorBodiesOnly);
+    Instant const final_time = at_спутник_1_launch->time() + 100 * JulianYear;
+    Ephemeris<ICRFJ2000Ecliptic> ephemeris(
+        at_спутник_1_launch->massive_bodies(),
+        at_спутник_1_launch->initial_state(),
+        at_спутник_1_launch->time(),
+        QuinlanTremaine1990Order12<Position<ICRFJ2000Ecliptic>>(),
+        20 * Minute,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre));
+    ephemeris.Prolong(final_time);
+    return SunEarthDisplacement(ephemeris, final_time);
+  }();
+  return reference;
+}
+
+// If |maximum_step_multiple| is positive, the ephemeris uses multirate
+// integration with that maximum step multiple.  For the major bodies only, the
+// label also gives the error on the position of the Earth with respect to the
+// reference above, so that the integrators may be compared at equal accuracy.
+void EphemerisSolarSystemBenchmark(
+    SolarSystem::Accuracy const accuracy,
+    int const number_of_threads,
+    int const maximum_step_multiple,
+    PlanetaryIntegrator const& planetary_integrator,
+    Time const& step,
+    not_null<benchmark::State*> const state) {
+  Displacement<ICRFJ2000Ecliptic> sun_earth;
   while (state->KeepRunning()) {
     state->PauseTiming();
     not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
@@ -117,25 +286,33 @@ void EphemerisSolarSystemBenchmark(SolarSystem::Accuracy const accuracy,
             std::move(bodies),
             initial_state,
             at_спутник_1_launch->time(),
-            McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>(),
-            45 * Minute,
+            planetary_integrator,
+            step,
             0.1 * Milli(Metre),
-            5 * Milli(Metre));
+            5 * Milli(Metre),
+            number_of_threads);
+    if (maximum_step_multiple > 0) {
+      ephemeris.UseMultirateIntegration(maximum_step_multiple);
+    }
 
     state->ResumeTiming();
     ephemeris.Prolong(final_time);
     state->PauseTiming();
-    error = (ephemeris.trajectory(ephemeris.bodies()[SolarSystem::kSun]).
-                 EvaluatePosition(final_time, nullptr) -
-             ephemeris.trajectory(ephemeris.bodies()[SolarSystem::kEarth]).
-                 EvaluatePosition(final_time, nullptr)).
-                 Norm();
+    sun_earth = SunEarthDisplacement(ephemeris, final_time);
     state->ResumeTiming();
   }
-  state->SetLabel(DebugString(error / AstronomicalUnit) + " ua");
+  std::string label = DebugString(sun_earth.Norm() / AstronomicalUnit) + " ua";
+  if (accuracy == SolarSystem::Accuracy::kMajorBodiesOnly) {
+    label += ", " +
+             DebugString((sun_earth - ReferenceSunEarthDisplacement()).Norm() /
+                         Metre) +
+             " m";
+  }
+  state->SetLabel(label);
 }
 
 void EphemerisL4ProbeBenchmark(SolarSystem::Accuracy const accuracy,
+                               ProbeIntegrator const& probe_integrator,
                                not_null<benchmark::State*> const state) {
   Length sun_error;
   Length earth_error;
@@ -194,8 +371,7 @@ void EphemerisL4ProbeBenchmark(SolarSystem::Accuracy const accuracy,
     ephemeris.FlowWithAdaptiveStep(&trajectory,
                                    1 * Metre,
                                    1 * Metre / Second,
-                                   DormandElMikkawyPrince1986RKN434FM<
-                                       Position<ICRFJ2000Ecliptic>>(),
+                                   probe_integrator,
                                    final_time);
     state->PauseTiming();
 
@@ -218,11 +394,19 @@ void EphemerisL4ProbeBenchmark(SolarSystem::Accuracy const accuracy,
                   DebugString(earth_error / AstronomicalUnit) + " ua");
 }
 
-void EphemerisLEOProbeBenchmark(SolarSystem::Accuracy const accuracy,
-                                not_null<benchmark::State*> const state) {
+// If |pruning| is not null, the massive bodies that don't affect the probe are
+// skipped according to that policy.
+void EphemerisLEOProbeBenchmark(
+    SolarSystem::Accuracy const accuracy,
+    Ephemeris<ICRFJ2000Ecliptic>::PerturberPruning const* const pruning,
+    Ephemeris<ICRFJ2000Ecliptic>::EnckeIntegration const* const encke,
+    StepSizeController const controller,
+    ProbeIntegrator const& probe_integrator,
+    not_null<benchmark::State*> const state) {
   Length sun_error;
   Length earth_error;
   int steps;
+  AdaptiveStepSizeStatistics statistics;
 
   not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
       SolarSystem::AtСпутник1Launch(accuracy);
@@ -268,13 +452,27 @@ void EphemerisLEOProbeBenchmark(SolarSystem::Accuracy const accuracy,
                           earth_degrees_of_freedom.velocity() +
                               earth_probe_velocity));
 
+    statistics = AdaptiveStepSizeStatistics();
     state->ResumeTiming();
-    ephemeris.FlowWithAdaptiveStep(&trajectory,
-                                   1 * Metre,
-                                   1 * Metre / Second,
-                                   DormandElMikkawyPrince1986RKN434FM<
-                                       Position<ICRFJ2000Ecliptic>>(),
-                                   final_time);
+    if (encke == nullptr) {
+      ephemeris.FlowWithAdaptiveStep(&trajectory,
+                                     1 * Metre,
+                                     1 * Metre / Second,
+                                     probe_integrator,
+                                     final_time,
+                                     pruning,
+                                     nullptr /*regularization*/,
+                                     controller,
+                                     &statistics);
+    } else {
+      ephemeris.FlowWithAdaptiveStepRelativeToPrimary(
+          &trajectory,
+          1 * Metre,
+          1 * Metre / Second,
+          probe_integrator,
+          final_time,
+          *encke);
+    }
     state->PauseTiming();
 
     sun_error = (ephemeris.trajectory(ephemeris.bodies()[SolarSystem::kSun]).
@@ -291,77 +489,345 @@ void EphemerisLEOProbeBenchmark(SolarSystem::Accuracy const accuracy,
   }
   std::stringstream ss;
   ss << steps;
-  state->SetLabel(ss.str() + " steps, " +
-                  DebugString(sun_error / AstronomicalUnit) + " ua, " +
-                  DebugString((earth_error - 6371 * Kilo(Metre)) /
-                                  NauticalMile) + " nmi");
+  std::string label = ss.str() + " steps, " +
+                      DebugString(sun_error / AstronomicalUnit) + " ua, " +
+                      DebugString((earth_error - 6371 * Kilo(Metre)) /
+                                      NauticalMile) + " nmi";
+  // The integration relative to the primary doesn't report its statistics.
+  if (encke == nullptr) {
+    std::stringstream rejections;
+    rejections << statistics.rejected_steps << " rejected, "
+               << statistics.rejected_evaluations << "/"
+               << statistics.evaluations << " evaluations wasted";
+    label += ", " + rejections.str();
+  }
+  state->SetLabel(label);
 }
 
 }  // namespace
 
+// The argument is the integration step in minutes.
 void BM_EphemerisSolarSystemMajorBodiesOnly(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisSolarSystemBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                                1 /*number_of_threads*/,
+                                0 /*maximum_step_multiple*/,
+                                McLachlanAtela1992Order5Optimal<
+                                    Position<ICRFJ2000Ecliptic>>(),
+                                state.range_x() * Minute,
                                 &state);
 }
 
 void BM_EphemerisSolarSystemMinorAndMajorBodies(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisSolarSystemBenchmark(SolarSystem::Accuracy::kMinorAndMajorBodies,
+                                1 /*number_of_threads*/,
+                                0 /*maximum_step_multiple*/,
+                                McLachlanAtela1992Order5Optimal<
+                                    Position<ICRFJ2000Ecliptic>>(),
+                                45 * Minute,
                                 &state);
 }
 
 void BM_EphemerisSolarSystemAllBodiesAndOblateness(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisSolarSystemBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                                1 /*number_of_threads*/,
+                                0 /*maximum_step_multiple*/,
+                                McLachlanAtela1992Order5Optimal<
+                                    Position<ICRFJ2000Ecliptic>>(),
+                                45 * Minute,
+                                &state);
+}
+
+// The argument is the number of threads used to compute the accelerations
+// between the massive bodies.
+void BM_EphemerisSolarSystemAllBodiesAndOblatenessParallel(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                                state.range_x(),
+                                0 /*maximum_step_multiple*/,
+                                McLachlanAtela1992Order5Optimal<
+                                    Position<ICRFJ2000Ecliptic>>(),
+                                45 * Minute,
+                                &state);
+}
+
+// The argument is the maximum multiple of the step used for the slow bodies.
+void BM_EphemerisSolarSystemAllBodiesAndOblatenessMultirate(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                                1 /*number_of_threads*/,
+                                state.range_x(),
+                                McLachlanAtela1992Order5Optimal<
+                                    Position<ICRFJ2000Ecliptic>>(),
+                                45 * Minute,
                                 &state);
 }
 
+// The argument is the integration step in minutes.
+void BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(
+      SolarSystem::Accuracy::kMajorBodiesOnly,
+      1 /*number_of_threads*/,
+      0 /*maximum_step_multiple*/,
+      QuinlanTremaine1990Order8<Position<ICRFJ2000Ecliptic>>(),
+      state.range_x() * Minute,
+      &state);
+}
+
+// Same as above.
+void BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(
+      SolarSystem::Accuracy::kMajorBodiesOnly,
+      1 /*number_of_threads*/,
+      0 /*maximum_step_multiple*/,
+      QuinlanTremaine1990Order10<Position<ICRFJ2000Ecliptic>>(),
+      state.range_x() * Minute,
+      &state);
+}
+
+// Same as above.
+void BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(
+      SolarSystem::Accuracy::kMajorBodiesOnly,
+      1 /*number_of_threads*/,
+      0 /*maximum_step_multiple*/,
+      QuinlanTremaine1990Order12<Position<ICRFJ2000Ecliptic>>(),
+      state.range_x() * Minute,
+      &state);
+}
+
+void BM_EphemerisSolarSystemAllBodiesAndOblatenessQuinlanTremaine1990Order12(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisSolarSystemBenchmark(
+      SolarSystem::Accuracy::kAllBodiesAndOblateness,
+      1 /*number_of_threads*/,
+      0 /*maximum_step_multiple*/,
+      QuinlanTremaine1990Order12<Position<ICRFJ2000Ecliptic>>(),
+      45 * Minute,
+      &state);
+}
+
 void BM_EphemerisL4ProbeMajorBodiesOnly(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                            DormandElMikkawyPrince1986RKN434FM<
+                                Position<ICRFJ2000Ecliptic>>(),
                             &state);
 }
 
 void BM_EphemerisL4ProbeMinorAndMajorBodies(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kMinorAndMajorBodies,
+                            DormandElMikkawyPrince1986RKN434FM<
+                                Position<ICRFJ2000Ecliptic>>(),
                             &state);
 }
 
 void BM_EphemerisL4ProbeAllBodiesAndOblateness(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                            DormandElMikkawyPrince1986RKN434FM<
+                                Position<ICRFJ2000Ecliptic>>(),
                             &state);
 }
 
 void BM_EphemerisLEOProbeMajorBodiesOnly(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
                              &state);
 }
 
 void BM_EphemerisLEOProbeMinorAndMajorBodies(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMinorAndMajorBodies,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+// The bodies whose contribution over an hour is less than 1 cm, a hundredth of
+// the integration tolerance, are skipped.
+void BM_EphemerisLEOProbeMinorAndMajorBodiesPruned(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  Ephemeris<ICRFJ2000Ecliptic>::PerturberPruning const pruning =
+      {1 * Hour /*reevaluation_interval*/, 0.01 /*tolerance_fraction*/};
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMinorAndMajorBodies,
+                             &pruning,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
                              &state);
 }
 
 void BM_EphemerisLEOProbeAllBodiesAndOblateness(
     benchmark::State& state) {  // NOLINT(runtime/references)
   EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+// The probe is integrated relative to a Keplerian orbit around the body that
+// dominates its motion, i.e., the Earth, which is rectified when the deviation
+// exceeds a thousandth of the distance.
+void BM_EphemerisLEOProbeMinorAndMajorBodiesEncke(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  Ephemeris<ICRFJ2000Ecliptic>::EnckeIntegration const encke =
+      {nullptr /*primary*/, 1E-3 /*rectification_threshold*/};
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMinorAndMajorBodies,
+                             nullptr /*pruning*/,
+                             &encke,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+void BM_EphemerisLEOProbeAllBodiesAndOblatenessEncke(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  Ephemeris<ICRFJ2000Ecliptic>::EnckeIntegration const encke =
+      {nullptr /*primary*/, 1E-3 /*rectification_threshold*/};
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                             nullptr /*pruning*/,
+                             &encke,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+void BM_EphemerisL4ProbeMajorBodiesOnlyRKN646FM(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                            DormandElMikkawyPrince1986RKN646FM<
+                                Position<ICRFJ2000Ecliptic>>(),
+                            &state);
+}
+
+void BM_EphemerisL4ProbeAllBodiesAndOblatenessRKN646FM(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                            DormandElMikkawyPrince1986RKN646FM<
+                                Position<ICRFJ2000Ecliptic>>(),
+                            &state);
+}
+
+void BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN646FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+void BM_EphemerisLEOProbeAllBodiesAndOblatenessRKN646FM(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kAllBodiesAndOblateness,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             DormandElMikkawyPrince1986RKN646FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+void BM_EphemerisL4ProbeMajorBodiesOnlyODEX2(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisL4ProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                            HairerNørsettWanner1993ODEX2<
+                                Position<ICRFJ2000Ecliptic>>(),
+                            &state);
+}
+
+void BM_EphemerisLEOProbeMajorBodiesOnlyODEX2(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kElementary,
+                             HairerNørsettWanner1993ODEX2<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+// Same as |BM_EphemerisLEOProbeMajorBodiesOnly| and
+// |BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM|, but with the
+// proportional-integral step size controller.
+void BM_EphemerisLEOProbeMajorBodiesOnlyPI(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kProportionalIntegral,
+                             DormandElMikkawyPrince1986RKN434FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
+                             &state);
+}
+
+void BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  EphemerisLEOProbeBenchmark(SolarSystem::Accuracy::kMajorBodiesOnly,
+                             nullptr /*pruning*/,
+                             nullptr /*encke*/,
+                             kProportionalIntegral,
+                             DormandElMikkawyPrince1986RKN646FM<
+                                 Position<ICRFJ2000Ecliptic>>(),
                              &state);
 }
 
-BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnly);
+BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnly)->
+    Arg(45)->Arg(180)->Arg(360)->Arg(720);
 BENCHMARK(BM_EphemerisSolarSystemMinorAndMajorBodies);
 BENCHMARK(BM_EphemerisSolarSystemAllBodiesAndOblateness);
+BENCHMARK(BM_EphemerisSolarSystemAllBodiesAndOblatenessParallel)->
+    Arg(1)->Arg(2)->Arg(4)->Arg(8);
+BENCHMARK(BM_EphemerisSolarSystemAllBodiesAndOblatenessMultirate)->
+    Arg(8)->Arg(16);
+BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order8)->
+    Arg(45)->Arg(90)->Arg(180)->Arg(240);
+BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order10)->
+    Arg(45)->Arg(60)->Arg(90);
+BENCHMARK(BM_EphemerisSolarSystemMajorBodiesOnlyQuinlanTremaine1990Order12)->
+    Arg(45)->Arg(60)->Arg(90);
+BENCHMARK(
+    BM_EphemerisSolarSystemAllBodiesAndOblatenessQuinlanTremaine1990Order12);
 BENCHMARK(BM_EphemerisL4ProbeMajorBodiesOnly);
 BENCHMARK(BM_EphemerisL4ProbeMinorAndMajorBodies);
 BENCHMARK(BM_EphemerisL4ProbeAllBodiesAndOblateness);
+BENCHMARK(BM_EphemerisL4ProbeMajorBodiesOnlyRKN646FM);
+BENCHMARK(BM_EphemerisL4ProbeAllBodiesAndOblatenessRKN646FM);
+BENCHMARK(BM_EphemerisL4ProbeMajorBodiesOnlyODEX2);
 BENCHMARK(BM_EphemerisLEOProbeMajorBodiesOnly);
 BENCHMARK(BM_EphemerisLEOProbeMinorAndMajorBodies);
+BENCHMARK(BM_EphemerisLEOProbeMinorAndMajorBodiesPruned);
 BENCHMARK(BM_EphemerisLEOProbeAllBodiesAndOblateness);
+BENCHMARK(BM_EphemerisLEOProbeMinorAndMajorBodiesEncke);
+BENCHMARK(BM_EphemerisLEOProbeAllBodiesAndOblatenessEncke);
+BENCHMARK(BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FM);
+BENCHMARK(BM_EphemerisLEOProbeAllBodiesAndOblatenessRKN646FM);
+BENCHMARK(BM_EphemerisLEOProbeMajorBodiesOnlyODEX2);
+BENCHMARK(BM_EphemerisLEOProbeMajorBodiesOnlyPI);
+BENCHMARK(BM_EphemerisLEOProbeMajorBodiesOnlyRKN646FMPI);
 
 }  // namespace benchmarks
 }  // namespace principia
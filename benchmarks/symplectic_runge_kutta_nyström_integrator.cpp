@@ -0,0 +1,198 @@
+// ./bm_srkn --benchmark_repetitions=3 --benchmark_filter=HarmonicOscillator
+// g++ 12.2.0 -O3 -march=native -DNDEBUG, Debian 12 Linux x86-64
+// Run on (1 X 2000 MHz CPU), 2026/10/16-23:41:26
+// Benchmark                                                                                                                                     Time             CPU   Iterations                                                               // NOLINT(whitespace/line_length)
+// -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------                                                               // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0         880254436 ns    867314872 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0         810694815 ns    775737617 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0         847327613 ns    835020327 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0_mean    846092288 ns    826024272 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0_median  847327613 ns    835020327 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0_stddev   34796260 ns     46446692 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/0_cv           4.11 %          5.62 %             3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1         857855290 ns    830854343 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1         880727278 ns    870189832 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1         828816631 ns    818591079 ns            1 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1_mean    855799733 ns    839878418 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1_median  857855290 ns    830854343 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1_stddev   26016299 ns     26957064 ns            3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<McLachlanAtela1992Order4OptimalIntegrator,&integrators::McLachlanAtela1992Order4Optimal<Length>>/1_cv           3.04 %          3.21 %             3 +2.10942374678779743e-15 m, +1.44328993201270350e-15 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0                              1122383340 ns   1110246012 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0                              1129443978 ns   1116027094 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0                              1101580476 ns   1085380385 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0_mean                         1117802598 ns   1103884497 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0_median                       1122383340 ns   1110246012 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0_stddev                         14485547 ns     16283637 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/0_cv                                 1.30 %          1.48 %             3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1                               787941271 ns    780860858 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1                               777560398 ns    768331935 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1                               859485542 ns    844055985 ns            1 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1_mean                          808329070 ns    797749593 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1_median                        787941271 ns    780860858 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1_stddev                         44605819 ns     40588853 ns            3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN6BIntegrator,&integrators::BlanesMoan2002SRKN6B<Length>>/1_cv                                 5.52 %          5.09 %             3 +3.28626015289046336e-14 m, +2.23154827949656465e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0                            2234983262 ns   2201934912 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0                            1961627145 ns   1938184762 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0                            1740689774 ns   1727996332 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0_mean                       1979100060 ns   1956038669 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0_median                     1961627145 ns   1938184762 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0_stddev                      247609552 ns    237473190 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/0_cv                              12.51 %         12.14 %             3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1                            1661364977 ns   1632604295 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1                            1623219768 ns   1597383155 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1                            1662482525 ns   1648082923 ns            1 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1_mean                       1649022423 ns   1626023458 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1_median                     1661364977 ns   1632604295 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1_stddev                       22352740 ns     25982632 ns            3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+// BM_SolveHarmonicOscillator<BlanesMoan2002SRKN14AIntegrator,&integrators::BlanesMoan2002SRKN14A<Length>>/1_cv                               1.36 %          1.60 %             3 +6.96109836439973151e-14 m, +4.72955008490316686e-14 m s^-1   // NOLINT(whitespace/line_length)
+
+// The argument is 0 when the right-hand side is called through
+// |problem.equation.compute_acceleration|, and 1 when it is passed as a
+// functor, in which case it is statically dispatched.
+
+#define GLOG_NO_ABBREVIATED_SEVERITIES
+
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/si.hpp"
+
+// Must come last to avoid conflicts when defining the CHECK macros.
+#include "benchmark/benchmark.h"
+
+namespace principia {
+
+using geometry::Instant;
+using integrators::IntegrationProblem;
+using integrators::SpecialSecondOrderDifferentialEquation;
+using quantities::Abs;
+using quantities::Acceleration;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Mass;
+using quantities::SIUnit;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Stiffness;
+using quantities::Time;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+
+namespace benchmarks {
+
+namespace {
+
+using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+
+using McLachlanAtela1992Order4OptimalIntegrator = std::remove_reference_t<
+    decltype(integrators::McLachlanAtela1992Order4Optimal<Length>())>;
+using BlanesMoan2002SRKN6BIntegrator = std::remove_reference_t<
+    decltype(integrators::BlanesMoan2002SRKN6B<Length>())>;
+using BlanesMoan2002SRKN14AIntegrator = std::remove_reference_t<
+    decltype(integrators::BlanesMoan2002SRKN14A<Length>())>;
+
+// Defined here rather than in |testing_utilities| so that it may be inlined in
+// the integrator when it is statically dispatched.
+void ComputeHarmonicOscillatorAcceleration(
+    Instant const& t,
+    std::vector<Length> const& q,
+    not_null<std::vector<Acceleration>*> const result) {
+  (*result)[0] = -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+}
+
+template<typename Integrator>
+void SolveHarmonicOscillatorAndComputeError(
+    not_null<benchmark::State*> const state,
+    not_null<Length*> const q_error,
+    not_null<Speed*> const v_error,
+    Integrator const& integrator,
+    bool const static_dispatch) {
+  Instant const t_initial;
+#ifdef _DEBUG
+  Instant const t_final = t_initial + 100 * SIUnit<Time>();
+#else
+  Instant const t_final = t_initial + 1000 * SIUnit<Time>();
+#endif
+  Time const step = 1.0E-4 * SIUnit<Time>();
+
+  ODE::SystemState const initial_state = {{SIUnit<Length>()},
+                                          {Speed()},
+                                          t_initial};
+  ODE::SystemState final_state = initial_state;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration, _1, _2, _3);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  problem.initial_state = &initial_state;
+  problem.t_final = t_final;
+  // Only keep the last state, so that the benchmark measures the integrator
+  // rather than the allocation of the solution.
+  problem.append_state = [&final_state](ODE::SystemState const& state) {
+    final_state = state;
+  };
+
+  if (static_dispatch) {
+    integrator.Solve(problem,
+                     step,
+                     [](Instant const& t,
+                        std::vector<Length> const& q,
+                        not_null<std::vector<Acceleration>*> const result) {
+                       ComputeHarmonicOscillatorAcceleration(t, q, result);
+                     });
+  } else {
+    integrator.Solve(problem, step);
+  }
+
+  state->PauseTiming();
+  Time const t = final_state.time.value - t_initial;
+  *q_error = Abs(final_state.positions[0].value -
+                 SIUnit<Length>() * Cos(t * SIUnit<AngularFrequency>()));
+  *v_error = Abs(final_state.velocities[0].value +
+                 SIUnit<Speed>() * Sin(t * SIUnit<AngularFrequency>()));
+  state->ResumeTiming();
+}
+
+template<typename Integrator, Integrator const& (*integrator)()>
+void BM_SolveHarmonicOscillator(
+    benchmark::State& state) {  // NOLINT(runtime/references)
+  bool const static_dispatch = state.range_x() != 0;
+  Length q_error;
+  Speed v_error;
+  while (state.KeepRunning()) {
+    SolveHarmonicOscillatorAndComputeError(&state, &q_error, &v_error,
+                                           integrator(), static_dispatch);
+  }
+  std::stringstream ss;
+  ss << q_error << ", " << v_error;
+  state.SetLabel(ss.str());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE2(BM_SolveHarmonicOscillator,
+                    McLachlanAtela1992Order4OptimalIntegrator,
+                    &integrators::McLachlanAtela1992Order4Optimal<Length>)
+    ->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE2(BM_SolveHarmonicOscillator,
+                    BlanesMoan2002SRKN6BIntegrator,
+                    &integrators::BlanesMoan2002SRKN6B<Length>)
+    ->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE2(BM_SolveHarmonicOscillator,
+                    BlanesMoan2002SRKN14AIntegrator,
+                    &integrators::BlanesMoan2002SRKN14A<Length>)
+    ->Arg(0)->Arg(1);
+
+}  // namespace benchmarks
+}  // namespace principia
@@ -4,8 +4,9 @@
 #include <vector>
 
 #include "base/not_null.hpp"
-#include "numerics/fixed_arrays.hpp"
+#include "integrators/event_detector.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "numerics/fixed_arrays.hpp"
 #include "quantities/named_quantities.hpp"
 
 namespace principia {
@@ -38,6 +39,14 @@ namespace integrators {
 // The order of the template parameters follow the notation of Dormand and
 // Prince, whose RKNq(p)sF has higher order q, lower order p, comprises
 // s stages, and has the first-same-as-last property.
+// If |problem.append_dense_state| is set, it receives the quintic Hermite
+// interpolation of each step, built from the accelerations at both ends.  In
+// the FSAL case these are the first and last stages; otherwise the
+// accelerations at the end of the step are reused as the first stage of the
+// next one, so only the last step costs an additional evaluation.
+// The occurrences of |problem.events| are located on the same interpolation.
+// When a terminal event ends the integration, the interpolation of the last
+// step extends beyond the occurrence.
 
 template<typename Position, int higher_order, int lower_order, int stages,
          bool first_same_as_last>
@@ -68,6 +77,15 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
   void Solve(IntegrationProblem<ODE> const& problem,
              AdaptiveStepSize<ODE> const& adaptive_step_size) const override;
 
+  // Same as above, but calls |compute_acceleration| instead of
+  // |problem.equation.compute_acceleration|, so that the right-hand side is
+  // statically dispatched and may be inlined.  |compute_acceleration| must
+  // have the signature of |ODE::RightHandSideComputation|.
+  template<typename ComputeAcceleration>
+  void Solve(IntegrationProblem<ODE> const& problem,
+             AdaptiveStepSize<ODE> const& adaptive_step_size,
+             ComputeAcceleration const& compute_acceleration) const;
+
  protected:
   FixedVector<double, stages> const c_;
   FixedStrictlyLowerTriangularMatrix<double, stages> const a_;
@@ -88,6 +106,17 @@ EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
                                             true /*first_same_as_last*/> const&
 DormandElMikkawyPrince1986RKN434FM();
 
+// Coefficients from Dormand, El-Mikkawy and Prince (1986),
+// Families of Runge-Kutta-Nyström formulae, the RKN6(4)6FM.
+// Since the method is first-same-as-last, a step costs 5 evaluations.
+template<typename Position>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
+                                            6 /*higher_order*/,
+                                            4 /*lower_order*/,
+                                            6 /*stages*/,
+                                            true /*first_same_as_last*/> const&
+DormandElMikkawyPrince1986RKN646FM();
+
 }  // namespace integrators
 }  // namespace principia
 
@@ -42,6 +42,38 @@ DormandElMikkawyPrince1986RKN434FM() {
   return integrator;
 }
 
+template<typename Position>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Position, 6, 4, 6, true> const&
+DormandElMikkawyPrince1986RKN646FM() {
+  static EmbeddedExplicitRungeKuttaNyströmIntegrator<
+             Position, 6, 4, 6, true> const integrator(
+      // c
+      {      0.0          ,      1.0 /      10.0,      3.0 /     10.0,
+             7.0 /    10.0,     17.0 /      25.0,      1.0},
+      // a
+      {
+             1.0 /   200.0,
+            -1.0 /  2200.0,      1.0 /      22.0,
+           637.0 /  6600.0,     -7.0 /     110.0,      7.0 /     33.0,
+        225437.0 / 1968750.0, -30073.0 / 281250.0, 65569.0 / 281250.0,
+         -9367.0 / 984375.0,
+           151.0 /  2142.0,      5.0 /     116.0,    385.0 /   1368.0,
+            55.0 /   168.0,  -6250.0 /   28101.0},
+      // b̂
+      {    151.0 /  2142.0,      5.0 /     116.0,    385.0 /   1368.0,
+            55.0 /   168.0,  -6250.0 /   28101.0,      0.0},
+      // b̂′
+      {    151.0 /  2142.0,     25.0 /     522.0,    275.0 /    684.0,
+           275.0 /   252.0, -78125.0 /  112404.0,      1.0 /     12.0},
+      // b
+      {   1349.0 / 157500.0,  7873.0 /   50000.0, 192199.0 / 900000.0,
+        521683.0 / 2100000.0, -16.0 /     125.0,      0.0},
+      // b′
+      {   1349.0 / 157500.0,  7873.0 /   45000.0,  27457.0 /  90000.0,
+        521683.0 / 630000.0,    -2.0 /       5.0,      1.0 /     12.0});
+  return integrator;
+}
+
 template<typename Position, int higher_order, int lower_order, int stages,
          bool first_same_as_last>
 EmbeddedExplicitRungeKuttaNyströmIntegrator<Position, higher_order, lower_order,
@@ -82,6 +114,20 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
                                                  first_same_as_last>::Solve(
     IntegrationProblem<ODE> const& problem,
     AdaptiveStepSize<ODE> const& adaptive_step_size) const {
+  Solve(problem, adaptive_step_size, problem.equation.compute_acceleration);
+}
+
+template<typename Position, int higher_order, int lower_order, int stages,
+         bool first_same_as_last>
+template<typename ComputeAcceleration>
+void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
+                                                 higher_order,
+                                                 lower_order,
+                                                 stages,
+                                                 first_same_as_last>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    AdaptiveStepSize<ODE> const& adaptive_step_size,
+    ComputeAcceleration const& compute_acceleration) const {
   using Displacement = typename ODE::Displacement;
   using Velocity = typename ODE::Velocity;
   using Acceleration = typename ODE::Acceleration;
@@ -102,6 +148,9 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
   }
   CHECK_GT(adaptive_step_size.safety_factor, 0);
   CHECK_LT(adaptive_step_size.safety_factor, 1);
+  CHECK_GT(adaptive_step_size.minimal_step_ratio, 0);
+  CHECK_LT(adaptive_step_size.minimal_step_ratio, 1);
+  CHECK_GT(adaptive_step_size.maximal_step_ratio, 1);
 
   typename ODE::SystemState current_state = *problem.initial_state;
 
@@ -136,8 +185,32 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
     g_stage.resize(dimension);
   }
 
+  // Whether to compute the dense output, which is needed to call
+  // |problem.append_dense_state| and to locate the events, and the state at
+  // the beginning of the step that it needs.
+  bool const dense_output = static_cast<bool>(problem.append_dense_state) ||
+                            !problem.events.empty();
+  std::vector<Position> q_initial;
+  std::vector<Velocity> v_initial;
+  std::vector<Velocity> v_final;
+  if (dense_output) {
+    q_initial.resize(dimension);
+    v_initial.resize(dimension);
+    v_final.resize(dimension);
+  }
+
+  EventDetector<Position> event_detector(problem.events, current_state);
+
   bool at_end = false;
   double tolerance_to_error_ratio;
+  // The |tolerance_to_error_ratio| of the step before the last accepted one,
+  // for the proportional-integral controller, or 0 if there is no such step.
+  double previous_tolerance_to_error_ratio = 0;
+
+  AdaptiveStepSizeStatistics statistics;
+  // The number of evaluations of the right-hand side in the current attempt at
+  // a step.
+  int step_evaluations;
 
   // The first stage of the Runge-Kutta-Nyström iteration.  In the FSAL case,
   // |first_stage == 1| after the first step, since the first RHS evaluation has
@@ -155,8 +228,28 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
       // Adapt step size.
       // TODO(egg): find out whether there's a smarter way to compute that root,
       // especially if we make the order compile-time.
-      h *= adaptive_step_size.safety_factor *
-               std::pow(tolerance_to_error_ratio, 1.0 / (lower_order + 1));
+      {
+        bool const after_rejection = tolerance_to_error_ratio < 1.0;
+        double step_ratio;
+        if (adaptive_step_size.controller == kProportionalIntegral &&
+            !after_rejection && previous_tolerance_to_error_ratio > 0) {
+          step_ratio =
+              adaptive_step_size.safety_factor *
+              std::pow(tolerance_to_error_ratio, 0.7 / (lower_order + 1)) *
+              std::pow(previous_tolerance_to_error_ratio,
+                       -0.4 / (lower_order + 1));
+        } else {
+          step_ratio =
+              adaptive_step_size.safety_factor *
+              std::pow(tolerance_to_error_ratio, 1.0 / (lower_order + 1));
+        }
+        if (!after_rejection) {
+          previous_tolerance_to_error_ratio = tolerance_to_error_ratio;
+        }
+        h *= std::min(adaptive_step_size.maximal_step_ratio,
+                      std::max(adaptive_step_size.minimal_step_ratio,
+                               step_ratio));
+      }
 
     runge_kutta_nyström_step:
       // Termination condition.
@@ -169,6 +262,7 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
       }
 
       // Runge-Kutta-Nyström iteration; fills |g|.
+      step_evaluations = stages - first_stage;
       for (int i = first_stage; i < stages; ++i) {
         Instant const t_stage = t.value + c_[i] * h;
         for (int k = 0; k < dimension; ++k) {
@@ -179,7 +273,7 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
           q_stage[k] = q_hat[k].value +
                            h * (c_[i] * v_hat[k].value + h * ∑j_a_ij_g_jk);
         }
-        problem.equation.compute_acceleration(t_stage, q_stage, &g[i]);
+        compute_acceleration(t_stage, q_stage, &g[i]);
       }
 
       // Increment computation and step size control.
@@ -207,13 +301,30 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
       }
       tolerance_to_error_ratio =
           adaptive_step_size.tolerance_to_error_ratio(h, error_estimate);
+      statistics.evaluations += step_evaluations;
+      if (tolerance_to_error_ratio < 1.0) {
+        ++statistics.rejected_steps;
+        statistics.rejected_evaluations += step_evaluations;
+      }
     } while (tolerance_to_error_ratio < 1.0);
+    ++statistics.accepted_steps;
 
-    if (first_same_as_last) {
+    // In the FSAL case, the last stage is the first stage of the next step.
+    // With dense output, the first stage of the next step is computed below
+    // in the other case.  Either way, the accelerations at the beginning of
+    // this step end up in |g.back()|.
+    if (first_same_as_last || dense_output) {
       using std::swap;
       swap(g.front(), g.back());
       first_stage = 1;
     }
+    Instant const t_initial = t.value;
+    if (dense_output) {
+      for (int k = 0; k < dimension; ++k) {
+        q_initial[k] = q_hat[k].value;
+        v_initial[k] = v_hat[k].value;
+      }
+    }
 
     // Increment the solution with the high-order approximation.
     t.Increment(h);
@@ -221,7 +332,40 @@ void EmbeddedExplicitRungeKuttaNyströmIntegrator<Position,
       q_hat[k].Increment(∆q_hat[k]);
       v_hat[k].Increment(∆v_hat[k]);
     }
-    problem.append_state(current_state);
+    if (dense_output && !first_same_as_last) {
+      for (int k = 0; k < dimension; ++k) {
+        q_stage[k] = q_hat[k].value;
+      }
+      compute_acceleration(t.value, q_stage, &g.front());
+      ++statistics.evaluations;
+    }
+    if (dense_output) {
+      for (int k = 0; k < dimension; ++k) {
+        v_final[k] = v_hat[k].value;
+      }
+      typename ODE::DenseState const dense_state(t_initial, t.value,
+                                                 q_initial, v_initial, g.back(),
+                                                 ∆q_hat, v_final, g.front());
+      // On a terminal event, the step ends at the event and so does the
+      // integration.
+      if (event_detector.DetectOccurrences(dense_state, &current_state)) {
+        at_end = true;
+      }
+      problem.append_state(current_state);
+      if (problem.append_dense_state) {
+        problem.append_dense_state(dense_state);
+      }
+    } else {
+      problem.append_state(current_state);
+    }
+  }
+
+  if (adaptive_step_size.statistics != nullptr) {
+    adaptive_step_size.statistics->accepted_steps += statistics.accepted_steps;
+    adaptive_step_size.statistics->rejected_steps += statistics.rejected_steps;
+    adaptive_step_size.statistics->evaluations += statistics.evaluations;
+    adaptive_step_size.statistics->rejected_evaluations +=
+        statistics.rejected_evaluations;
   }
 }
 
@@ -2,12 +2,15 @@
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 
 #include <algorithm>
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include "base/macros.hpp"
 #include "glog/logging.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
 #include "quantities/si.hpp"
 #include "testing_utilities/integration.hpp"
 #include "testing_utilities/numerics.hpp"
@@ -15,18 +18,24 @@
 namespace principia {
 
 using quantities::Abs;
+using quantities::AngularFrequency;
+using quantities::Cos;
 using quantities::Length;
+using quantities::Sin;
 using si::Centi;
 using si::Metre;
 using si::Milli;
+using si::Radian;
 using si::Second;
 using testing_utilities::AbsoluteError;
 using ::std::placeholders::_1;
 using ::std::placeholders::_2;
 using ::std::placeholders::_3;
 using ::testing::AllOf;
+using ::testing::Eq;
 using ::testing::Ge;
 using ::testing::Le;
+using ::testing::Lt;
 
 namespace integrators {
 
@@ -60,7 +69,52 @@ double HarmonicOscillatorToleranceRatio(
 }  // namespace
 
 class EmbeddedExplicitRungeKuttaNyströmIntegratorTest
-    : public ::testing::Test {};
+    : public ::testing::Test {
+ protected:
+  // A harmonic oscillator integrated over 10 periods, whose evaluations are
+  // counted in |evaluations_| and whose states are appended to |solution_|.
+  IntegrationProblem<ODE> MakeHarmonicOscillatorProblem() {
+    ODE harmonic_oscillator;
+    harmonic_oscillator.compute_acceleration =
+        std::bind(ComputeHarmonicOscillatorAcceleration,
+                  _1, _2, _3, &evaluations_);
+    IntegrationProblem<ODE> problem;
+    problem.equation = harmonic_oscillator;
+    problem.initial_state = &initial_state_;
+    problem.t_final = t_final_;
+    problem.append_state = [this](ODE::SystemState const& state) {
+      solution_.push_back(state);
+    };
+    return problem;
+  }
+
+  // A step size starting with the whole integration, with the given
+  // tolerances.  |callback| is called with the outcome of each step.
+  AdaptiveStepSize<ODE> MakeAdaptiveStepSize(
+      Length const& length_tolerance,
+      Speed const& speed_tolerance,
+      std::function<void(bool tolerable)> callback = [](bool tolerable) {}) {
+    AdaptiveStepSize<ODE> adaptive_step_size;
+    adaptive_step_size.first_time_step = t_final_ - t_initial_;
+    adaptive_step_size.safety_factor = 0.9;
+    adaptive_step_size.tolerance_to_error_ratio =
+        std::bind(HarmonicOscillatorToleranceRatio,
+                  _1, _2, length_tolerance, speed_tolerance,
+                  std::move(callback));
+    return adaptive_step_size;
+  }
+
+  Length const x_initial_ = 1 * Metre;
+  Speed const v_initial_ = 0 * Metre / Second;
+  Time const period_ = 2 * π * Second;
+  Instant const t_initial_;
+  Instant const t_final_ = t_initial_ + 10 * period_;
+  ODE::SystemState const initial_state_ = {{x_initial_},
+                                           {v_initial_},
+                                           t_initial_};
+  int evaluations_ = 0;
+  std::vector<ODE::SystemState> solution_;
+};
 
 TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
        HarmonicOscillatorBackAndForth) {
@@ -153,5 +207,278 @@ TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
   EXPECT_EQ(11, subsequent_rejections);
 }
 
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
+       HarmonicOscillatorBackAndForthRKN646FM) {
+  AdaptiveStepSizeIntegrator<ODE> const& integrator =
+      DormandElMikkawyPrince1986RKN646FM<Length>();
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+  int const steps_forward = 50;
+  // We integrate backward with double the tolerance.
+  int const steps_backward = 44;
+
+  int initial_rejections = 0;
+  int subsequent_rejections = 0;
+  bool first_step = true;
+  auto const step_size_callback = [&initial_rejections, &subsequent_rejections,
+                                   &first_step](bool tolerable) {
+    if (!tolerable) {
+      if (first_step) {
+        ++initial_rejections;
+      } else {
+        ++subsequent_rejections;
+      }
+    } else if (first_step) {
+      first_step = false;
+    }
+  };
+
+  IntegrationProblem<ODE> problem = MakeHarmonicOscillatorProblem();
+  AdaptiveStepSize<ODE> adaptive_step_size = MakeAdaptiveStepSize(
+      length_tolerance, speed_tolerance, step_size_callback);
+
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              AllOf(Ge(6E-5 * Metre), Le(7E-5 * Metre)));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              AllOf(Ge(5E-4 * Metre / Second), Le(6E-4 * Metre / Second)));
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_EQ(steps_forward, solution_.size());
+  EXPECT_EQ((1 + initial_rejections) * 6 +
+                (steps_forward - 1 + subsequent_rejections) * 5,
+            evaluations_);
+  EXPECT_EQ(1, initial_rejections);
+  EXPECT_EQ(6, subsequent_rejections);
+
+  evaluations_ = 0;
+  subsequent_rejections = 0;
+  initial_rejections = 0;
+  first_step = true;
+  problem.initial_state = &solution_.back();
+  problem.t_final = t_initial_;
+  adaptive_step_size = MakeAdaptiveStepSize(
+      2 * length_tolerance, 2 * speed_tolerance, step_size_callback);
+  adaptive_step_size.first_time_step = t_initial_ - t_final_;
+
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              AllOf(Ge(1E-4 * Metre), Le(2E-4 * Metre)));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              AllOf(Ge(6E-4 * Metre / Second), Le(7E-4 * Metre / Second)));
+  EXPECT_EQ(t_initial_, solution_.back().time.value);
+  EXPECT_EQ(steps_backward, solution_.size() - steps_forward);
+  EXPECT_EQ((1 + initial_rejections) * 6 +
+                (steps_backward - 1 + subsequent_rejections) * 5,
+            evaluations_);
+  EXPECT_EQ(1, initial_rejections);
+  EXPECT_EQ(6, subsequent_rejections);
+}
+
+// The dense output is evaluated at a fixed cadence which is unrelated to the
+// steps.  Its error is comparable to that of the steps, and it doesn't cost any
+// evaluations.
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
+       HarmonicOscillatorDenseOutput) {
+  AdaptiveStepSizeIntegrator<ODE> const& integrator =
+      DormandElMikkawyPrince1986RKN646FM<Length>();
+  AngularFrequency const ω = 1 * Radian / Second;
+  Time const output_interval = 0.1 * Second;
+
+  IntegrationProblem<ODE> problem = MakeHarmonicOscillatorProblem();
+  AdaptiveStepSize<ODE> const adaptive_step_size =
+      MakeAdaptiveStepSize(1E-6 * Metre, 1E-6 * Metre / Second);
+
+  integrator.Solve(problem, adaptive_step_size);
+  int const evaluations_without_dense_output = evaluations_;
+  std::vector<ODE::SystemState> const solution_without_dense_output =
+      solution_;
+
+  Instant t_last = t_initial_;
+  Instant t_output = t_initial_;
+  int outputs = 0;
+  Length position_error;
+  Speed velocity_error;
+  std::vector<Length> positions;
+  std::vector<Speed> velocities;
+  problem.append_dense_state =
+      [this, &outputs, &positions, &position_error, &t_last, &t_output,
+       &velocities, &velocity_error, output_interval, ω](
+          ODE::DenseState const& dense_state) {
+        EXPECT_EQ(t_last, dense_state.t_min());
+        EXPECT_EQ(solution_.back().time.value, dense_state.t_max());
+        t_last = dense_state.t_max();
+        for (; t_output <= dense_state.t_max(); t_output += output_interval) {
+          dense_state.Evaluate(t_output, &positions, &velocities);
+          Time const t = t_output - Instant();
+          position_error = std::max(position_error,
+                                    AbsoluteError(x_initial_ * Cos(ω * t),
+                                                  positions[0]));
+          velocity_error = std::max(velocity_error,
+                                    AbsoluteError(-x_initial_ * ω * Sin(ω * t) /
+                                                      Radian,
+                                                  velocities[0]));
+          ++outputs;
+        }
+      };
+  evaluations_ = 0;
+  solution_.clear();
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_EQ(evaluations_without_dense_output, evaluations_);
+  EXPECT_EQ(solution_without_dense_output.size(), solution_.size());
+  EXPECT_THAT(outputs, Eq(629));
+  EXPECT_THAT(position_error, Lt(2E-7 * Metre));
+  EXPECT_THAT(velocity_error, Lt(1E-6 * Metre / Second));
+}
+
+// The zeros of the position are located on the dense output, without
+// additional evaluations.  A terminal event stops the integration at its first
+// occurrence.
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
+       HarmonicOscillatorEvents) {
+  AdaptiveStepSizeIntegrator<ODE> const& integrator =
+      DormandElMikkawyPrince1986RKN646FM<Length>();
+
+  IntegrationProblem<ODE> problem = MakeHarmonicOscillatorProblem();
+  AdaptiveStepSize<ODE> const adaptive_step_size =
+      MakeAdaptiveStepSize(1E-6 * Metre, 1E-6 * Metre / Second);
+
+  integrator.Solve(problem, adaptive_step_size);
+  int const evaluations_without_events = evaluations_;
+  int const steps_without_events = solution_.size();
+
+  // The position vanishes at π/2 + kπ.
+  std::vector<ODE::SystemState> occurrences;
+  ODE::Event zero;
+  zero.function = [](Instant const& t,
+                     std::vector<Length> const& positions,
+                     std::vector<Speed> const& velocities) {
+    return positions[0] / Metre;
+  };
+  zero.append_occurrence = [&occurrences](ODE::SystemState const& state) {
+    occurrences.push_back(state);
+  };
+  problem.events.push_back(zero);
+  evaluations_ = 0;
+  solution_.clear();
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_EQ(evaluations_without_events, evaluations_);
+  EXPECT_EQ(steps_without_events, solution_.size());
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  ASSERT_THAT(occurrences.size(), Eq(20));
+  for (int k = 0; k < occurrences.size(); ++k) {
+    EXPECT_THAT(Abs(occurrences[k].time.value -
+                    (t_initial_ + (k + 0.5) * π * Second)),
+                Lt(1E-6 * Second));
+    EXPECT_THAT(AbsoluteError(0 * Metre, occurrences[k].positions[0].value),
+                Lt(1E-6 * Metre));
+  }
+
+  // Only the increasing zeros, the first of which ends the integration.
+  problem.events.front().direction = kIncreasing;
+  problem.events.front().terminal = true;
+  occurrences.clear();
+  solution_.clear();
+  integrator.Solve(problem, adaptive_step_size);
+  ASSERT_THAT(occurrences.size(), Eq(1));
+  EXPECT_EQ(occurrences.front().time.value, solution_.back().time.value);
+  EXPECT_THAT(
+      Abs(solution_.back().time.value - (t_initial_ + 1.5 * π * Second)),
+      Lt(1E-6 * Second));
+  EXPECT_THAT(AbsoluteError(0 * Metre, solution_.back().positions[0].value),
+              Lt(1E-6 * Metre));
+  EXPECT_THAT(AbsoluteError(x_initial_ / Second,
+                            solution_.back().velocities[0].value),
+              Lt(1E-6 * Metre / Second));
+}
+
+// The proportional-integral controller avoids the rejections that the
+// elementary controller incurs after the first step, at the cost of smaller
+// steps on this smooth problem.  The bounds on the step ratio slow down the
+// reduction of the overly large first step.
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest,
+       HarmonicOscillatorProportionalIntegralController) {
+  AdaptiveStepSizeIntegrator<ODE> const& integrator =
+      DormandElMikkawyPrince1986RKN434FM<Length>();
+
+  IntegrationProblem<ODE> const problem = MakeHarmonicOscillatorProblem();
+  AdaptiveStepSizeStatistics statistics;
+  AdaptiveStepSize<ODE> adaptive_step_size =
+      MakeAdaptiveStepSize(1 * Milli(Metre), 1 * Milli(Metre) / Second);
+  adaptive_step_size.statistics = &statistics;
+
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_EQ(132, statistics.accepted_steps);
+  EXPECT_EQ(solution_.size(), statistics.accepted_steps);
+  EXPECT_EQ(4, statistics.rejected_steps);
+  EXPECT_EQ(410, statistics.evaluations);
+  EXPECT_EQ(evaluations_, statistics.evaluations);
+  EXPECT_EQ(4 + 3 * 3, statistics.rejected_evaluations);
+
+  adaptive_step_size.controller = kProportionalIntegral;
+  evaluations_ = 0;
+  solution_.clear();
+  statistics = AdaptiveStepSizeStatistics();
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              AllOf(Ge(1E-4 * Metre), Le(2E-4 * Metre)));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              AllOf(Ge(1E-3 * Metre / Second), Le(2E-3 * Metre / Second)));
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_EQ(170, statistics.accepted_steps);
+  EXPECT_EQ(solution_.size(), statistics.accepted_steps);
+  EXPECT_EQ(1, statistics.rejected_steps);
+  EXPECT_EQ(515, statistics.evaluations);
+  EXPECT_EQ(evaluations_, statistics.evaluations);
+  EXPECT_EQ(4, statistics.rejected_evaluations);
+
+  adaptive_step_size.minimal_step_ratio = 0.2;
+  adaptive_step_size.maximal_step_ratio = 5;
+  evaluations_ = 0;
+  solution_.clear();
+  statistics = AdaptiveStepSizeStatistics();
+  integrator.Solve(problem, adaptive_step_size);
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_EQ(165, statistics.accepted_steps);
+  EXPECT_EQ(3, statistics.rejected_steps);
+  EXPECT_EQ(508, statistics.evaluations);
+  EXPECT_EQ(evaluations_, statistics.evaluations);
+  EXPECT_EQ(3 * 4, statistics.rejected_evaluations);
+}
+
+// Passing the right-hand side as a functor yields the same steps as calling it
+// through |problem.equation|.
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, StaticDispatch) {
+  auto const& integrator = DormandElMikkawyPrince1986RKN434FM<Length>();
+
+  IntegrationProblem<ODE> const problem = MakeHarmonicOscillatorProblem();
+  AdaptiveStepSize<ODE> const adaptive_step_size =
+      MakeAdaptiveStepSize(1 * Milli(Metre), 1 * Milli(Metre) / Second);
+
+  integrator.Solve(problem, adaptive_step_size);
+  int const type_erased_evaluations = evaluations_;
+  std::vector<ODE::SystemState> const type_erased_solution = solution_;
+
+  evaluations_ = 0;
+  solution_.clear();
+  integrator.Solve(problem,
+                   adaptive_step_size,
+                   [this](Instant const& t,
+                          std::vector<Length> const& q,
+                          not_null<std::vector<Acceleration>*> const result) {
+                     ComputeHarmonicOscillatorAcceleration(
+                         t, q, result, &evaluations_);
+                   });
+  EXPECT_EQ(type_erased_evaluations, evaluations_);
+  ASSERT_EQ(type_erased_solution.size(), solution_.size());
+  for (int i = 0; i < solution_.size(); ++i) {
+    EXPECT_EQ(type_erased_solution[i].time.value, solution_[i].time.value);
+    EXPECT_EQ(type_erased_solution[i].positions[0].value,
+              solution_[i].positions[0].value);
+    EXPECT_EQ(type_erased_solution[i].velocities[0].value,
+              solution_[i].velocities[0].value);
+  }
+}
+
 }  // namespace integrators
 }  // namespace principia
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+
+namespace principia {
+
+using base::not_null;
+
+namespace integrators {
+
+// Locates the occurrences of the |events| of an |IntegrationProblem| on the
+// dense output of the steps of an integrator.  The occurrences are the roots of
+// the event functions, which are found by the Illinois variant of the regula
+// falsi, so they cost no evaluations of the right-hand side.
+template<typename Position>
+class EventDetector {
+ public:
+  using ODE = SpecialSecondOrderDifferentialEquation<Position>;
+
+  // |events| must outlive this object.
+  EventDetector(std::vector<typename ODE::Event> const& events,
+                typename ODE::SystemState const& initial_state);
+
+  // Reports, in chronological order, the occurrences of the events in the
+  // step described by |dense_state|, which ends at |*state|.  Returns true if
+  // one of them is an occurrence of a terminal event, in which case no later
+  // occurrence is reported and |*state| is set to the state at that
+  // occurrence.
+  bool DetectOccurrences(typename ODE::DenseState const& dense_state,
+                         not_null<typename ODE::SystemState*> const state);
+
+ private:
+  using Velocity = typename ODE::Velocity;
+
+  // Returns the value of the function of |event| at |t| on |dense_state|.
+  double Evaluate(typename ODE::Event const& event,
+                  typename ODE::DenseState const& dense_state,
+                  Instant const& t);
+
+  // Returns the time of a root of the function of |event| on |dense_state|,
+  // as a fraction of the step, given its values at both ends of the step,
+  // which have opposite signs or the second of which is 0.
+  double LocateRoot(typename ODE::Event const& event,
+                     typename ODE::DenseState const& dense_state,
+                     double const initial_value,
+                     double const final_value);
+
+  std::vector<typename ODE::Event> const& events_;
+  // The values of the event functions at the end of the last step.
+  std::vector<double> values_;
+  std::vector<Position> positions_;
+  std::vector<Velocity> velocities_;
+};
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/event_detector_body.hpp"
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "integrators/event_detector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace integrators {
+
+template<typename Position>
+EventDetector<Position>::EventDetector(
+    std::vector<typename ODE::Event> const& events,
+    typename ODE::SystemState const& initial_state)
+    : events_(events),
+      values_(events.size()),
+      positions_(initial_state.positions.size()),
+      velocities_(initial_state.velocities.size()) {
+  for (int k = 0; k < positions_.size(); ++k) {
+    positions_[k] = initial_state.positions[k].value;
+    velocities_[k] = initial_state.velocities[k].value;
+  }
+  for (int i = 0; i < events_.size(); ++i) {
+    values_[i] = events_[i].function(initial_state.time.value,
+                                     positions_,
+                                     velocities_);
+  }
+}
+
+template<typename Position>
+bool EventDetector<Position>::DetectOccurrences(
+    typename ODE::DenseState const& dense_state,
+    not_null<typename ODE::SystemState*> const state) {
+  if (events_.empty()) {
+    return false;
+  }
+  for (int k = 0; k < positions_.size(); ++k) {
+    positions_[k] = state->positions[k].value;
+    velocities_[k] = state->velocities[k].value;
+  }
+
+  // The occurrences in this step, as fractions of the step, and the indices of
+  // the corresponding events.
+  std::vector<std::pair<double, int>> occurrences;
+  for (int i = 0; i < events_.size(); ++i) {
+    typename ODE::Event const& event = events_[i];
+    double const initial_value = values_[i];
+    double const final_value =
+        event.function(state->time.value, positions_, velocities_);
+    values_[i] = final_value;
+    bool const increasing = initial_value < 0 && final_value >= 0;
+    bool const decreasing = initial_value > 0 && final_value <= 0;
+    if ((increasing && event.direction != kDecreasing) ||
+        (decreasing && event.direction != kIncreasing)) {
+      occurrences.emplace_back(
+          LocateRoot(event, dense_state, initial_value, final_value), i);
+    }
+  }
+  if (occurrences.empty()) {
+    return false;
+  }
+
+  std::sort(occurrences.begin(), occurrences.end());
+  Time const h = dense_state.t_max() - dense_state.t_min();
+  for (auto const& occurrence : occurrences) {
+    typename ODE::Event const& event = events_[occurrence.second];
+    if (!event.terminal && !event.append_occurrence) {
+      continue;
+    }
+    Instant const t = occurrence.first == 1
+                          ? dense_state.t_max()
+                          : dense_state.t_min() + occurrence.first * h;
+    dense_state.Evaluate(t, &positions_, &velocities_);
+    typename ODE::SystemState occurrence_state;
+    occurrence_state.time = t;
+    for (int k = 0; k < positions_.size(); ++k) {
+      occurrence_state.positions.emplace_back(positions_[k]);
+      occurrence_state.velocities.emplace_back(velocities_[k]);
+    }
+    if (event.append_occurrence) {
+      event.append_occurrence(occurrence_state);
+    }
+    if (event.terminal) {
+      *state = std::move(occurrence_state);
+      return true;
+    }
+  }
+  return false;
+}
+
+template<typename Position>
+double EventDetector<Position>::Evaluate(
+    typename ODE::Event const& event,
+    typename ODE::DenseState const& dense_state,
+    Instant const& t) {
+  dense_state.Evaluate(t, &positions_, &velocities_);
+  return event.function(t, positions_, velocities_);
+}
+
+template<typename Position>
+double EventDetector<Position>::LocateRoot(
+    typename ODE::Event const& event,
+    typename ODE::DenseState const& dense_state,
+    double const initial_value,
+    double const final_value) {
+  int const max_iterations = 100;
+  Instant const& t_initial = dense_state.t_min();
+  Time const h = dense_state.t_max() - t_initial;
+  if (final_value == 0) {
+    return 1;
+  }
+
+  // The Illinois algorithm, on the fraction s of the step.  The bracket is
+  // [s_low, s_high], and the value at the end that was retained twice in a
+  // row is halved.
+  double s_low = 0;
+  double s_high = 1;
+  double value_low = initial_value;
+  double value_high = final_value;
+  int retained_side = 0;
+  double s = 0;
+  for (int n = 0;
+       n < max_iterations &&
+           s_high - s_low > 2 * std::numeric_limits<double>::epsilon();
+       ++n) {
+    s = (s_low * value_high - s_high * value_low) / (value_high - value_low);
+    double const value = Evaluate(event, dense_state, t_initial + s * h);
+    if (value == 0) {
+      break;
+    } else if ((value < 0) == (value_high < 0)) {
+      s_high = s;
+      value_high = value;
+      if (retained_side == -1) {
+        value_low /= 2;
+      }
+      retained_side = -1;
+    } else {
+      s_low = s;
+      value_low = value;
+      if (retained_side == +1) {
+        value_high /= 2;
+      }
+      retained_side = +1;
+    }
+  }
+  return s;
+}
+
+}  // namespace integrators
+}  // namespace principia
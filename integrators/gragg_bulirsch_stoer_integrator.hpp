@@ -0,0 +1,77 @@
+#pragma once
+
+#include "integrators/ordinary_differential_equations.hpp"
+#include "numerics/fixed_arrays.hpp"
+
+namespace principia {
+
+using numerics::FixedVector;
+
+namespace integrators {
+
+// This class solves ordinary differential equations of the form q″ = f(q, t)
+// by extrapolation of the Störmer rule.  A step of size H is computed with the
+// Störmer rule for nⱼ = 2, 4, 6, ... substeps of size h = H / nⱼ,
+//   q₁ - q₀ = Δ₀ = h (v₀ + h f₀ / 2),
+//   qₘ₊₁ - qₘ = Δₘ = Δₘ₋₁ + h² fₘ,
+//   vₙ = Δₙ₋₁ / h + h fₙ / 2,
+// whose error has an expansion in even powers of h, see Hairer, Nørsett and
+// Wanner (1993), Solving Ordinary Differential Equations I, section II.14.
+// The results are extrapolated to h = 0 by the Aitken-Neville algorithm, which
+// yields a table Tⱼₖ, 0 ≤ k ≤ j, of methods of order 2k + 2.  The difference
+// Tⱼⱼ₋₁ - Tⱼⱼ is the error estimate of row j.
+//
+// Both the step size and the row are adapted, following the order and step
+// size control of section II.9 of Hairer, Nørsett and Wanner: if k is the
+// target row, |adaptive_step_size.tolerance_to_error_ratio| is called with the
+// error estimates of the rows k - 1, k and k + 1 in turn, the step is accepted
+// at the first of these rows for which the result is at least 1, and it is
+// recomputed with a smaller step size if it is less than 1 for all of them.
+// The target row of the next step is the one which minimizes the number of
+// evaluations per unit time.  Unlike the fixed-order integrators, this one is
+// only efficient for small tolerances, where it uses high rows.  Since its step
+// size control is tied to the choice of the row, it ignores
+// |adaptive_step_size.controller| and the bounds on the step ratio.
+//
+// This integrator has no dense output: the quintic Hermite interpolation used
+// by the embedded Runge-Kutta-Nyström integrators would be much less accurate
+// than the long, high-order steps of the extrapolation.  Therefore
+// |problem.append_dense_state| must be empty and |problem.events| must be
+// empty.
+template<typename Position, int rows_>
+class GraggBulirschStoerIntegrator
+    : public AdaptiveStepSizeIntegrator<
+                 SpecialSecondOrderDifferentialEquation<Position>> {
+ public:
+  GraggBulirschStoerIntegrator();
+
+  GraggBulirschStoerIntegrator(GraggBulirschStoerIntegrator const&) = delete;
+  GraggBulirschStoerIntegrator(GraggBulirschStoerIntegrator&&) = delete;
+  GraggBulirschStoerIntegrator& operator=(
+      GraggBulirschStoerIntegrator const&) = delete;
+  GraggBulirschStoerIntegrator& operator=(
+      GraggBulirschStoerIntegrator&&) = delete;
+
+  void Solve(IntegrationProblem<ODE> const& problem,
+             AdaptiveStepSize<ODE> const& adaptive_step_size) const override;
+
+  static int const rows = rows_;
+
+ private:
+  // The number of substeps nⱼ of row j.
+  FixedVector<int, rows_> substeps_;
+  // The number of evaluations needed to compute rows 0 to j of the table.
+  FixedVector<int, rows_> evaluations_;
+};
+
+// The harmonic sequence nⱼ = 2 (j + 1), with at most 8 rows, i.e., order 16,
+// as in the code ODEX2 of Hairer, Nørsett and Wanner (1993), Solving Ordinary
+// Differential Equations I.
+template<typename Position>
+GraggBulirschStoerIntegrator<Position, 8> const&
+HairerNørsettWanner1993ODEX2();
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/gragg_bulirsch_stoer_integrator_body.hpp"
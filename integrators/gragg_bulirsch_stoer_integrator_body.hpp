@@ -0,0 +1,269 @@
+#pragma once
+
+#include "integrators/gragg_bulirsch_stoer_integrator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+
+using geometry::Sign;
+using quantities::Abs;
+
+namespace integrators {
+
+template<typename Position, int rows_>
+GraggBulirschStoerIntegrator<Position, rows_>::GraggBulirschStoerIntegrator() {
+  static_assert(rows_ >= 4, "Too few rows for order control");
+  int evaluations = 1;
+  for (int j = 0; j < rows_; ++j) {
+    substeps_[j] = 2 * (j + 1);
+    evaluations += substeps_[j];
+    evaluations_[j] = evaluations;
+  }
+}
+
+template<typename Position, int rows_>
+void GraggBulirschStoerIntegrator<Position, rows_>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    AdaptiveStepSize<ODE> const& adaptive_step_size) const {
+  using Displacement = typename ODE::Displacement;
+  using Velocity = typename ODE::Velocity;
+  using Acceleration = typename ODE::Acceleration;
+
+  // The target row of the first step.
+  int const first_row = std::min(3, rows_ - 2);
+  // Bounds on the ratio of two consecutive step sizes.
+  double const minimal_step_ratio = 0.02;
+  double const maximal_step_ratio = 4.0;
+
+  // Argument checks.
+  CHECK_NOTNULL(problem.initial_state);
+  int const dimension = problem.initial_state->positions.size();
+  CHECK_EQ(dimension, problem.initial_state->velocities.size());
+  CHECK_NE(Time(), adaptive_step_size.first_time_step);
+  Sign const integration_direction =
+      Sign(adaptive_step_size.first_time_step);
+  if (integration_direction.Positive()) {
+    // Integrating forward.
+    CHECK_LT(problem.initial_state->time.value, problem.t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(problem.initial_state->time.value, problem.t_final);
+  }
+  CHECK_GT(adaptive_step_size.safety_factor, 0);
+  CHECK_LT(adaptive_step_size.safety_factor, 1);
+  CHECK(!problem.append_dense_state) << "No dense output";
+  CHECK(problem.events.empty()) << "No event detection";
+
+  typename ODE::SystemState current_state = *problem.initial_state;
+
+  // Time step.
+  Time H = adaptive_step_size.first_time_step;
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state.time;
+  // Current position.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Position>>& q = current_state.positions;
+  // Current velocity.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
+
+  // Accelerations at the beginning of the step, shared by all the rows.
+  std::vector<Acceleration> g_initial(dimension);
+  // Accelerations at the current substep.
+  std::vector<Acceleration> g(dimension);
+  // Current substep.
+  std::vector<Position> q_stage(dimension);
+  // The difference Δₘ of the Störmer rule.
+  std::vector<Displacement> Δ(dimension);
+  // Position increment since the beginning of the step.
+  std::vector<Displacement> Δq(dimension);
+
+  // The increments of position and velocity given by the rows j - 1 and j of
+  // the extrapolation table, indexed by column.
+  std::array<std::vector<Displacement>, rows_> previous_row_Δq;
+  std::array<std::vector<Velocity>, rows_> previous_row_Δv;
+  std::array<std::vector<Displacement>, rows_> current_row_Δq;
+  std::array<std::vector<Velocity>, rows_> current_row_Δv;
+  for (int i = 0; i < rows_; ++i) {
+    previous_row_Δq[i].resize(dimension);
+    previous_row_Δv[i].resize(dimension);
+    current_row_Δq[i].resize(dimension);
+    current_row_Δv[i].resize(dimension);
+  }
+
+  // Difference between the last two columns of a row.
+  typename ODE::SystemStateError error_estimate;
+  error_estimate.position_error.resize(dimension);
+  error_estimate.velocity_error.resize(dimension);
+
+  // The step sizes for which the error estimate of each row would be close to
+  // the tolerance, and the corresponding number of evaluations per unit time.
+  std::vector<Time> step_sizes(rows_);
+  auto const work = [this, &step_sizes](int const j) {
+    return evaluations_[j] / Abs(step_sizes[j]);
+  };
+
+  // The target row of the next step.
+  int row = first_row;
+
+  AdaptiveStepSizeStatistics statistics;
+
+  bool at_end = false;
+  while (!at_end) {
+    for (int k = 0; k < dimension; ++k) {
+      q_stage[k] = q[k].value;
+    }
+    problem.equation.compute_acceleration(t.value, q_stage, &g_initial);
+    ++statistics.evaluations;
+
+    // Compute the next step with decreasing step sizes until the error is
+    // tolerable at one of the rows |row - 1|, |row|, |row + 1|.
+    int accepted_row = -1;
+    for (;;) {
+      // The number of evaluations of the right-hand side in this attempt.
+      int attempt_evaluations = 0;
+      // Termination condition.
+      Time const time_to_end = (problem.t_final - t.value) - t.error;
+      at_end = integration_direction * H >= integration_direction * time_to_end;
+      if (at_end) {
+        // The chosen step size will overshoot.  Clip it to just reach the end,
+        // and terminate if the step is accepted.
+        H = time_to_end;
+      }
+
+      for (int j = 0; j <= row + 1; ++j) {
+        // Störmer rule with n substeps; fills the first column of the row.
+        int const n = substeps_[j];
+        Time const h = H / n;
+        attempt_evaluations += n;
+        for (int k = 0; k < dimension; ++k) {
+          Δ[k] = h * (v[k].value + 0.5 * h * g_initial[k]);
+          Δq[k] = Δ[k];
+        }
+        for (int m = 1; m < n; ++m) {
+          for (int k = 0; k < dimension; ++k) {
+            q_stage[k] = q[k].value + Δq[k];
+          }
+          problem.equation.compute_acceleration(t.value + m * h, q_stage, &g);
+          for (int k = 0; k < dimension; ++k) {
+            Δ[k] += h * h * g[k];
+            Δq[k] += Δ[k];
+          }
+        }
+        for (int k = 0; k < dimension; ++k) {
+          q_stage[k] = q[k].value + Δq[k];
+        }
+        problem.equation.compute_acceleration(t.value + H, q_stage, &g);
+        for (int k = 0; k < dimension; ++k) {
+          current_row_Δq[0][k] = Δq[k];
+          current_row_Δv[0][k] = Δ[k] / h + 0.5 * h * g[k] - v[k].value;
+        }
+
+        // Aitken-Neville extrapolation in h².
+        for (int i = 1; i <= j; ++i) {
+          double const ratio = static_cast<double>(n) / substeps_[j - i];
+          double const denominator = ratio * ratio - 1.0;
+          for (int k = 0; k < dimension; ++k) {
+            current_row_Δq[i][k] =
+                current_row_Δq[i - 1][k] +
+                (current_row_Δq[i - 1][k] - previous_row_Δq[i - 1][k]) /
+                    denominator;
+            current_row_Δv[i][k] =
+                current_row_Δv[i - 1][k] +
+                (current_row_Δv[i - 1][k] - previous_row_Δv[i - 1][k]) /
+                    denominator;
+          }
+        }
+
+        // Step size control.  The error estimate of row j has order 2j, so
+        // the error of the step is proportional to H²ʲ⁺¹.
+        if (j > 0) {
+          for (int k = 0; k < dimension; ++k) {
+            error_estimate.position_error[k] =
+                current_row_Δq[j - 1][k] - current_row_Δq[j][k];
+            error_estimate.velocity_error[k] =
+                current_row_Δv[j - 1][k] - current_row_Δv[j][k];
+          }
+          double const tolerance_to_error_ratio =
+              adaptive_step_size.tolerance_to_error_ratio(H, error_estimate);
+          double const step_ratio =
+              adaptive_step_size.safety_factor *
+              std::pow(tolerance_to_error_ratio, 1.0 / (2 * j + 1));
+          step_sizes[j] = H * std::min(maximal_step_ratio,
+                                       std::max(minimal_step_ratio,
+                                                step_ratio));
+          if (j >= row - 1 && tolerance_to_error_ratio >= 1.0) {
+            accepted_row = j;
+            break;
+          }
+        }
+        std::swap(previous_row_Δq, current_row_Δq);
+        std::swap(previous_row_Δv, current_row_Δv);
+      }
+      statistics.evaluations += attempt_evaluations;
+      if (accepted_row >= 0) {
+        ++statistics.accepted_steps;
+        break;
+      }
+      ++statistics.rejected_steps;
+      statistics.rejected_evaluations += attempt_evaluations;
+
+      // The step is rejected; retry with the row that was the cheapest.
+      if (row > 2 && work(row - 1) < 0.8 * work(row)) {
+        --row;
+      }
+      H = step_sizes[row];
+    }
+
+    // Increment the solution with the extrapolated values of the accepted row.
+    t.Increment(H);
+    for (int k = 0; k < dimension; ++k) {
+      q[k].Increment(current_row_Δq[accepted_row][k]);
+      v[k].Increment(current_row_Δv[accepted_row][k]);
+    }
+    problem.append_state(current_state);
+
+    // Order and step size control: pick the row that minimizes the work per
+    // unit time, and try a higher row if the accepted one did well.
+    int const j = accepted_row;
+    if (j >= 2 && work(j - 1) < 0.8 * work(j)) {
+      row = j - 1;
+      H = step_sizes[row];
+    } else if (j + 1 <= rows_ - 2 && (j == 1 || work(j) < 0.9 * work(j - 1))) {
+      row = j + 1;
+      H = step_sizes[j] * evaluations_[row] / evaluations_[j];
+    } else {
+      row = j;
+      H = step_sizes[j];
+    }
+    row = std::max(2, std::min(row, rows_ - 2));
+  }
+
+  if (adaptive_step_size.statistics != nullptr) {
+    adaptive_step_size.statistics->accepted_steps += statistics.accepted_steps;
+    adaptive_step_size.statistics->rejected_steps += statistics.rejected_steps;
+    adaptive_step_size.statistics->evaluations += statistics.evaluations;
+    adaptive_step_size.statistics->rejected_evaluations +=
+        statistics.rejected_evaluations;
+  }
+}
+
+template<typename Position>
+GraggBulirschStoerIntegrator<Position, 8> const&
+HairerNørsettWanner1993ODEX2() {
+  static GraggBulirschStoerIntegrator<Position, 8> const integrator;
+  return integrator;
+}
+
+}  // namespace integrators
+}  // namespace principia
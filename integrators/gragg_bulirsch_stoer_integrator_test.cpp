@@ -0,0 +1,192 @@
+#include "integrators/gragg_bulirsch_stoer_integrator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using quantities::Abs;
+using quantities::Acceleration;
+using quantities::Length;
+using quantities::Mass;
+using quantities::SIUnit;
+using quantities::Speed;
+using quantities::Stiffness;
+using quantities::Time;
+using si::Metre;
+using si::Milli;
+using si::Second;
+using testing_utilities::AbsoluteError;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::testing::AllOf;
+using ::testing::Ge;
+using ::testing::Le;
+using ::testing::Lt;
+
+namespace integrators {
+
+using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+
+namespace {
+
+double HarmonicOscillatorToleranceRatio(
+    Time const& h,
+    ODE::SystemStateError const& error,
+    Length const& q_tolerance,
+    Speed const& v_tolerance) {
+  return std::min(q_tolerance / Abs(error.position_error[0]),
+                  v_tolerance / Abs(error.velocity_error[0]));
+}
+
+}  // namespace
+
+class GraggBulirschStoerIntegratorTest : public ::testing::Test {
+ protected:
+  GraggBulirschStoerIntegratorTest() {
+    harmonic_oscillator_.compute_acceleration =
+        [this](Instant const& t,
+               std::vector<Length> const& q,
+               not_null<std::vector<Acceleration>*> const result) {
+          (*result)[0] = -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+          ++evaluations_;
+        };
+  }
+
+  // Integrates the harmonic oscillator from |initial_state| to |t_final| with
+  // the given tolerances, and appends the states to |solution_|.
+  void Solve(AdaptiveStepSizeIntegrator<ODE> const& integrator,
+             ODE::SystemState const& initial_state,
+             Instant const& t_final,
+             Length const& length_tolerance,
+             Speed const& speed_tolerance) {
+    IntegrationProblem<ODE> problem;
+    problem.equation = harmonic_oscillator_;
+    problem.initial_state = &initial_state;
+    problem.t_final = t_final;
+    problem.append_state = [this](ODE::SystemState const& state) {
+      solution_.push_back(state);
+    };
+    AdaptiveStepSize<ODE> adaptive_step_size;
+    adaptive_step_size.first_time_step = t_final - initial_state.time.value;
+    adaptive_step_size.safety_factor = 0.9;
+    adaptive_step_size.tolerance_to_error_ratio =
+        std::bind(HarmonicOscillatorToleranceRatio,
+                  _1, _2, length_tolerance, speed_tolerance);
+    evaluations_ = 0;
+    integrator.Solve(problem, adaptive_step_size);
+  }
+
+  Length const x_initial_ = 1 * Metre;
+  Speed const v_initial_ = 0 * Metre / Second;
+  Time const period_ = 2 * π * Second;
+  Instant const t_initial_;
+  Instant const t_final_ = t_initial_ + 10 * period_;
+  ODE::SystemState const initial_state_ =
+      {{x_initial_}, {v_initial_}, t_initial_};
+
+  ODE harmonic_oscillator_;
+  std::vector<ODE::SystemState> solution_;
+  int evaluations_ = 0;
+};
+
+TEST_F(GraggBulirschStoerIntegratorTest, HarmonicOscillatorBackAndForth) {
+  auto const& integrator = HairerNørsettWanner1993ODEX2<Length>();
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+
+  Solve(integrator,
+        initial_state_,
+        t_final_,
+        length_tolerance,
+        speed_tolerance);
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              Lt(1E-2 * Metre));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              Lt(1E-2 * Metre / Second));
+  // Each step takes a sizeable fraction of a period.
+  int const steps_forward = solution_.size();
+  EXPECT_THAT(steps_forward, AllOf(Ge(10), Le(20)));
+  EXPECT_THAT(evaluations_, Lt(600));
+
+  // We integrate backward with double the tolerance.
+  ODE::SystemState const final_state = solution_.back();
+  Solve(integrator,
+        final_state,
+        t_initial_,
+        2 * length_tolerance,
+        2 * speed_tolerance);
+  EXPECT_EQ(t_initial_, solution_.back().time.value);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              Lt(2E-2 * Metre));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              Lt(2E-2 * Metre / Second));
+  EXPECT_THAT(solution_.size() - steps_forward, AllOf(Ge(10), Le(20)));
+  EXPECT_THAT(evaluations_, Lt(600));
+}
+
+// At small tolerances the extrapolation uses high orders and needs far fewer
+// evaluations than a fixed-order method: 1466 instead of 12347 for RKN434FM
+// with a tolerance of 1E-9.
+TEST_F(GraggBulirschStoerIntegratorTest, SmallTolerance) {
+  Length const length_tolerance = 1E-9 * Metre;
+  Speed const speed_tolerance = 1E-9 * Metre / Second;
+
+  Solve(HairerNørsettWanner1993ODEX2<Length>(),
+        initial_state_,
+        t_final_,
+        length_tolerance,
+        speed_tolerance);
+  EXPECT_EQ(t_final_, solution_.back().time.value);
+  EXPECT_THAT(AbsoluteError(x_initial_, solution_.back().positions[0].value),
+              Lt(1E-7 * Metre));
+  EXPECT_THAT(AbsoluteError(v_initial_, solution_.back().velocities[0].value),
+              Lt(1E-7 * Metre / Second));
+  int const extrapolation_evaluations = evaluations_;
+  EXPECT_THAT(extrapolation_evaluations, Lt(2000));
+
+  Solve(DormandElMikkawyPrince1986RKN434FM<Length>(),
+        initial_state_,
+        t_final_,
+        length_tolerance,
+        speed_tolerance);
+  EXPECT_THAT(8 * extrapolation_evaluations, Lt(evaluations_));
+}
+
+using GraggBulirschStoerIntegratorDeathTest = GraggBulirschStoerIntegratorTest;
+
+TEST_F(GraggBulirschStoerIntegratorDeathTest, NoDenseOutputOrEvents) {
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator_;
+  problem.initial_state = &initial_state_;
+  problem.t_final = t_final_;
+  problem.append_state = [](ODE::SystemState const& state) {};
+  AdaptiveStepSize<ODE> adaptive_step_size;
+  adaptive_step_size.first_time_step = t_final_ - t_initial_;
+  adaptive_step_size.safety_factor = 0.9;
+  adaptive_step_size.tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2, 1 * Milli(Metre), 1 * Milli(Metre) / Second);
+  auto const& integrator = HairerNørsettWanner1993ODEX2<Length>();
+
+  problem.append_dense_state = [](ODE::DenseState const& dense_state) {};
+  EXPECT_DEATH({
+    integrator.Solve(problem, adaptive_step_size);
+  }, "No dense output");
+
+  problem.append_dense_state = nullptr;
+  problem.events.emplace_back();
+  EXPECT_DEATH({
+    integrator.Solve(problem, adaptive_step_size);
+  }, "No event detection");
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -1,10 +1,13 @@
 ﻿#pragma once
 
 #include <functional>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
+#include "integrators/quintic_hermite_interpolant.hpp"
 #include "numerics/double_precision.hpp"
 #include "quantities/named_quantities.hpp"
 
@@ -13,11 +16,48 @@ namespace principia {
 using base::not_null;
 using geometry::Instant;
 using numerics::DoublePrecision;
+using quantities::GravitationalParameter;
 using quantities::Time;
 using quantities::Variation;
 
 namespace integrators {
 
+// The sign changes of an event function that are occurrences of the event.
+enum EventDirection {
+  kIncreasing,
+  kDecreasing,
+  kIncreasingOrDecreasing,
+};
+
+// The rule used by the adaptive step size integrators to choose the next step
+// size from the |tolerance_to_error_ratio| of the last steps.
+enum StepSizeController {
+  // The step size is scaled by (tolerance / error)^(1 / (p + 1)), where p is
+  // the order of the error estimate.
+  kElementary,
+  // The proportional-integral controller of Gustafsson (1991), Control
+  // theoretic techniques for stepsize selection in explicit Runge-Kutta
+  // methods, with the coefficients of Hairer and Wanner (1996), Solving
+  // Ordinary Differential Equations II, section IV.2: the step size is scaled
+  // by (tolerance / errorₙ)^(0.7 / (p + 1)) (errorₙ₋₁ / tolerance)^(0.4 /
+  // (p + 1)), where errorₙ and errorₙ₋₁ are those of the last two steps.
+  // This damps the oscillation between accepted and rejected steps that the
+  // elementary controller exhibits when the error varies rapidly along the
+  // solution.  The elementary controller is used after a rejection.
+  kProportionalIntegral,
+};
+
+// Counts of the work done by an adaptive step size integrator.
+struct AdaptiveStepSizeStatistics {
+  int accepted_steps = 0;
+  int rejected_steps = 0;
+  // The number of evaluations of the right-hand side, including those in the
+  // rejected steps.
+  int evaluations = 0;
+  // The number of evaluations of the right-hand side in the rejected steps.
+  int rejected_evaluations = 0;
+};
+
 // A differential equation of the form q″ = f(q, t).
 // |Position| is the type of q.
 template<typename Position>
@@ -42,11 +82,30 @@ struct SpecialSecondOrderDifferentialEquation {
     std::vector<Displacement> position_error;
     std::vector<Velocity> velocity_error;
   };
+  // The solution over a step, for integrators that have dense output.
+  using DenseState = QuinticHermiteInterpolant<Position>;
+  // An event, e.g., a periapsis or the crossing of a sphere, whose occurrences
+  // are the sign changes of |function| along the solution.
+  struct Event {
+    std::function<double(Instant const& t,
+                         std::vector<Position> const& positions,
+                         std::vector<Velocity> const& velocities)> function;
+    EventDirection direction = kIncreasingOrDecreasing;
+    // If true, the integration stops at the first occurrence of the event.
+    bool terminal = false;
+    // If set, called with the state at each occurrence of the event.
+    std::function<void(SystemState const& state)> append_occurrence;
+  };
   // A functor that computes f(q, t) and stores it in |*accelerations|.
   // This functor must be called with |accelerations->size()| equal to
   // |positions->size()|, but there is no requirement on the values in
   // |*acceleration|.
   RightHandSideComputation compute_acceleration;
+  // If the equation describes the motion of massive bodies under their mutual
+  // gravitation, the gravitational parameters of these bodies, in the order of
+  // the |SystemState|.  Empty otherwise.  Integrators that split the motion in
+  // Keplerian orbits and their perturbations use it.
+  std::vector<GravitationalParameter> gravitational_parameters;
 };
 
 // An initial value problem, together with a final time for the solution
@@ -57,6 +116,18 @@ struct IntegrationProblem {
   typename ODE::SystemState const* initial_state;
   Instant t_final;
   std::function<void(typename ODE::SystemState const& state)> append_state;
+  // If set, called after each accepted step, after |append_state|, with the
+  // solution over that step, which may be evaluated at any time between the
+  // last two states.  Only the integrators that have dense output call it.
+  std::function<void(typename ODE::DenseState const& dense_state)>
+      append_dense_state;
+  // The events to locate during the integration, for the integrators that
+  // have dense output.  The occurrences of the events in a step are located
+  // on its dense output and reported in chronological order after the call to
+  // |append_state| for the beginning of the step.  If an occurrence of a
+  // terminal event is found, the last call to |append_state| is with the state
+  // at the first such occurrence, and no later occurrence is reported.
+  std::vector<typename ODE::Event> events;
 };
 
 // Settings for for adaptive step size integration.
@@ -80,6 +151,16 @@ struct AdaptiveStepSize {
   // In both cases, the new step size is chosen so as to try and make the result
   // of the next call to |tolerance_to_error_ratio| close to |safety_factor|.
   ToleranceToErrorRatio tolerance_to_error_ratio;
+  // The rule used to choose the new step size.
+  StepSizeController controller = kElementary;
+  // Bounds on the ratio of a new step size to the previous one.  They must
+  // satisfy 0 < |minimal_step_ratio| < 1 < |maximal_step_ratio|.  By default
+  // the step size is not limited.
+  double minimal_step_ratio = std::numeric_limits<double>::min();
+  double maximal_step_ratio = std::numeric_limits<double>::infinity();
+  // If not null, the counts of the work done by the integrator are added to
+  // |*statistics|.
+  AdaptiveStepSizeStatistics* statistics = nullptr;
 };
 
 // A base class for integrators.
@@ -93,6 +174,26 @@ class Integrator {
 template<typename DifferentialEquation>
 class FixedStepSizeIntegrator : public Integrator<DifferentialEquation> {
  public:
+  // An integration that may be resumed.  It owns the current state and the
+  // workspace of the integrator, so that advancing it doesn't copy the state
+  // nor allocate, except for the integrators that don't override |NewSession|.
+  class Session {
+   public:
+    virtual ~Session() = default;
+
+    // Performs steps as long as they don't go past |t|, calling
+    // |problem.append_state| after each of them.
+    virtual void AdvanceTo(Instant const& t) = 0;
+
+    // Performs exactly |n| steps, calling |problem.append_state| after each of
+    // them.
+    virtual void Step(int n) = 0;
+
+    // The state after the last step, or the initial state if no step was
+    // performed.
+    virtual typename DifferentialEquation::SystemState const& state() const = 0;
+  };
+
   // The last call to |problem.append_state| has a |state.time.value| equal to
   // the unique |Instant| of the form |problem.t_final + n * step| in
   // [problem.t_final, problem.t_final + step[.
@@ -100,6 +201,14 @@ class FixedStepSizeIntegrator : public Integrator<DifferentialEquation> {
   // intervals differing from |step| by at most one ULP.
   virtual void Solve(IntegrationProblem<ODE> const& problem,
                      Time const& step) const = 0;
+
+  // Returns a session that integrates |problem| with the given |step|, starting
+  // from a copy of |*problem.initial_state|.  |problem.t_final| is ignored.
+  // This object must outlive the session.  The default implementation calls
+  // |Solve| each time the session is advanced.
+  virtual not_null<std::unique_ptr<Session>> NewSession(
+      IntegrationProblem<ODE> const& problem,
+      Time const& step) const;
 };
 
 // An integrator using a fixed step size.
@@ -114,3 +223,5 @@ class AdaptiveStepSizeIntegrator : public Integrator<DifferentialEquation> {
 
 }  // namespace integrators
 }  // namespace principia
+
+#include "integrators/ordinary_differential_equations_body.hpp"
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "integrators/ordinary_differential_equations.hpp"
+
+#include <functional>
+#include <memory>
+
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+
+using base::make_not_null_unique;
+using geometry::Sign;
+
+namespace integrators {
+namespace internal {
+
+// The session used by the integrators that don't have one of their own: each
+// call to |AdvanceTo| is a call to |Solve| from the current state.
+template<typename ODE>
+class SolveSession : public FixedStepSizeIntegrator<ODE>::Session {
+ public:
+  SolveSession(FixedStepSizeIntegrator<ODE> const& integrator,
+               IntegrationProblem<ODE> const& problem,
+               Time const& step);
+
+  SolveSession(SolveSession const&) = delete;
+  SolveSession(SolveSession&&) = delete;
+  SolveSession& operator=(SolveSession const&) = delete;
+  SolveSession& operator=(SolveSession&&) = delete;
+
+  void AdvanceTo(Instant const& t) override;
+  void Step(int n) override;
+  typename ODE::SystemState const& state() const override;
+
+ private:
+  FixedStepSizeIntegrator<ODE> const& integrator_;
+  Time const step_;
+  typename ODE::SystemState state_;
+  std::function<void(typename ODE::SystemState const& state)> const
+      append_state_;
+  // A copy of the problem whose |initial_state| is |&state_| and whose
+  // |append_state| updates |state_|.
+  IntegrationProblem<ODE> problem_;
+};
+
+template<typename ODE>
+SolveSession<ODE>::SolveSession(FixedStepSizeIntegrator<ODE> const& integrator,
+                                IntegrationProblem<ODE> const& problem,
+                                Time const& step)
+    : integrator_(integrator),
+      step_(step),
+      state_(*CHECK_NOTNULL(problem.initial_state)),
+      append_state_(problem.append_state),
+      problem_(problem) {
+  CHECK_NE(Time(), step_);
+  problem_.initial_state = &state_;
+  problem_.append_state = [this](typename ODE::SystemState const& state) {
+    state_ = state;
+    append_state_(state_);
+  };
+}
+
+template<typename ODE>
+void SolveSession<ODE>::AdvanceTo(Instant const& t) {
+  Sign const integration_direction = Sign(step_);
+  Time const time_to_end = (t - state_.time.value) - state_.time.error;
+  // |Solve| requires that there be at least one step to perform.
+  if (integration_direction * step_ <= integration_direction * time_to_end) {
+    problem_.t_final = t;
+    integrator_.Solve(problem_, step_);
+  }
+}
+
+template<typename ODE>
+void SolveSession<ODE>::Step(int const n) {
+  CHECK_LE(0, n);
+  if (n > 0) {
+    // The steps stop at the last multiple of |step_| before the final time.
+    AdvanceTo(state_.time.value + (n + 0.5) * step_);
+  }
+}
+
+template<typename ODE>
+typename ODE::SystemState const& SolveSession<ODE>::state() const {
+  return state_;
+}
+
+}  // namespace internal
+
+template<typename DifferentialEquation>
+not_null<std::unique_ptr<
+    typename FixedStepSizeIntegrator<DifferentialEquation>::Session>>
+FixedStepSizeIntegrator<DifferentialEquation>::NewSession(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  return make_not_null_unique<internal::SolveSession<DifferentialEquation>>(
+      *this, problem, step);
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+
+namespace principia {
+
+using base::ThreadPool;
+
+namespace integrators {
+
+// This class solves ordinary differential equations of the form q″ = f(q, t)
+// by the Parareal algorithm of Lions, Maday and Turinici (2001), Résolution
+// d'EDP par un schéma en temps « pararéel », which parallelizes the
+// integration in time.  The integration is cut in windows of
+// |number_of_slices| slices of |steps_per_slice| steps.  In each window, a
+// cheap |coarse_integrator|, with |coarse_steps_per_slice| steps per slice,
+// gives a first approximation of the states at the beginning of the slices.
+// The slices are then integrated concurrently with the |fine_integrator|,
+// starting from these approximations, and the approximations are corrected by
+// the coarse integrator:
+//   Uₙ₊₁ᵏ⁺¹ = G(Uₙᵏ⁺¹) + F(Uₙᵏ) - G(Uₙᵏ),
+// where F and G are the fine and coarse integrations over one slice.  The
+// iteration stops when, at the boundary of each slice, the fine solution of the
+// previous slice is within tolerance of the state at the beginning of the
+// slice, i.e., when |tolerance_to_error_ratio|, called with the duration of a
+// slice and the discontinuity, returns at least 1 for all the slices.  The
+// fine solutions of the slices are then passed to |problem.append_state|, in
+// order.  After k iterations, the first k slices are exactly the serial fine
+// solution, so the iteration terminates after at most |number_of_slices|
+// iterations; if the fine integrator doesn't reuse evaluations from one step to
+// the next, the solution is then bitwise identical to that of |Solve| for the
+// |fine_integrator|.  The steps that don't fill a window at the end of the
+// integration are performed serially by the |fine_integrator|.
+//
+// The slices are integrated by the threads of the |thread_pool|, or serially if
+// it is null.  Their accelerations are computed by
+// |slice_compute_acceleration|, which must therefore be safe to call
+// concurrently; if it is empty, |problem.equation.compute_acceleration| is used
+// and must be safe to call concurrently.  The coarse integrations and the
+// steps that don't fill a window always use |problem.equation|.
+template<typename Position>
+class PararealIntegrator
+    : public FixedStepSizeIntegrator<
+                 SpecialSecondOrderDifferentialEquation<Position>> {
+ public:
+  using ODE = SpecialSecondOrderDifferentialEquation<Position>;
+  using ToleranceToErrorRatio =
+      typename AdaptiveStepSize<ODE>::ToleranceToErrorRatio;
+
+  // The integrators and the |thread_pool| must outlive this object.
+  // |steps_per_slice| must be a multiple of |coarse_steps_per_slice|.
+  PararealIntegrator(FixedStepSizeIntegrator<ODE> const& fine_integrator,
+                     FixedStepSizeIntegrator<ODE> const& coarse_integrator,
+                     int const number_of_slices,
+                     int const steps_per_slice,
+                     int const coarse_steps_per_slice,
+                     ToleranceToErrorRatio tolerance_to_error_ratio,
+                     ThreadPool<void>* const thread_pool,
+                     typename ODE::RightHandSideComputation
+                         slice_compute_acceleration);
+
+  PararealIntegrator(PararealIntegrator const&) = delete;
+  PararealIntegrator(PararealIntegrator&&) = delete;
+  PararealIntegrator& operator=(PararealIntegrator const&) = delete;
+  PararealIntegrator& operator=(PararealIntegrator&&) = delete;
+
+  void Solve(IntegrationProblem<ODE> const& problem,
+             Time const& step) const override;
+
+ private:
+  // Integrates one window of |number_of_slices_| slices from |*state|, and
+  // sets |*state| to the state at its end.
+  void SolveWindow(IntegrationProblem<ODE> const& problem,
+                   Time const& step,
+                   not_null<typename ODE::SystemState*> const state) const;
+
+  // Integrates |steps| steps of size |step| of the |equation| from
+  // |initial_state| with the |integrator|, and returns the final state.  If
+  // |states| is not null, the states after each step are appended to it.
+  typename ODE::SystemState Propagate(
+      FixedStepSizeIntegrator<ODE> const& integrator,
+      ODE const& equation,
+      typename ODE::SystemState const& initial_state,
+      Time const& step,
+      int const steps,
+      std::vector<typename ODE::SystemState>* const states) const;
+
+  FixedStepSizeIntegrator<ODE> const& fine_integrator_;
+  FixedStepSizeIntegrator<ODE> const& coarse_integrator_;
+  int const number_of_slices_;
+  int const steps_per_slice_;
+  int const coarse_steps_per_slice_;
+  ToleranceToErrorRatio const tolerance_to_error_ratio_;
+  ThreadPool<void>* const thread_pool_;
+  typename ODE::RightHandSideComputation const slice_compute_acceleration_;
+};
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/parareal_integrator_body.hpp"
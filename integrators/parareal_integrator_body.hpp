@@ -0,0 +1,249 @@
+#pragma once
+
+#include "integrators/parareal_integrator.hpp"
+
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+
+namespace principia {
+
+using geometry::Sign;
+
+namespace integrators {
+
+template<typename Position>
+PararealIntegrator<Position>::PararealIntegrator(
+    FixedStepSizeIntegrator<ODE> const& fine_integrator,
+    FixedStepSizeIntegrator<ODE> const& coarse_integrator,
+    int const number_of_slices,
+    int const steps_per_slice,
+    int const coarse_steps_per_slice,
+    ToleranceToErrorRatio tolerance_to_error_ratio,
+    ThreadPool<void>* const thread_pool,
+    typename ODE::RightHandSideComputation slice_compute_acceleration)
+    : fine_integrator_(fine_integrator),
+      coarse_integrator_(coarse_integrator),
+      number_of_slices_(number_of_slices),
+      steps_per_slice_(steps_per_slice),
+      coarse_steps_per_slice_(coarse_steps_per_slice),
+      tolerance_to_error_ratio_(std::move(tolerance_to_error_ratio)),
+      thread_pool_(thread_pool),
+      slice_compute_acceleration_(std::move(slice_compute_acceleration)) {
+  CHECK_LE(1, number_of_slices_);
+  CHECK_LE(1, steps_per_slice_);
+  CHECK_LE(1, coarse_steps_per_slice_);
+  CHECK_EQ(0, steps_per_slice_ % coarse_steps_per_slice_);
+}
+
+template<typename Position>
+void PararealIntegrator<Position>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  // Argument checks.
+  CHECK_NOTNULL(problem.initial_state);
+  int const dimension = problem.initial_state->positions.size();
+  CHECK_EQ(dimension, problem.initial_state->velocities.size());
+  CHECK_NE(Time(), step);
+  Sign const integration_direction = Sign(step);
+  if (integration_direction.Positive()) {
+    // Integrating forward.
+    CHECK_LT(problem.initial_state->time.value, problem.t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(problem.initial_state->time.value, problem.t_final);
+  }
+
+  typename ODE::SystemState state = *problem.initial_state;
+  int const window_steps = number_of_slices_ * steps_per_slice_;
+  for (;;) {
+    // Termination condition.  A window must end half a step before
+    // |problem.t_final|, so that it never goes past it because of rounding.
+    Time const time_to_end =
+        (problem.t_final - state.time.value) - state.time.error;
+    if (integration_direction * ((window_steps + 0.5) * step) >
+        integration_direction * time_to_end) {
+      break;
+    }
+    SolveWindow(problem, step, &state);
+  }
+
+  // The steps that don't fill a window.
+  Time const time_to_end =
+      (problem.t_final - state.time.value) - state.time.error;
+  if (integration_direction * step <= integration_direction * time_to_end) {
+    IntegrationProblem<ODE> remainder_problem = problem;
+    remainder_problem.initial_state = &state;
+    fine_integrator_.Solve(remainder_problem, step);
+  }
+}
+
+template<typename Position>
+void PararealIntegrator<Position>::SolveWindow(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step,
+    not_null<typename ODE::SystemState*> const state) const {
+  using SystemState = typename ODE::SystemState;
+  int const slices = number_of_slices_;
+  int const dimension = state->positions.size();
+  Time const slice_duration = steps_per_slice_ * step;
+  Time const coarse_step =
+      (steps_per_slice_ / coarse_steps_per_slice_) * step;
+
+  // The times of the beginning of the slices, accumulated as the fine
+  // integrator does, so that the approximate states are on its grid.
+  std::vector<DoublePrecision<Instant>> start_times(slices);
+  start_times[0] = state->time;
+  for (int n = 1; n < slices; ++n) {
+    start_times[n] = start_times[n - 1];
+    for (int i = 0; i < steps_per_slice_; ++i) {
+      start_times[n].Increment(step);
+    }
+  }
+
+  // |starts[n]| is the current approximation of the state at the beginning of
+  // slice n, and |coarse_ends[n]| is the coarse solution of slice n from it.
+  // |fine_ends[n]| and |fine_states[n]| are the fine solution of slice n from
+  // the previous approximation.
+  std::vector<SystemState> starts(slices);
+  std::vector<SystemState> coarse_ends(slices);
+  std::vector<SystemState> fine_ends(slices);
+  std::vector<std::vector<SystemState>> fine_states(slices);
+
+  // The equation integrated concurrently by the fine integrator.
+  ODE slice_equation = problem.equation;
+  if (slice_compute_acceleration_) {
+    slice_equation.compute_acceleration = slice_compute_acceleration_;
+  }
+
+  // The first approximation is the coarse solution.
+  starts[0] = *state;
+  for (int n = 0; n + 1 < slices; ++n) {
+    coarse_ends[n] = Propagate(coarse_integrator_,
+                               problem.equation,
+                               starts[n],
+                               coarse_step,
+                               coarse_steps_per_slice_,
+                               nullptr /*states*/);
+    starts[n + 1] = coarse_ends[n];
+    starts[n + 1].time = start_times[n + 1];
+  }
+
+  auto const integrate_fine_slice = [this, &fine_ends, &fine_states,
+                                     &slice_equation, &starts,
+                                     step](int const n) {
+    fine_states[n].clear();
+    fine_states[n].reserve(steps_per_slice_);
+    fine_ends[n] = Propagate(fine_integrator_,
+                             slice_equation,
+                             starts[n],
+                             step,
+                             steps_per_slice_,
+                             &fine_states[n]);
+  };
+
+  typename ODE::SystemStateError discontinuity;
+  discontinuity.position_error.resize(dimension);
+  discontinuity.velocity_error.resize(dimension);
+
+  // At iteration k, the slices before k are converged, and slice k starts from
+  // an exact state.
+  for (int k = 0;; ++k) {
+    if (thread_pool_ == nullptr) {
+      for (int n = k; n < slices; ++n) {
+        integrate_fine_slice(n);
+      }
+    } else {
+      std::vector<std::future<void>> futures;
+      futures.reserve(slices - k);
+      for (int n = k; n < slices; ++n) {
+        futures.push_back(thread_pool_->Add([&integrate_fine_slice, n]() {
+          integrate_fine_slice(n);
+        }));
+      }
+      for (auto& future : futures) {
+        future.get();
+      }
+    }
+
+    bool converged = true;
+    for (int n = k + 1; converged && n < slices; ++n) {
+      for (int i = 0; i < dimension; ++i) {
+        discontinuity.position_error[i] =
+            fine_ends[n - 1].positions[i].value - starts[n].positions[i].value;
+        discontinuity.velocity_error[i] =
+            fine_ends[n - 1].velocities[i].value -
+            starts[n].velocities[i].value;
+      }
+      converged = tolerance_to_error_ratio_(slice_duration, discontinuity) >=
+                  1.0;
+    }
+    if (converged) {
+      break;
+    }
+
+    // Correct the approximations of the slices after k.  The fine solution of
+    // slice k is exact.
+    starts[k + 1] = fine_ends[k];
+    for (int n = k + 1; n + 1 < slices; ++n) {
+      SystemState const coarse_end = Propagate(coarse_integrator_,
+                                               problem.equation,
+                                               starts[n],
+                                               coarse_step,
+                                               coarse_steps_per_slice_,
+                                               nullptr /*states*/);
+      SystemState& start = starts[n + 1];
+      for (int i = 0; i < dimension; ++i) {
+        start.positions[i] =
+            coarse_end.positions[i].value +
+            (fine_ends[n].positions[i].value -
+             coarse_ends[n].positions[i].value);
+        start.velocities[i] =
+            coarse_end.velocities[i].value +
+            (fine_ends[n].velocities[i].value -
+             coarse_ends[n].velocities[i].value);
+      }
+      start.time = start_times[n + 1];
+      coarse_ends[n] = coarse_end;
+    }
+  }
+
+  for (auto const& slice_states : fine_states) {
+    for (auto const& slice_state : slice_states) {
+      problem.append_state(slice_state);
+    }
+  }
+  *state = fine_ends.back();
+}
+
+template<typename Position>
+typename SpecialSecondOrderDifferentialEquation<Position>::SystemState
+PararealIntegrator<Position>::Propagate(
+    FixedStepSizeIntegrator<ODE> const& integrator,
+    ODE const& equation,
+    typename ODE::SystemState const& initial_state,
+    Time const& step,
+    int const steps,
+    std::vector<typename ODE::SystemState>* const states) const {
+  IntegrationProblem<ODE> slice_problem;
+  slice_problem.equation = equation;
+  slice_problem.initial_state = &initial_state;
+  if (states == nullptr) {
+    slice_problem.append_state = [](typename ODE::SystemState const&) {};
+  } else {
+    slice_problem.append_state =
+        [states](typename ODE::SystemState const& state) {
+          states->push_back(state);
+        };
+  }
+  auto const session = integrator.NewSession(slice_problem, step);
+  session->Step(steps);
+  return session->state();
+}
+
+}  // namespace integrators
+}  // namespace principia
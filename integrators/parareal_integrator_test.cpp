@@ -0,0 +1,201 @@
+#include "integrators/parareal_integrator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/thread_pool.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using quantities::Abs;
+using quantities::Acceleration;
+using quantities::Length;
+using quantities::Mass;
+using quantities::SIUnit;
+using quantities::Speed;
+using quantities::Stiffness;
+using quantities::Time;
+using si::Metre;
+using si::Milli;
+using si::Second;
+using testing_utilities::AbsoluteError;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::testing::Eq;
+using ::testing::Lt;
+
+namespace integrators {
+
+using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+
+namespace {
+
+double HarmonicOscillatorToleranceRatio(
+    Time const& h,
+    ODE::SystemStateError const& error,
+    Length const& q_tolerance,
+    Speed const& v_tolerance) {
+  return std::min(q_tolerance / Abs(error.position_error[0]),
+                  v_tolerance / Abs(error.velocity_error[0]));
+}
+
+}  // namespace
+
+class PararealIntegratorTest : public ::testing::Test {
+ protected:
+  PararealIntegratorTest() : pool_(4) {
+    harmonic_oscillator_.compute_acceleration =
+        [this](Instant const& t,
+               std::vector<Length> const& q,
+               not_null<std::vector<Acceleration>*> const result) {
+          (*result)[0] = -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+          ++evaluations_;
+        };
+  }
+
+  // Integrates the harmonic oscillator over |duration_| with the given
+  // |integrator| and returns the states.
+  std::vector<ODE::SystemState> Solve(
+      FixedStepSizeIntegrator<ODE> const& integrator) {
+    std::vector<ODE::SystemState> solution;
+    IntegrationProblem<ODE> problem;
+    problem.equation = harmonic_oscillator_;
+    problem.initial_state = &initial_state_;
+    problem.t_final = t_initial_ + duration_;
+    problem.append_state = [&solution](ODE::SystemState const& state) {
+      solution.push_back(state);
+    };
+    evaluations_ = 0;
+    integrator.Solve(problem, step_);
+    return solution;
+  }
+
+  // 8 slices of 100 steps, with 2 coarse steps per slice, so that the 2000
+  // steps of the integration are 2 windows and 400 steps done serially.
+  std::unique_ptr<PararealIntegrator<Length>> NewPararealIntegrator(
+      Length const& length_tolerance,
+      Speed const& speed_tolerance,
+      ThreadPool<void>* const thread_pool,
+      ODE::RightHandSideComputation slice_compute_acceleration = nullptr) {
+    return std::make_unique<PararealIntegrator<Length>>(
+        McLachlanAtela1992Order5Optimal<Length>(),
+        McLachlanAtela1992Order4Optimal<Length>(),
+        8 /*number_of_slices*/,
+        100 /*steps_per_slice*/,
+        2 /*coarse_steps_per_slice*/,
+        std::bind(HarmonicOscillatorToleranceRatio,
+                  _1, _2, length_tolerance, speed_tolerance),
+        thread_pool,
+        std::move(slice_compute_acceleration));
+  }
+
+  Instant const t_initial_;
+  Time const step_ = 10 * Milli(Second);
+  Time const duration_ = 20 * Second;
+  ODE::SystemState const initial_state_ =
+      {{1 * Metre}, {0 * Metre / Second}, t_initial_};
+
+  ThreadPool<void> pool_;
+  ODE harmonic_oscillator_;
+  std::atomic<int> evaluations_;
+  std::atomic<int> slice_evaluations_;
+};
+
+// With a zero tolerance, the iteration only stops when all the slices are
+// exact, and the fine integrator doesn't reuse evaluations, so the solution is
+// that of the fine integrator.
+TEST_F(PararealIntegratorTest, ZeroTolerance) {
+  std::vector<ODE::SystemState> const fine_solution =
+      Solve(McLachlanAtela1992Order5Optimal<Length>());
+  int const fine_evaluations = evaluations_;
+  for (ThreadPool<void>* const thread_pool :
+           std::vector<ThreadPool<void>*>{&pool_, nullptr}) {
+    auto const parareal = NewPararealIntegrator(
+        0 * Metre, 0 * Metre / Second, thread_pool);
+    std::vector<ODE::SystemState> const solution = Solve(*parareal);
+    ASSERT_THAT(solution.size(), Eq(fine_solution.size()));
+    for (int i = 0; i < solution.size(); ++i) {
+      EXPECT_THAT(solution[i].time.value, Eq(fine_solution[i].time.value));
+      EXPECT_THAT(solution[i].positions[0].value,
+                  Eq(fine_solution[i].positions[0].value));
+      EXPECT_THAT(solution[i].velocities[0].value,
+                  Eq(fine_solution[i].velocities[0].value));
+    }
+    // Slice k is integrated 8 - k times.
+    EXPECT_THAT(fine_evaluations, Lt(evaluations_.load()));
+  }
+}
+
+// With a reasonable tolerance, the iteration stops early, and the solution is
+// close to that of the fine integrator.
+TEST_F(PararealIntegratorTest, Convergence) {
+  std::vector<ODE::SystemState> const fine_solution =
+      Solve(McLachlanAtela1992Order5Optimal<Length>());
+  int const fine_evaluations = evaluations_;
+
+  auto const exact = NewPararealIntegrator(
+      0 * Metre, 0 * Metre / Second, &pool_);
+  Solve(*exact);
+  int const exact_evaluations = evaluations_;
+
+  auto const parareal = NewPararealIntegrator(
+      1E-9 * Metre, 1E-9 * Metre / Second, &pool_);
+  std::vector<ODE::SystemState> const solution = Solve(*parareal);
+  ASSERT_THAT(solution.size(), Eq(fine_solution.size()));
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_THAT(solution[i].time.value, Eq(fine_solution[i].time.value));
+    EXPECT_THAT(AbsoluteError(fine_solution[i].positions[0].value,
+                              solution[i].positions[0].value),
+                Lt(1E-7 * Metre));
+    EXPECT_THAT(AbsoluteError(fine_solution[i].velocities[0].value,
+                              solution[i].velocities[0].value),
+                Lt(1E-7 * Metre / Second));
+  }
+  EXPECT_THAT(evaluations_.load(), Lt(exact_evaluations));
+  // Even with the coarse integrations, the work is at most a few times that of
+  // the serial integration, and it is shared by the threads.
+  EXPECT_THAT(evaluations_.load(), Lt(4 * fine_evaluations));
+}
+
+// The fine integrations of the slices use the slice equation, while the coarse
+// integrations and the steps done serially use the equation of the problem.
+TEST_F(PararealIntegratorTest, SliceEquation) {
+  std::vector<ODE::SystemState> const fine_solution =
+      Solve(McLachlanAtela1992Order5Optimal<Length>());
+  int const fine_evaluations = evaluations_;
+
+  auto const parareal = NewPararealIntegrator(
+      0 * Metre,
+      0 * Metre / Second,
+      &pool_,
+      [this](Instant const& t,
+             std::vector<Length> const& q,
+             not_null<std::vector<Acceleration>*> const result) {
+        (*result)[0] = -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+        ++slice_evaluations_;
+      });
+  slice_evaluations_ = 0;
+  std::vector<ODE::SystemState> const solution = Solve(*parareal);
+  ASSERT_THAT(solution.size(), Eq(fine_solution.size()));
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_THAT(solution[i].positions[0].value,
+                Eq(fine_solution[i].positions[0].value));
+    EXPECT_THAT(solution[i].velocities[0].value,
+                Eq(fine_solution[i].velocities[0].value));
+  }
+  // The 400 serial steps are a fifth of the fine integration, and the coarse
+  // integrations are cheap.
+  EXPECT_THAT(evaluations_.load(), Lt(fine_evaluations / 2));
+  EXPECT_THAT(fine_evaluations, Lt(slice_evaluations_.load()));
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+
+using base::not_null;
+using geometry::Instant;
+using quantities::Difference;
+using quantities::Time;
+using quantities::Variation;
+
+namespace integrators {
+
+// The solution of a differential equation of the form q″ = f(q, t) over a step
+// [t₀, t₁], interpolated by the quintic Hermite polynomials determined by
+// the positions, velocities and accelerations at both ends of the step.  The
+// interpolation error is O(h⁶), and it doesn't require evaluations of f beyond
+// those at the ends of the step.
+template<typename Position>
+class QuinticHermiteInterpolant {
+ public:
+  using Displacement = Difference<Position>;
+  using Velocity = Variation<Position>;
+  using Acceleration = Variation<Velocity>;
+
+  // |Δq| is the displacement from the initial to the final positions.  |t1| is
+  // the time of the final state as accumulated by the integrator, so that
+  // |t_max()| is exactly that time.
+  QuinticHermiteInterpolant(Instant const& t0,
+                            Instant const& t1,
+                            std::vector<Position> const& q0,
+                            std::vector<Velocity> const& v0,
+                            std::vector<Acceleration> const& a0,
+                            std::vector<Displacement> const& Δq,
+                            std::vector<Velocity> const& v1,
+                            std::vector<Acceleration> const& a1);
+
+  // The ends of the step.  |t_max()| is before |t_min()| when integrating
+  // backward.
+  Instant const& t_min() const;
+  Instant const& t_max() const;
+
+  // Evaluates the interpolation at |t|, which must be between |t_min()| and
+  // |t_max()|.  |positions| and |velocities| are resized as needed.
+  void Evaluate(Instant const& t,
+                not_null<std::vector<Position>*> const positions,
+                not_null<std::vector<Velocity>*> const velocities) const;
+
+ private:
+  Instant const t0_;
+  Instant const t1_;
+  Time const h_;
+  std::vector<Position> const q0_;
+  // The polynomials are |q0_[k] + Σ coefficients_[k][j] sʲ⁺¹|, where
+  // s = (t - t0_) / h_.
+  std::vector<std::array<Displacement, 5>> coefficients_;
+};
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/quintic_hermite_interpolant_body.hpp"
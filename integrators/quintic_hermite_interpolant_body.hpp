@@ -0,0 +1,88 @@
+#pragma once
+
+#include "integrators/quintic_hermite_interpolant.hpp"
+
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace integrators {
+
+template<typename Position>
+QuinticHermiteInterpolant<Position>::QuinticHermiteInterpolant(
+    Instant const& t0,
+    Instant const& t1,
+    std::vector<Position> const& q0,
+    std::vector<Velocity> const& v0,
+    std::vector<Acceleration> const& a0,
+    std::vector<Displacement> const& Δq,
+    std::vector<Velocity> const& v1,
+    std::vector<Acceleration> const& a1)
+    : t0_(t0),
+      t1_(t1),
+      h_(t1 - t0),
+      q0_(q0),
+      coefficients_(q0.size()) {
+  CHECK_NE(Time(), h_);
+  int const dimension = q0_.size();
+  CHECK_EQ(dimension, v0.size());
+  CHECK_EQ(dimension, a0.size());
+  CHECK_EQ(dimension, Δq.size());
+  CHECK_EQ(dimension, v1.size());
+  CHECK_EQ(dimension, a1.size());
+  for (int k = 0; k < dimension; ++k) {
+    Displacement const v0_h = v0[k] * h_;
+    Displacement const v1_h = v1[k] * h_;
+    Displacement const a0_h_squared = a0[k] * h_ * h_;
+    Displacement const a1_h_squared = a1[k] * h_ * h_;
+    std::array<Displacement, 5>& c = coefficients_[k];
+    c[0] = v0_h;
+    c[1] = 0.5 * a0_h_squared;
+    c[2] = 10 * Δq[k] - 6 * v0_h - 4 * v1_h -
+           1.5 * a0_h_squared + 0.5 * a1_h_squared;
+    c[3] = -15 * Δq[k] + 8 * v0_h + 7 * v1_h +
+           1.5 * a0_h_squared - a1_h_squared;
+    c[4] = 6 * Δq[k] - 3 * v0_h - 3 * v1_h -
+           0.5 * a0_h_squared + 0.5 * a1_h_squared;
+  }
+}
+
+template<typename Position>
+Instant const& QuinticHermiteInterpolant<Position>::t_min() const {
+  return t0_;
+}
+
+template<typename Position>
+Instant const& QuinticHermiteInterpolant<Position>::t_max() const {
+  return t1_;
+}
+
+template<typename Position>
+void QuinticHermiteInterpolant<Position>::Evaluate(
+    Instant const& t,
+    not_null<std::vector<Position>*> const positions,
+    not_null<std::vector<Velocity>*> const velocities) const {
+  double const s = (t - t0_) / h_;
+  // Allow for some rounding in the computation of |t| by the caller.
+  DCHECK_LE(-1E-12, s);
+  DCHECK_LE(s, 1 + 1E-12);
+  int const dimension = q0_.size();
+  positions->resize(dimension);
+  velocities->resize(dimension);
+  for (int k = 0; k < dimension; ++k) {
+    std::array<Displacement, 5> const& c = coefficients_[k];
+    // Horner's scheme.
+    Displacement q = c[4];
+    Displacement v_h = 5 * c[4];
+    for (int j = 3; j >= 0; --j) {
+      q = q * s + c[j];
+      v_h = v_h * s + (j + 1) * c[j];
+    }
+    (*positions)[k] = q0_[k] + q * s;
+    (*velocities)[k] = v_h / h_;
+  }
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <memory>
+
+#include "base/not_null.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "numerics/fixed_arrays.hpp"
+
+namespace principia {
+
+using base::not_null;
+using numerics::FixedVector;
+
+namespace integrators {
+
+// This class solves ordinary differential equations of the form q″ = f(q, t)
+// using a symmetric linear multistep method
+//   α₀ qₙ + α₁ qₙ₊₁ + ... + αₖ qₙ₊ₖ = h² (β₀ fₙ + β₁ fₙ₊₁ + ... + βₖ fₙ₊ₖ),
+// where k is the |order| of the method, αⱼ = αₖ₋ⱼ, βⱼ = βₖ₋ⱼ, αₖ = 1 and
+// βₖ = 0.  Such a method is explicit, costs a single evaluation of f per step,
+// and, while not symplectic, has no secular drift of the energy for
+// sufficiently small steps, which makes it suitable for long integrations of
+// the planets.  See Quinlan and Tremaine (1990), Symmetric multistep methods
+// for the numerical integration of planetary orbits.
+//
+// The k - 1 states following the initial state are computed by the
+// |startup_integrator| with a step of h / |startup_step_divisor|, so each call
+// to |Solve| pays for a startup: the method is only worthwhile when |Solve|
+// covers many steps.  A session returned by |NewSession| pays for the startup
+// only once, since it keeps the positions and accelerations of the last k
+// steps across calls to |AdvanceTo| and |Step|.
+//
+// The velocities don't take part in the integration.  They are computed from
+// the positions and the accelerations at the previous steps by a formula
+//   vₙ = (qₙ - qₙ₋₁) / h + h (γ₀ fₙ + γ₁ fₙ₋₁ + ... + γₖ₋₁ fₙ₋ₖ₊₁)
+// which is exact for polynomials of degree k + 1.
+template<typename Position, int order_>
+class SymmetricLinearMultistepIntegrator
+    : public FixedStepSizeIntegrator<
+                 SpecialSecondOrderDifferentialEquation<Position>> {
+ public:
+  using Session =
+      typename FixedStepSizeIntegrator<
+          SpecialSecondOrderDifferentialEquation<Position>>::Session;
+
+  // The coefficients βⱼ are |β_numerators[j] / β_denominator|, and likewise
+  // for the γⱼ.
+  SymmetricLinearMultistepIntegrator(
+      FixedStepSizeIntegrator<ODE> const& startup_integrator,
+      FixedVector<double, order_ + 1> const& α,
+      FixedVector<double, order_ + 1> const& β_numerators,
+      double const β_denominator,
+      FixedVector<double, order_> const& γ_numerators,
+      double const γ_denominator);
+
+  void Solve(IntegrationProblem<ODE> const& problem,
+             Time const& step) const override;
+
+  not_null<std::unique_ptr<Session>> NewSession(
+      IntegrationProblem<ODE> const& problem,
+      Time const& step) const override;
+
+  static int const order = order_;
+  static int const evaluations = 1;
+  static int const startup_step_divisor = 16;
+
+ private:
+  class ResumableSession;
+
+  FixedStepSizeIntegrator<ODE> const& startup_integrator_;
+  FixedVector<double, order_ + 1> α_;
+  FixedVector<double, order_ + 1> β_;
+  FixedVector<double, order_> γ_;
+};
+
+// Coefficients from Quinlan and Tremaine (1990), Symmetric multistep methods
+// for the numerical integration of planetary orbits, table 1.  The startup
+// uses |BlanesMoan2002SRKN14A|.
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 8> const&
+QuinlanTremaine1990Order8();
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 10> const&
+QuinlanTremaine1990Order10();
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 12> const&
+QuinlanTremaine1990Order12();
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/symmetric_linear_multistep_integrator_body.hpp"
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+
+namespace principia {
+
+using base::make_not_null_unique;
+using geometry::Sign;
+
+namespace integrators {
+
+template<typename Position, int order_>
+SymmetricLinearMultistepIntegrator<Position, order_>::
+SymmetricLinearMultistepIntegrator(
+    FixedStepSizeIntegrator<ODE> const& startup_integrator,
+    FixedVector<double, order_ + 1> const& α,
+    FixedVector<double, order_ + 1> const& β_numerators,
+    double const β_denominator,
+    FixedVector<double, order_> const& γ_numerators,
+    double const γ_denominator)
+    : startup_integrator_(startup_integrator),
+      α_(α) {
+  CHECK_EQ(1.0, α_[order_]);
+  CHECK_EQ(0.0, β_numerators[0]);
+  CHECK_EQ(0.0, β_numerators[order_]);
+  double sum_of_α = 0.0;
+  for (int j = 0; j <= order_; ++j) {
+    CHECK_EQ(α_[j], α_[order_ - j]);
+    CHECK_EQ(β_numerators[j], β_numerators[order_ - j]);
+    sum_of_α += α_[j];
+    β_[j] = β_numerators[j] / β_denominator;
+  }
+  CHECK_EQ(0.0, sum_of_α);
+  for (int j = 0; j < order_; ++j) {
+    γ_[j] = γ_numerators[j] / γ_denominator;
+  }
+}
+
+template<typename Position, int order_>
+class SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession
+    : public Session {
+ public:
+  ResumableSession(SymmetricLinearMultistepIntegrator const& integrator,
+                   IntegrationProblem<ODE> const& problem,
+                   Time const& step);
+
+  ResumableSession(ResumableSession const&) = delete;
+  ResumableSession(ResumableSession&&) = delete;
+  ResumableSession& operator=(ResumableSession const&) = delete;
+  ResumableSession& operator=(ResumableSession&&) = delete;
+
+  void AdvanceTo(Instant const& t) override;
+  void Step(int n) override;
+  typename ODE::SystemState const& state() const override;
+
+ private:
+  using Displacement = typename ODE::Displacement;
+  using Velocity = typename ODE::Velocity;
+  using Acceleration = typename ODE::Acceleration;
+
+  // The positions and accelerations at a step.
+  struct PastStep {
+    std::vector<DoublePrecision<Position>> positions;
+    std::vector<Acceleration> accelerations;
+  };
+
+  // Performs one step, with the startup integrator if fewer than |order_|
+  // steps are known, and calls |append_state_|.
+  void PerformStep();
+  void PerformStartupStep();
+  void PerformMultistep();
+
+  // Appends the current positions and the accelerations there to |history_|.
+  // Only used during startup, while fewer than |order_| steps are known.
+  void PushStep();
+
+  // The |j|th of the known steps, oldest first.
+  PastStep& history(int const j);
+
+  SymmetricLinearMultistepIntegrator const& integrator_;
+  // Held by value, so that a session returned by |NewSession| doesn't depend on
+  // the lifetime of the problem.
+  ODE const equation_;
+  std::function<void(typename ODE::SystemState const& state)> const
+      append_state_;
+  // Time step.
+  Time const h_;
+  Sign const integration_direction_;
+
+  typename ODE::SystemState current_state_;
+  // The positions and accelerations at the last |order_| steps, in a ring
+  // buffer whose oldest entry is at |head_|, so that the multistep doesn't
+  // allocate.  |known_steps_| is 0 until the first step, when the
+  // accelerations at the initial state are computed.
+  std::vector<PastStep> history_;
+  int head_ = 0;
+  int known_steps_ = 0;
+  // The values of the positions passed to |equation_.compute_acceleration|.
+  std::vector<Position> q_values_;
+  // Position increment.
+  std::vector<Displacement> Δq_;
+};
+
+template<typename Position, int order_>
+SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+ResumableSession(SymmetricLinearMultistepIntegrator const& integrator,
+                 IntegrationProblem<ODE> const& problem,
+                 Time const& step)
+    : integrator_(integrator),
+      equation_(problem.equation),
+      append_state_(problem.append_state),
+      h_(step),
+      integration_direction_(step),
+      current_state_(*CHECK_NOTNULL(problem.initial_state)),
+      history_(order_),
+      q_values_(current_state_.positions.size()),
+      Δq_(current_state_.positions.size()) {
+  int const dimension = current_state_.positions.size();
+  CHECK_EQ(dimension, current_state_.velocities.size());
+  CHECK_NE(Time(), h_);
+  for (PastStep& step : history_) {
+    step.positions.resize(dimension);
+    step.accelerations.resize(dimension);
+  }
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+AdvanceTo(Instant const& t) {
+  DoublePrecision<Instant> const& current_time = current_state_.time;
+  for (;;) {
+    // Termination condition.
+    Time const time_to_end = (t - current_time.value) - current_time.error;
+    if (integration_direction_ * h_ > integration_direction_ * time_to_end) {
+      return;
+    }
+    PerformStep();
+  }
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+Step(int const n) {
+  CHECK_LE(0, n);
+  for (int i = 0; i < n; ++i) {
+    PerformStep();
+  }
+}
+
+template<typename Position, int order_>
+typename SpecialSecondOrderDifferentialEquation<Position>::SystemState const&
+SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+state() const {
+  return current_state_;
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+PerformStep() {
+  if (known_steps_ == 0) {
+    PushStep();
+  }
+  if (known_steps_ < order_) {
+    PerformStartupStep();
+  } else {
+    PerformMultistep();
+  }
+  append_state_(current_state_);
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+PerformStartupStep() {
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state_.time;
+
+  // We run the startup integrator for one of our steps, and only keep the
+  // state that falls on it.
+  Time const startup_step = h_ / startup_step_divisor;
+  DoublePrecision<Instant> t_next = t;
+  t_next.Increment(h_);
+  IntegrationProblem<ODE> startup_problem;
+  startup_problem.equation = equation_;
+  startup_problem.initial_state = &current_state_;
+  startup_problem.t_final = t_next.value + startup_step / 2;
+  int substeps = 0;
+  startup_problem.append_state = [this, &substeps, &t](
+      typename ODE::SystemState const& state) {
+    ++substeps;
+    if (substeps == startup_step_divisor) {
+      // Use our own time so that the steps are exactly those that we would
+      // take.
+      t.Increment(h_);
+      current_state_.positions = state.positions;
+      current_state_.velocities = state.velocities;
+      PushStep();
+    }
+  };
+  integrator_.startup_integrator_.Solve(startup_problem, startup_step);
+  CHECK_EQ(startup_step_divisor, substeps);
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+PerformMultistep() {
+  auto const& α = integrator_.α_;
+  auto const& β = integrator_.β_;
+  auto const& γ = integrator_.γ_;
+  Time const& h = h_;
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state_.time;
+  // Current position.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Position>>& q = current_state_.positions;
+  // Current velocity.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Velocity>>& v = current_state_.velocities;
+  int const dimension = q.size();
+
+  // qₙ₊₁ - qₙ = -Σ αⱼ (qₙ₊₁₋ₖ₊ⱼ - qₙ) + h² Σ βⱼ fₙ₊₁₋ₖ₊ⱼ, where the sums are
+  // over j < k and we have used Σ αⱼ = 0.  Computing the differences to qₙ
+  // limits the accumulation of rounding errors.
+  PastStep const& last_step = history(order_ - 1);
+  for (int k = 0; k < dimension; ++k) {
+    DoublePrecision<Position> const& q_last = last_step.positions[k];
+    Displacement Σα_q;
+    Acceleration Σβ_f;
+    for (int j = 0; j < order_; ++j) {
+      PastStep const& step_j = history(j);
+      DoublePrecision<Position> const& q_j = step_j.positions[k];
+      Σα_q += α[j] * ((q_j.value - q_last.value) + (q_j.error - q_last.error));
+      Σβ_f += β[j] * step_j.accelerations[k];
+    }
+    Δq_[k] = h * h * Σβ_f - Σα_q;
+  }
+
+  // Reuse the oldest step for the new one.
+  head_ = (head_ + 1) % order_;
+  PastStep& new_step = history(order_ - 1);
+  PastStep const& previous_step = history(order_ - 2);
+  t.Increment(h);
+  for (int k = 0; k < dimension; ++k) {
+    q[k] = previous_step.positions[k];
+    q[k].Increment(Δq_[k]);
+  }
+  new_step.positions = q;
+  for (int k = 0; k < dimension; ++k) {
+    q_values_[k] = q[k].value;
+  }
+  equation_.compute_acceleration(t.value, q_values_, &new_step.accelerations);
+
+  for (int k = 0; k < dimension; ++k) {
+    Acceleration Σγ_f;
+    for (int i = 0; i < order_; ++i) {
+      Σγ_f += γ[i] * history(order_ - 1 - i).accelerations[k];
+    }
+    v[k] = DoublePrecision<Velocity>(Δq_[k] / h + h * Σγ_f);
+  }
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+PushStep() {
+  std::vector<DoublePrecision<Position>> const& q = current_state_.positions;
+  int const dimension = q.size();
+  CHECK_LT(known_steps_, order_);
+  PastStep& step = history(known_steps_);
+  ++known_steps_;
+  step.positions = q;
+  for (int k = 0; k < dimension; ++k) {
+    q_values_[k] = q[k].value;
+  }
+  equation_.compute_acceleration(current_state_.time.value,
+                                 q_values_,
+                                 &step.accelerations);
+}
+
+template<typename Position, int order_>
+typename SymmetricLinearMultistepIntegrator<Position, order_>::
+    ResumableSession::PastStep&
+SymmetricLinearMultistepIntegrator<Position, order_>::ResumableSession::
+history(int const j) {
+  return history_[(head_ + j) % order_];
+}
+
+template<typename Position, int order_>
+void SymmetricLinearMultistepIntegrator<Position, order_>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  // Argument checks.
+  CHECK_NOTNULL(problem.initial_state);
+  int const dimension = problem.initial_state->positions.size();
+  CHECK_EQ(dimension, problem.initial_state->velocities.size());
+  CHECK_NE(Time(), step);
+  Sign const integration_direction = Sign(step);
+  if (integration_direction.Positive()) {
+    // Integrating forward.
+    CHECK_LT(problem.initial_state->time.value, problem.t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(problem.initial_state->time.value, problem.t_final);
+  }
+
+  ResumableSession session(*this, problem, step);
+  session.AdvanceTo(problem.t_final);
+}
+
+template<typename Position, int order_>
+not_null<std::unique_ptr<
+    typename SymmetricLinearMultistepIntegrator<Position, order_>::Session>>
+SymmetricLinearMultistepIntegrator<Position, order_>::NewSession(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  return make_not_null_unique<ResumableSession>(*this, problem, step);
+}
+
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 8> const&
+QuinlanTremaine1990Order8() {
+  static SymmetricLinearMultistepIntegrator<Position, 8> const integrator(
+      BlanesMoan2002SRKN14A<Position>(),
+      {1.0, -2.0, 2.0, -1.0, 0.0, -1.0, 2.0, -2.0, 1.0},
+      {0.0, 17671.0, -23622.0, 61449.0, -50516.0, 61449.0, -23622.0, 17671.0,
+       0.0},
+      12096.0,
+      {416173.0, 950684.0, -1025097.0, 1059430.0, -768805.0, 362112.0,
+       -99359.0, 12062.0},
+      1814400.0);
+  return integrator;
+}
+
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 10> const&
+QuinlanTremaine1990Order10() {
+  static SymmetricLinearMultistepIntegrator<Position, 10> const integrator(
+      BlanesMoan2002SRKN14A<Position>(),
+      {1.0, -1.0, 1.0, -1.0, 1.0, -2.0, 1.0, -1.0, 1.0, -1.0, 1.0},
+      {0.0, 399187.0, -485156.0, 2391436.0, -2816732.0, 4651330.0,
+       -2816732.0, 2391436.0, -485156.0, 399187.0, 0.0},
+      241920.0,
+      {52478684.0, 146269485.0, -213124908.0, 309028740.0, -336691836.0,
+       264441966.0, -145166580.0, 52880868.0, -11496000.0, 1129981.0},
+      239500800.0);
+  return integrator;
+}
+
+template<typename Position>
+SymmetricLinearMultistepIntegrator<Position, 12> const&
+QuinlanTremaine1990Order12() {
+  static SymmetricLinearMultistepIntegrator<Position, 12> const integrator(
+      BlanesMoan2002SRKN14A<Position>(),
+      {1.0, -2.0, 2.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, -1.0, 2.0, -2.0, 1.0},
+      {0.0, 90987349.0, -229596838.0, 812627169.0, -1628539944.0,
+       2714971338.0, -3041896548.0, 2714971338.0, -1628539944.0,
+       812627169.0, -229596838.0, 90987349.0, 0.0},
+      53222400.0,
+      {92158447389.0, 301307140046.0, -554452444015.0, 1035372815340.0,
+       -1505150506950.0, 1655690777412.0, -1363696062582.0, 828085590240.0,
+       -360089099415.0, 106193749950.0, -19043781851.0, 1569102436.0},
+      435891456000.0);
+  return integrator;
+}
+
+}  // namespace integrators
+}  // namespace principia
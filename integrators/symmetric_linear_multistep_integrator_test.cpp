@@ -0,0 +1,195 @@
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/almost_equals.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using quantities::Acceleration;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Mass;
+using quantities::Sin;
+using quantities::Speed;
+using quantities::Stiffness;
+using si::Metre;
+using si::Radian;
+using si::Second;
+using testing_utilities::AbsoluteError;
+using testing_utilities::AlmostEquals;
+using ::testing::AllOf;
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::Lt;
+
+namespace integrators {
+
+class SymmetricLinearMultistepIntegratorTest : public testing::Test {
+ protected:
+  using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+
+  SymmetricLinearMultistepIntegratorTest() {
+    harmonic_oscillator_.compute_acceleration =
+        [this](Instant const& t,
+               std::vector<Length> const& q,
+               not_null<std::vector<Acceleration>*> const result) {
+          (*result)[0] = -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+          ++evaluations_;
+        };
+    initial_state_ = {{1 * Metre}, {0 * Metre / Second}, t0_};
+  }
+
+  // Integrates the harmonic oscillator for |steps| steps and returns the
+  // states.
+  template<typename Integrator>
+  std::vector<ODE::SystemState> Solve(Integrator const& integrator,
+                                      Time const& step,
+                                      int const steps) {
+    std::vector<ODE::SystemState> solution;
+    IntegrationProblem<ODE> problem;
+    problem.equation = harmonic_oscillator_;
+    problem.initial_state = &initial_state_;
+    problem.t_final = t0_ + steps * step + step / 2;
+    problem.append_state = [&solution](ODE::SystemState const& state) {
+      solution.push_back(state);
+    };
+    evaluations_ = 0;
+    integrator.Solve(problem, step);
+    return solution;
+  }
+
+  // The largest position error over the |solution|.
+  Length PositionError(std::vector<ODE::SystemState> const& solution) {
+    AngularFrequency const ω = 1 * Radian / Second;
+    Length error;
+    for (auto const& state : solution) {
+      Time const t = state.time.value - t0_;
+      error = std::max(error,
+                       AbsoluteError(1 * Metre * Cos(ω * t),
+                                     state.positions[0].value));
+    }
+    return error;
+  }
+
+  // The largest velocity error over the |solution|.
+  Speed VelocityError(std::vector<ODE::SystemState> const& solution) {
+    AngularFrequency const ω = 1 * Radian / Second;
+    Speed error;
+    for (auto const& state : solution) {
+      Time const t = state.time.value - t0_;
+      error = std::max(error,
+                       AbsoluteError(-1 * Metre / Second * Sin(ω * t),
+                                     state.velocities[0].value));
+    }
+    return error;
+  }
+
+  // Checks that halving the step divides the errors by about 2^order.
+  template<typename Integrator>
+  void TestConvergence(Integrator const& integrator, Time const& step) {
+    int const steps = static_cast<int>(100 * Second / step);
+    Length const q_error = PositionError(Solve(integrator, step, steps));
+    Speed const v_error = VelocityError(Solve(integrator, step, steps));
+    Length const q_error_half_step =
+        PositionError(Solve(integrator, step / 2, 2 * steps));
+    Speed const v_error_half_step =
+        VelocityError(Solve(integrator, step / 2, 2 * steps));
+    double const expected_ratio = 1 << integrator.order;
+    EXPECT_THAT(q_error / q_error_half_step,
+                AllOf(Gt(expected_ratio / 2), Lt(expected_ratio * 2)));
+    EXPECT_THAT(v_error / v_error_half_step,
+                AllOf(Gt(expected_ratio / 2), Lt(expected_ratio * 2)));
+  }
+
+  ODE harmonic_oscillator_;
+  ODE::SystemState initial_state_;
+  Instant const t0_;
+  int evaluations_ = 0;
+};
+
+TEST_F(SymmetricLinearMultistepIntegratorTest, Convergence) {
+  TestConvergence(QuinlanTremaine1990Order8<Length>(), 0.2 * Second);
+  TestConvergence(QuinlanTremaine1990Order10<Length>(), 0.2 * Second);
+  TestConvergence(QuinlanTremaine1990Order12<Length>(), 0.2 * Second);
+}
+
+// After the startup, there is one evaluation per step.  The steps are
+// equally spaced, including those computed by the startup integrator.
+TEST_F(SymmetricLinearMultistepIntegratorTest, Steps) {
+  auto const& integrator = QuinlanTremaine1990Order8<Length>();
+  Time const step = 0.1 * Second;
+  int const steps = 1000;
+  std::vector<ODE::SystemState> const solution =
+      Solve(integrator, step, steps);
+  ASSERT_THAT(solution.size(), Eq(steps));
+  for (int i = 0; i < steps; ++i) {
+    EXPECT_THAT(solution[i].time.value - t0_,
+                AlmostEquals((i + 1) * step, 0));
+  }
+  int const startup_steps = integrator.order - 1;
+  int const startup_evaluations =
+      startup_steps * integrator.startup_step_divisor *
+          BlanesMoan2002SRKN14A<Length>().evaluations +
+      startup_steps + 1;
+  EXPECT_THAT(evaluations_,
+              Eq(startup_evaluations + (steps - startup_steps)));
+}
+
+// A session advanced by small increments, some of which fall within the
+// startup, yields the same states as a single call to |Solve|, with the same
+// number of evaluations: the startup is not repeated.
+TEST_F(SymmetricLinearMultistepIntegratorTest, Session) {
+  auto const& integrator = QuinlanTremaine1990Order8<Length>();
+  Time const step = 0.1 * Second;
+  int const steps = 1000;
+  std::vector<ODE::SystemState> const solve_solution =
+      Solve(integrator, step, steps);
+  int const solve_evaluations = evaluations_;
+
+  std::vector<ODE::SystemState> solution;
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator_;
+  problem.initial_state = &initial_state_;
+  problem.append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+  evaluations_ = 0;
+  auto const session = integrator.NewSession(problem, step);
+  for (int i = 1; i <= 10; ++i) {
+    session->AdvanceTo(t0_ + i * 0.35 * Second);
+  }
+  session->Step(1);
+  session->AdvanceTo(t0_ + steps * step + step / 2);
+  EXPECT_THAT(evaluations_, Eq(solve_evaluations));
+  ASSERT_THAT(solution.size(), Eq(solve_solution.size()));
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_THAT(solution[i].time.value, Eq(solve_solution[i].time.value));
+    EXPECT_THAT(solution[i].positions[0].value,
+                Eq(solve_solution[i].positions[0].value));
+    EXPECT_THAT(solution[i].velocities[0].value,
+                Eq(solve_solution[i].velocities[0].value));
+  }
+}
+
+// An integration shorter than the startup is entirely done by the startup
+// integrator.
+TEST_F(SymmetricLinearMultistepIntegratorTest, ShortIntegration) {
+  auto const& integrator = QuinlanTremaine1990Order12<Length>();
+  Time const step = 0.1 * Second;
+  std::vector<ODE::SystemState> const solution = Solve(integrator, step, 5);
+  ASSERT_THAT(solution.size(), Eq(5));
+  EXPECT_THAT(solution.back().time.value - t0_, AlmostEquals(5 * step, 0));
+  EXPECT_THAT(PositionError(solution), Lt(1E-14 * Metre));
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -1,10 +1,15 @@
 ﻿#pragma once
 
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "numerics/fixed_arrays.hpp"
 
 namespace principia {
 
+using base::not_null;
 using numerics::FixedVector;
 
 namespace integrators {
@@ -31,7 +36,8 @@ namespace integrators {
 // New Families of Symplectic Runge-Kutta-Nyström Integration Methods,
 // http://www.gicas.uji.es/Fernando/Proceedings/2000NAA.pdf.
 // In the implementation, we call |stages_| the integer r above.  The number of
-// |evaluations| is r-1 in the ABA and BAB cases, and r otherwise.
+// |evaluations| is r-1 in the ABA and BAB cases, and r otherwise.  The loop
+// over the stages is unrolled at compile time.
 // See the documentation for an explanation of how types ABA and BAB reduce the
 // number of evaluations required, especially in cases (2) and (3).
 
@@ -65,18 +71,43 @@ class SymplecticRungeKuttaNyströmIntegrator
   static int const stages_ = composition_ == kBA ? evaluations_
                                                  : evaluations_ + 1;
  public:
+  using Session =
+      typename FixedStepSizeIntegrator<
+          SpecialSecondOrderDifferentialEquation<Position>>::Session;
+
   SymplecticRungeKuttaNyströmIntegrator(FixedVector<double, stages_> const& a,
                                         FixedVector<double, stages_> const& b);
 
   void Solve(IntegrationProblem<ODE> const& problem,
              Time const& step) const override;
 
+  // Same as above, but calls |compute_acceleration| instead of
+  // |problem.equation.compute_acceleration|.  The right-hand side is then
+  // statically dispatched and may be inlined, which matters for small systems
+  // where its cost is comparable to that of the call through a
+  // |std::function|.  |compute_acceleration| must have the signature of
+  // |ODE::RightHandSideComputation|.
+  template<typename ComputeAcceleration>
+  void Solve(IntegrationProblem<ODE> const& problem,
+             Time const& step,
+             ComputeAcceleration const& compute_acceleration) const;
+
+  // The session owns the state and the workspace of the integration.  In the
+  // kBAB case, the last evaluation of a step is reused by the next one even
+  // across calls to |AdvanceTo| and |Step|.
+  not_null<std::unique_ptr<Session>> NewSession(
+      IntegrationProblem<ODE> const& problem,
+      Time const& step) const override;
+
   static int const order = order_;
   static bool const time_reversible = time_reversible_;
   static int const evaluations = evaluations_;
   static CompositionMethod const composition = composition_;
 
  private:
+  template<typename ComputeAcceleration>
+  class ResumableSession;
+
   FixedVector<double, stages_> a_;
   FixedVector<double, stages_> b_;
   FixedVector<double, stages_> c_;
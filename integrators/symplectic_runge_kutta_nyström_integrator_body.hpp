@@ -2,13 +2,19 @@
 
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "geometry/sign.hpp"
+#include "glog/logging.h"
 #include "testing_utilities/numerics.hpp"
 
 namespace principia {
 
+using base::make_not_null_unique;
 using geometry::Sign;
 using testing_utilities::ULPDistance;
 
@@ -62,53 +68,67 @@ SymplecticRungeKuttaNyströmIntegrator(FixedVector<double, stages_> const& a,
 
 template<typename Position, int order, bool time_reversible, int evaluations,
          CompositionMethod composition>
-void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
-                                           evaluations, composition>::Solve(
-    IntegrationProblem<ODE> const& problem,
-    Time const& step) const {
+template<typename ComputeAcceleration>
+class SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                            evaluations, composition>::
+    ResumableSession : public Session {
+ public:
+  ResumableSession(SymplecticRungeKuttaNyströmIntegrator const& integrator,
+                   ComputeAcceleration const& compute_acceleration,
+                   IntegrationProblem<ODE> const& problem,
+                   Time const& step);
+
+  ResumableSession(ResumableSession const&) = delete;
+  ResumableSession(ResumableSession&&) = delete;
+  ResumableSession& operator=(ResumableSession const&) = delete;
+  ResumableSession& operator=(ResumableSession&&) = delete;
+
+  void AdvanceTo(Instant const& t) override;
+  void Step(int n) override;
+  typename ODE::SystemState const& state() const override;
+
+ private:
   using Displacement = typename ODE::Displacement;
   using Velocity = typename ODE::Velocity;
   using Acceleration = typename ODE::Acceleration;
 
-  // Argument checks.
-  CHECK_NOTNULL(problem.initial_state);
-  int const dimension = problem.initial_state->positions.size();
-  CHECK_EQ(dimension, problem.initial_state->velocities.size());
-  CHECK_NE(Time(), step);
-  Sign const integration_direction = Sign(step);
-  if (integration_direction.Positive()) {
-    // Integrating forward.
-    CHECK_LT(problem.initial_state->time.value, problem.t_final);
-  } else {
-    // Integrating backward.
-    CHECK_GT(problem.initial_state->time.value, problem.t_final);
-  }
+  // Performs one step and calls |append_state_|.
+  void PerformStep();
 
-  typename ODE::SystemState current_state = *problem.initial_state;
+  // The stages [first_stage, stages_[ of a step, unrolled at compile time so
+  // that the coefficients are indexed by constants.  Each function makes a
+  // single pass over the state.  On |BM_SolveHarmonicOscillator| this is 11% to
+  // 32% faster than a loop over the stages.
+  template<int first_stage, std::size_t... indices>
+  void PerformStages(std::index_sequence<indices...>);
+  // Sets the increments to their values before stage |first_stage|, and
+  // |q_stage_| to the positions of that stage.
+  template<int first_stage>
+  void InitializeStages();
+  // Evaluates the accelerations of stage |i|, updates the increments, and sets
+  // |q_stage_| to the positions of the next stage.
+  template<int i>
+  void PerformStage();
 
+  SymplecticRungeKuttaNyströmIntegrator const& integrator_;
+  // Held by value, so that a session returned by |NewSession| doesn't depend on
+  // the lifetime of the problem.
+  ComputeAcceleration const compute_acceleration_;
+  std::function<void(typename ODE::SystemState const& state)> const
+      append_state_;
   // Time step.
-  Time h = step;
-  // Current time.  This is a non-const reference whose purpose is to make the
-  // equations more readable.
-  DoublePrecision<Instant>& t = current_state.time;
+  Time const h_;
+  Sign const integration_direction_;
 
+  typename ODE::SystemState current_state_;
   // Position increment.
-  std::vector<Displacement> ∆q(dimension);
+  std::vector<Displacement> ∆q_;
   // Velocity increment.
-  std::vector<Velocity> ∆v(dimension);
-  // Current position.  This is a non-const reference whose purpose is to make
-  // the equations more readable.
-  std::vector<DoublePrecision<Position>>& q = current_state.positions;
-  // Current velocity.  This is a non-const reference whose purpose is to make
-  // the equations more readable.
-  std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
-
+  std::vector<Velocity> ∆v_;
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position> q_stage_;
   // Accelerations at the current stage.
-  std::vector<Acceleration> g(dimension);
-
-  bool at_end = false;
+  std::vector<Acceleration> g_;
 
   // The first full stage of the step, i.e. the first stage where
   // exp(bᵢ h B) exp(aᵢ h A) must be entirely computed.
@@ -116,55 +136,231 @@ void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
   // means the first stage is only exp(a₀ h A), and 1 after the first step
   // in the kBAB case, since the last right-hand-side evaluation can be used for
   // exp(bᵢ h B).
-  int first_stage = composition == kABA ? 1 : 0;
+  int first_stage_ = composition == kABA ? 1 : 0;
+};
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                      evaluations, composition>::
+ResumableSession<ComputeAcceleration>::ResumableSession(
+    SymplecticRungeKuttaNyströmIntegrator const& integrator,
+    ComputeAcceleration const& compute_acceleration,
+    IntegrationProblem<ODE> const& problem,
+    Time const& step)
+    : integrator_(integrator),
+      compute_acceleration_(compute_acceleration),
+      append_state_(problem.append_state),
+      h_(step),
+      integration_direction_(step),
+      current_state_(*CHECK_NOTNULL(problem.initial_state)),
+      ∆q_(current_state_.positions.size()),
+      ∆v_(current_state_.positions.size()),
+      q_stage_(current_state_.positions.size()),
+      g_(current_state_.positions.size()) {
+  CHECK_EQ(current_state_.positions.size(), current_state_.velocities.size());
+  CHECK_NE(Time(), h_);
+}
 
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::AdvanceTo(Instant const& t) {
+  DoublePrecision<Instant> const& current_time = current_state_.time;
   for (;;) {
     // Termination condition.
-    Time const time_to_end = (problem.t_final - t.value) - t.error;
-    at_end = integration_direction * h > integration_direction * time_to_end;
-    if (at_end) {
-      break;
+    Time const time_to_end = (t - current_time.value) - current_time.error;
+    if (integration_direction_ * h_ > integration_direction_ * time_to_end) {
+      return;
     }
+    PerformStep();
+  }
+}
 
-    std::fill(∆q.begin(), ∆q.end(), Displacement{});
-    std::fill(∆v.begin(), ∆v.end(), Velocity{});
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::Step(int const n) {
+  CHECK_LE(0, n);
+  for (int i = 0; i < n; ++i) {
+    PerformStep();
+  }
+}
 
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+typename SpecialSecondOrderDifferentialEquation<Position>::SystemState const&
+SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                      evaluations, composition>::
+ResumableSession<ComputeAcceleration>::state() const {
+  return current_state_;
+}
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::PerformStep() {
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state_.time;
+  // Current position.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Position>>& q = current_state_.positions;
+  // Current velocity.  This is a non-const reference whose purpose is to make
+  // the equations more readable.
+  std::vector<DoublePrecision<Velocity>>& v = current_state_.velocities;
+  int const dimension = q.size();
+
+  if (first_stage_ == 0) {
+    PerformStages<0>(std::make_index_sequence<stages_>());
+  } else {
+    PerformStages<1>(std::make_index_sequence<stages_ - 1>());
+  }
+
+  if (composition == kBAB) {
+    first_stage_ = 1;
+  }
+
+  // Increment the solution.
+  t.Increment(h_);
+  for (int k = 0; k < dimension; ++k) {
+    q[k].Increment(∆q_[k]);
+    v[k].Increment(∆v_[k]);
+  }
+  append_state_(current_state_);
+}
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+template<int first_stage, std::size_t... indices>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::PerformStages(
+    std::index_sequence<indices...>) {
+  InitializeStages<first_stage>();
+  // The elements of a braced list are evaluated in order, so this performs the
+  // stages in order.
+  int const unused[] = {0, (PerformStage<first_stage + indices>(), 0)...};
+  static_cast<void>(unused);
+}
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+template<int first_stage>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::InitializeStages() {
+  auto const& a = integrator_.a_;
+  auto const& b = integrator_.b_;
+  Time const& h = h_;
+  std::vector<DoublePrecision<Position>> const& q = current_state_.positions;
+  std::vector<DoublePrecision<Velocity>> const& v = current_state_.velocities;
+  int const dimension = q.size();
+
+  // The first full stage of the step is |first_stage|, so the first one is
+  // partially computed here if |first_stage == 1|.
+  for (int k = 0; k < dimension; ++k) {
+    ∆q_[k] = Displacement{};
+    ∆v_[k] = Velocity{};
     if (first_stage == 1) {
-      for (int k = 0; k < dimension; ++k) {
-        if (composition == kBAB) {
-          // exp(b₀ h B)
-          ∆v[k] += h * b_[0] * g[k];
-        }
-        // exp(a₀ h A)
-        ∆q[k] += h * a_[0] * (v[k].value + ∆v[k]);
+      if (composition == kBAB) {
+        // exp(b₀ h B)
+        ∆v_[k] += h * b[0] * g_[k];
       }
+      // exp(a₀ h A)
+      ∆q_[k] += h * a[0] * (v[k].value + ∆v_[k]);
     }
+    q_stage_[k] = q[k].value + ∆q_[k];
+  }
+}
 
-    for (int i = first_stage; i < stages_; ++i) {
-      for (int k = 0; k < dimension; ++k) {
-        q_stage[k] = q[k].value + ∆q[k];
-      }
-      problem.equation.compute_acceleration(t.value + c_[i] * h, q_stage, &g);
-      for (int k = 0; k < dimension; ++k) {
-        // exp(bᵢ h B)
-        ∆v[k] += h * b_[i] * g[k];
-        // exp(aᵢ h A)
-        ∆q[k] += h * a_[i] * (v[k].value + ∆v[k]);
-      }
-    }
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+template<int i>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::
+ResumableSession<ComputeAcceleration>::PerformStage() {
+  auto const& a = integrator_.a_;
+  auto const& b = integrator_.b_;
+  auto const& c = integrator_.c_;
+  Time const& h = h_;
+  std::vector<DoublePrecision<Position>> const& q = current_state_.positions;
+  std::vector<DoublePrecision<Velocity>> const& v = current_state_.velocities;
+  int const dimension = q.size();
 
-    if (composition == kBAB) {
-      first_stage = 1;
+  compute_acceleration_(current_state_.time.value + c[i] * h, q_stage_, &g_);
+  for (int k = 0; k < dimension; ++k) {
+    // exp(bᵢ h B)
+    ∆v_[k] += h * b[i] * g_[k];
+    // exp(aᵢ h A)
+    ∆q_[k] += h * a[i] * (v[k].value + ∆v_[k]);
+    if (i + 1 < stages_) {
+      q_stage_[k] = q[k].value + ∆q_[k];
     }
+  }
+}
 
-    // Increment the solution.
-    t.Increment(h);
-    for (int k = 0; k < dimension; ++k) {
-      q[k].Increment(∆q[k]);
-      v[k].Increment(∆v[k]);
-    }
-    problem.append_state(current_state);
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  Solve(problem, step, problem.equation.compute_acceleration);
+}
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+template<typename ComputeAcceleration>
+void SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                           evaluations, composition>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step,
+    ComputeAcceleration const& compute_acceleration) const {
+  // Argument checks.
+  CHECK_NOTNULL(problem.initial_state);
+  int const dimension = problem.initial_state->positions.size();
+  CHECK_EQ(dimension, problem.initial_state->velocities.size());
+  CHECK_NE(Time(), step);
+  Sign const integration_direction = Sign(step);
+  if (integration_direction.Positive()) {
+    // Integrating forward.
+    CHECK_LT(problem.initial_state->time.value, problem.t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(problem.initial_state->time.value, problem.t_final);
   }
+
+  // The session doesn't outlive this call, so it may refer to the functor
+  // instead of copying it.
+  ResumableSession<std::reference_wrapper<ComputeAcceleration const>> session(
+      *this, std::cref(compute_acceleration), problem, step);
+  session.AdvanceTo(problem.t_final);
+}
+
+template<typename Position, int order, bool time_reversible, int evaluations,
+         CompositionMethod composition>
+not_null<std::unique_ptr<
+    typename SymplecticRungeKuttaNyströmIntegrator<
+        Position, order, time_reversible, evaluations, composition>::Session>>
+SymplecticRungeKuttaNyströmIntegrator<Position, order, time_reversible,
+                                      evaluations, composition>::NewSession(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  return make_not_null_unique<
+      ResumableSession<typename ODE::RightHandSideComputation>>(
+          *this, problem.equation.compute_acceleration, problem, step);
 }
 
 template<typename Position>
@@ -104,6 +104,12 @@ struct SimpleHarmonicMotionTestInstance {
         test_time_reversibility_(
             std::bind(TestTimeReversibility<Integrator>,
                       integrator)),
+        test_session_(
+            std::bind(TestSession<Integrator>,
+                      integrator)),
+        test_static_dispatch_(
+            std::bind(TestStaticDispatch<Integrator>,
+                      integrator)),
         name_(name) {}
 
   std::string const& name() const {
@@ -126,11 +132,21 @@ struct SimpleHarmonicMotionTestInstance {
     test_time_reversibility_();
   }
 
+  void RunSession() const {
+    test_session_();
+  }
+
+  void RunStaticDispatch() const {
+    test_static_dispatch_();
+  }
+
  private:
   std::function<void()> test_1000_seconds_at_1_millisecond_;
   std::function<void()> test_convergence_;
   std::function<void()> test_symplecticity_;
   std::function<void()> test_time_reversibility_;
+  std::function<void()> test_session_;
+  std::function<void()> test_static_dispatch_;
   std::string name_;
 };
 
@@ -393,6 +409,112 @@ void TestTimeReversibility(Integrator const& integrator) {
   }
 }
 
+// Checks that a session advanced in several calls yields the same states as a
+// single call to |Solve|, with the same number of evaluations.
+template<typename Integrator>
+void TestSession(Integrator const& integrator) {
+  Length const q_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 100 * Second;
+  Time const step = 0.1 * Second;
+
+  int evaluations = 0;
+  std::vector<ODE::SystemState> solution;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration,
+                _1, _2, _3, &evaluations);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  ODE::SystemState const initial_state = {{q_initial}, {v_initial}, t_initial};
+  problem.initial_state = &initial_state;
+  problem.t_final = t_final;
+  problem.append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+
+  integrator.Solve(problem, step);
+  int const solve_evaluations = evaluations;
+  std::vector<ODE::SystemState> const solve_solution = solution;
+
+  evaluations = 0;
+  solution.clear();
+  auto const session = integrator.NewSession(problem, step);
+  EXPECT_EQ(t_initial, session->state().time.value);
+  for (int i = 1; i <= 10; ++i) {
+    session->AdvanceTo(t_initial + i * 10 * Second);
+  }
+  EXPECT_EQ(solve_evaluations, evaluations);
+  ASSERT_EQ(solve_solution.size(), solution.size());
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_EQ(solve_solution[i].time.value, solution[i].time.value);
+    EXPECT_EQ(solve_solution[i].positions[0].value,
+              solution[i].positions[0].value);
+    EXPECT_EQ(solve_solution[i].velocities[0].value,
+              solution[i].velocities[0].value);
+  }
+
+  session->Step(5);
+  EXPECT_EQ(solve_solution.size() + 5, solution.size());
+  EXPECT_EQ(solution.back().time.value, session->state().time.value);
+  EXPECT_THAT(AbsoluteError(solve_solution.back().time.value + 5 * step,
+                            session->state().time.value),
+              Lt(1E-12 * Second));
+}
+
+// Checks that passing the right-hand side as a functor yields the same states
+// as calling it through |problem.equation|.
+template<typename Integrator>
+void TestStaticDispatch(Integrator const& integrator) {
+  Length const q_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 100 * Second;
+  Time const step = 0.1 * Second;
+
+  std::vector<ODE::SystemState> solution;
+  ODE harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration,
+                _1, _2, _3, nullptr /*evaluations*/);
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillator;
+  ODE::SystemState const initial_state = {{q_initial}, {v_initial}, t_initial};
+  problem.initial_state = &initial_state;
+  problem.t_final = t_final;
+  problem.append_state = [&solution](ODE::SystemState const& state) {
+    solution.push_back(state);
+  };
+
+  integrator.Solve(problem, step);
+  std::vector<ODE::SystemState> const type_erased_solution = solution;
+
+  solution.clear();
+  int evaluations = 0;
+  integrator.Solve(problem,
+                   step,
+                   [&evaluations](Instant const& t,
+                                  std::vector<Length> const& q,
+                                  not_null<std::vector<Acceleration>*> const
+                                      result) {
+                     (*result)[0] =
+                         -q[0] * (SIUnit<Stiffness>() / SIUnit<Mass>());
+                     ++evaluations;
+                   });
+  EXPECT_EQ(solution.size() * integrator.evaluations +
+                (integrator.composition == kBAB ? 1 : 0),
+            evaluations);
+  ASSERT_EQ(type_erased_solution.size(), solution.size());
+  for (int i = 0; i < solution.size(); ++i) {
+    EXPECT_EQ(type_erased_solution[i].time.value, solution[i].time.value);
+    EXPECT_EQ(type_erased_solution[i].positions[0].value,
+              solution[i].positions[0].value);
+    EXPECT_EQ(type_erased_solution[i].velocities[0].value,
+              solution[i].velocities[0].value);
+  }
+}
+
 std::vector<SimpleHarmonicMotionTestInstance> Instances() {
   return {INSTANCE(McLachlanAtela1992Order4Optimal,
                    1.0 * Second,
@@ -470,5 +592,15 @@ TEST_P(SymplecticRungeKuttaNyströmIntegratorTest, LongIntegration) {
   GetParam().Run1000SecondsAt1Millisecond();
 }
 
+TEST_P(SymplecticRungeKuttaNyströmIntegratorTest, Session) {
+  LOG(INFO) << GetParam();
+  GetParam().RunSession();
+}
+
+TEST_P(SymplecticRungeKuttaNyströmIntegratorTest, StaticDispatch) {
+  LOG(INFO) << GetParam();
+  GetParam().RunStaticDispatch();
+}
+
 }  // namespace integrators
 }  // namespace principia
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "geometry/named_quantities.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "numerics/fixed_arrays.hpp"
+
+namespace principia {
+
+using geometry::Position;
+using numerics::FixedVector;
+
+namespace integrators {
+
+// This class solves the equations of motion of massive bodies under their
+// mutual gravitation, q″ = f(q, t), by splitting the Hamiltonian in a Keplerian
+// part A, which describes the motion of each body around the central body,
+// i.e., the most massive one, and a perturbation B, which is smaller by a
+// factor ε, the ratio of the masses of the other bodies to the central one.
+// The evolution exp hA is computed in closed form using the universal variable
+// formulation of Kepler's equation, so that the error of the method is
+// proportional to ε, which allows for much larger steps than the
+// |SymplecticRungeKuttaNyströmIntegrator|s in a hierarchical system such as
+// the planets of the Sun.
+//
+// We use the democratic heliocentric coordinates of Duncan, Levison and Lee
+// (1998), A multiple time step symplectic algorithm for integrating close
+// encounters, rather than the Jacobi coordinates of Wisdom and Holman (1991),
+// Symplectic maps for the n-body problem: the positions are relative to the
+// central body and the velocities to the barycentre, so that no ordering of
+// the bodies is needed.  B then comprises the interactions between the bodies
+// other than the central one, whose accelerations are those given by f minus
+// the attraction of the central body, and the motion of the central body
+// around the barycentre, which is a drift of all the positions by the total
+// momentum.  exp hB is approximated by a drift for h / 2, an interaction kick
+// for h, and a drift for h / 2.  The motion of the central body follows from
+// the conservation of momentum, so the system must be isolated.
+//
+// Each step of size h is the composition of evolutions
+//   exp(aᵣ₋₁ h A) exp(bᵣ₋₁ h B) ... exp(a₀ h A) exp(b₀ h B)
+// with the notations and |CompositionMethod|s of the
+// |SymplecticRungeKuttaNyströmIntegrator|.  The compositions of Laskar and
+// Robutel (2001), High order symplectic integrators for perturbed Hamiltonian
+// systems, have an error in O(ε h²ⁿ + ε² h²), where n is their number of
+// right-hand-side evaluations; the latter term is the error of the
+// approximation of exp hB.  Since the motion of the central body breaks the
+// sequence drift, kick, drift, there is no first-same-as-last property, and
+// the number of |evaluations| is the number of nonzero bᵢ.
+//
+// The gravitational parameters of the bodies are taken from
+// |problem.equation|.  If there are none, e.g., for massless bodies, A is the
+// free motion and the method is an ordinary symplectic Runge-Kutta-Nyström
+// method of order 2.
+template<typename Frame, int stages_, CompositionMethod composition_>
+class WisdomHolmanIntegrator
+    : public FixedStepSizeIntegrator<
+                 SpecialSecondOrderDifferentialEquation<Position<Frame>>> {
+ public:
+  using ODE = SpecialSecondOrderDifferentialEquation<Position<Frame>>;
+
+  WisdomHolmanIntegrator(FixedVector<double, stages_> const& a,
+                         FixedVector<double, stages_> const& b);
+
+  void Solve(IntegrationProblem<ODE> const& problem,
+             Time const& step) const override;
+
+  static int const evaluations = composition_ == kABA ? stages_ - 1 : stages_;
+  static CompositionMethod const composition = composition_;
+
+ private:
+  FixedVector<double, stages_> a_;
+  FixedVector<double, stages_> b_;
+  FixedVector<double, stages_> c_;
+};
+
+// The kick-drift-kick form of the map of Wisdom and Holman (1991), which is
+// SBAB₁ in the notation of Laskar and Robutel (2001).
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 2, kBAB> const& WisdomHolman1991();
+// Coefficients from Laskar and Robutel (2001), High order symplectic
+// integrators for perturbed Hamiltonian systems, section 3.  The kicks are at
+// the Gauss nodes for SABAₙ and at the Lobatto nodes for SBABₙ.
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 3, kABA> const& LaskarRobutel2001SABA2();
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 4, kABA> const& LaskarRobutel2001SABA3();
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 3, kBAB> const& LaskarRobutel2001SBAB2();
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 4, kBAB> const& LaskarRobutel2001SBAB3();
+
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/wisdom_holman_integrator_body.hpp"
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "integrators/wisdom_holman_integrator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+#include "numerics/universal_kepler_equation.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using geometry::Displacement;
+using geometry::InnerProduct;
+using geometry::Sign;
+using geometry::Vector;
+using geometry::Velocity;
+using numerics::LagrangeCoefficients;
+using numerics::UniversalKeplerEquation;
+using quantities::Acceleration;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::SIUnit;
+using quantities::Speed;
+using testing_utilities::ULPDistance;
+
+namespace integrators {
+
+template<typename Frame, int stages, CompositionMethod composition>
+WisdomHolmanIntegrator<Frame, stages, composition>::WisdomHolmanIntegrator(
+    FixedVector<double, stages> const& a,
+    FixedVector<double, stages> const& b)
+    : a_(a),
+      b_(b) {
+  DoublePrecision<double> c_i = 0.0;
+  DoublePrecision<double> sum_of_b = 0.0;
+  for (int i = 0; i < stages; ++i) {
+    c_[i] = c_i.value;
+    c_i.Increment(a_[i]);
+    sum_of_b.Increment(b_[i]);
+  }
+  CHECK_LE(ULPDistance(1.0, c_i.value), 2);
+  CHECK_LE(ULPDistance(1.0, sum_of_b.value), 2);
+  switch (composition) {
+    case kABA:
+      CHECK_EQ(0.0, b_[0]);
+      for (int i = 0; i < stages; ++i) {
+        CHECK_EQ(a_[i], a_[stages - 1 - i]);
+      }
+      for (int i = 0; i < stages - 1; ++i) {
+        CHECK_EQ(b_[i + 1], b_[stages - 1 - i]);
+      }
+      break;
+    case kBAB:
+      CHECK_EQ(0.0, a_[stages - 1]);
+      for (int i = 0; i < stages - 1; ++i) {
+        CHECK_EQ(a_[i], a_[stages - 2 - i]);
+      }
+      for (int i = 0; i < stages; ++i) {
+        CHECK_EQ(b_[i], b_[stages - 1 - i]);
+      }
+      break;
+    default:
+      LOG(FATAL) << "The composition must be symmetric";
+      base::noreturn();
+  }
+}
+
+template<typename Frame, int stages, CompositionMethod composition>
+void WisdomHolmanIntegrator<Frame, stages, composition>::Solve(
+    IntegrationProblem<ODE> const& problem,
+    Time const& step) const {
+  // Argument checks.
+  CHECK_NOTNULL(problem.initial_state);
+  int const dimension = problem.initial_state->positions.size();
+  CHECK_EQ(dimension, problem.initial_state->velocities.size());
+  CHECK_NE(Time(), step);
+  Sign const integration_direction = Sign(step);
+  if (integration_direction.Positive()) {
+    // Integrating forward.
+    CHECK_LT(problem.initial_state->time.value, problem.t_final);
+  } else {
+    // Integrating backward.
+    CHECK_GT(problem.initial_state->time.value, problem.t_final);
+  }
+  std::vector<GravitationalParameter> const& μ =
+      problem.equation.gravitational_parameters;
+  bool const keplerian = !μ.empty();
+  if (keplerian) {
+    CHECK_EQ(dimension, μ.size());
+  }
+
+  typename ODE::SystemState current_state = *problem.initial_state;
+
+  // Time step.
+  Time const& h = step;
+  // Current time.  This is a non-const reference whose purpose is to make the
+  // equations more readable.
+  DoublePrecision<Instant>& t = current_state.time;
+  Instant const t0 = t.value;
+
+  // In the Keplerian case, the index of the central body, and the uniform
+  // motion of the barycentre.  Otherwise, |central| is |dimension| and the
+  // barycentre is the origin at rest.
+  int central = dimension;
+  GravitationalParameter total_gravitational_parameter;
+  Position<Frame> barycentre_at_t0 = Frame::origin;
+  Velocity<Frame> barycentre_velocity;
+  if (keplerian) {
+    central = std::max_element(μ.begin(), μ.end()) - μ.begin();
+    CHECK_LT(GravitationalParameter(), μ[central]);
+    for (int k = 0; k < dimension; ++k) {
+      total_gravitational_parameter += μ[k];
+    }
+    Position<Frame> const& central_position =
+        current_state.positions[central].value;
+    Displacement<Frame> barycentre_displacement;
+    for (int k = 0; k < dimension; ++k) {
+      double const mass_fraction = μ[k] / total_gravitational_parameter;
+      barycentre_displacement +=
+          mass_fraction *
+          (current_state.positions[k].value - central_position);
+      barycentre_velocity +=
+          mass_fraction * current_state.velocities[k].value;
+    }
+    barycentre_at_t0 = central_position + barycentre_displacement;
+  }
+
+  // The positions relative to the central body, and the velocities relative to
+  // the barycentre.  The entries for the central body are unused.
+  std::vector<Displacement<Frame>> Q(dimension);
+  std::vector<Velocity<Frame>> u(dimension);
+  {
+    Position<Frame> const& origin =
+        keplerian ? current_state.positions[central].value : Frame::origin;
+    for (int k = 0; k < dimension; ++k) {
+      Q[k] = current_state.positions[k].value - origin;
+      u[k] = current_state.velocities[k].value - barycentre_velocity;
+    }
+  }
+
+  // The absolute positions at time |t_stage|.
+  std::vector<Position<Frame>> q_stage(dimension);
+  auto const compute_positions = [&](Instant const& t_stage) {
+    Position<Frame> origin = Frame::origin;
+    if (keplerian) {
+      Displacement<Frame> central_displacement;
+      for (int k = 0; k < dimension; ++k) {
+        if (k != central) {
+          central_displacement -=
+              (μ[k] / total_gravitational_parameter) * Q[k];
+        }
+      }
+      origin = barycentre_at_t0 + barycentre_velocity * (t_stage - t0) +
+               central_displacement;
+      q_stage[central] = origin;
+    }
+    for (int k = 0; k < dimension; ++k) {
+      if (k != central) {
+        q_stage[k] = origin + Q[k];
+      }
+    }
+  };
+
+  // exp(τ B) for a kick at time |t_stage|, approximated by a drift of the
+  // central body, a kick, and a drift of the central body.
+  std::vector<Vector<Acceleration, Frame>> g(dimension);
+  auto const drift_central_body = [&](Time const& τ) {
+    if (!keplerian) {
+      return;
+    }
+    Velocity<Frame> central_velocity;
+    for (int k = 0; k < dimension; ++k) {
+      if (k != central) {
+        central_velocity += (μ[k] / μ[central]) * u[k];
+      }
+    }
+    Displacement<Frame> const Δ = τ * central_velocity;
+    for (int k = 0; k < dimension; ++k) {
+      if (k != central) {
+        Q[k] += Δ;
+      }
+    }
+  };
+  auto const kick = [&](Time const& τ, Instant const& t_stage) {
+    drift_central_body(τ / 2);
+    compute_positions(t_stage);
+    problem.equation.compute_acceleration(t_stage, q_stage, &g);
+    for (int k = 0; k < dimension; ++k) {
+      if (k == central) {
+        continue;
+      }
+      Vector<Acceleration, Frame> interaction = g[k];
+      if (keplerian) {
+        // Remove the attraction of the central body, which is part of A.
+        Displacement<Frame> const Δq = q_stage[central] - q_stage[k];
+        Length const r = Δq.Norm();
+        interaction -= μ[central] * Δq / (r * r * r);
+      }
+      u[k] += τ * interaction;
+    }
+    drift_central_body(τ / 2);
+  };
+
+  // exp(τ A).  The Keplerian motion is given by the Lagrange coefficients of
+  // the universal Kepler equation, in SI units.
+  double const μ_central =
+      keplerian ? μ[central] / SIUnit<GravitationalParameter>() : 0;
+  auto const drift = [&](Time const& τ) {
+    double const Δt = τ / SIUnit<Time>();
+    for (int k = 0; k < dimension; ++k) {
+      if (k == central) {
+        continue;
+      }
+      if (keplerian) {
+        UniversalKeplerEquation const kepler_equation(
+            μ_central,
+            Q[k].Norm() / SIUnit<Length>(),
+            InnerProduct(Q[k], u[k]) / (SIUnit<Length>() * SIUnit<Speed>()),
+            InnerProduct(u[k], u[k]) / (SIUnit<Speed>() * SIUnit<Speed>()));
+        LagrangeCoefficients const coefficients =
+            kepler_equation.Coefficients(kepler_equation.UniversalAnomaly(Δt),
+                                         Δt);
+        Time const g = coefficients.g * SIUnit<Time>();
+        Time::Inverse const ḟ = coefficients.ḟ / SIUnit<Time>();
+        Displacement<Frame> const Q0 = Q[k];
+        Q[k] = coefficients.f * Q0 + g * u[k];
+        u[k] = ḟ * Q0 + coefficients.ġ * u[k];
+      } else {
+        Q[k] += τ * u[k];
+      }
+    }
+  };
+
+  for (;;) {
+    // Termination condition.
+    Time const time_to_end = (problem.t_final - t.value) - t.error;
+    if (integration_direction * h > integration_direction * time_to_end) {
+      break;
+    }
+
+    for (int i = 0; i < stages; ++i) {
+      if (b_[i] != 0.0) {
+        kick(b_[i] * h, t.value + c_[i] * h);
+      }
+      if (a_[i] != 0.0) {
+        drift(a_[i] * h);
+      }
+    }
+
+    // Go back to the absolute positions and velocities.
+    t.Increment(h);
+    compute_positions(t.value);
+    Velocity<Frame> central_velocity = barycentre_velocity;
+    for (int k = 0; k < dimension; ++k) {
+      current_state.positions[k] = q_stage[k];
+      if (k != central) {
+        current_state.velocities[k] = barycentre_velocity + u[k];
+        if (keplerian) {
+          central_velocity -= (μ[k] / μ[central]) * u[k];
+        }
+      }
+    }
+    if (keplerian) {
+      current_state.velocities[central] = central_velocity;
+    }
+    problem.append_state(current_state);
+  }
+}
+
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 2, kBAB> const& WisdomHolman1991() {
+  static WisdomHolmanIntegrator<Frame, 2, kBAB> const integrator(
+      {1.0, 0.0},
+      {0.5, 0.5});
+  return integrator;
+}
+
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 3, kABA> const& LaskarRobutel2001SABA2() {
+  static WisdomHolmanIntegrator<Frame, 3, kABA> const integrator(
+      {0.5 - std::sqrt(3.0) / 6.0,
+       std::sqrt(3.0) / 3.0,
+       0.5 - std::sqrt(3.0) / 6.0},
+      {0.0, 0.5, 0.5});
+  return integrator;
+}
+
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 4, kABA> const& LaskarRobutel2001SABA3() {
+  static WisdomHolmanIntegrator<Frame, 4, kABA> const integrator(
+      {0.5 - std::sqrt(15.0) / 10.0,
+       std::sqrt(15.0) / 10.0,
+       std::sqrt(15.0) / 10.0,
+       0.5 - std::sqrt(15.0) / 10.0},
+      {0.0, 5.0 / 18.0, 4.0 / 9.0, 5.0 / 18.0});
+  return integrator;
+}
+
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 3, kBAB> const& LaskarRobutel2001SBAB2() {
+  static WisdomHolmanIntegrator<Frame, 3, kBAB> const integrator(
+      {0.5, 0.5, 0.0},
+      {1.0 / 6.0, 2.0 / 3.0, 1.0 / 6.0});
+  return integrator;
+}
+
+template<typename Frame>
+WisdomHolmanIntegrator<Frame, 4, kBAB> const& LaskarRobutel2001SBAB3() {
+  static WisdomHolmanIntegrator<Frame, 4, kBAB> const integrator(
+      {0.5 - std::sqrt(5.0) / 10.0,
+       std::sqrt(5.0) / 5.0,
+       0.5 - std::sqrt(5.0) / 10.0,
+       0.0},
+      {1.0 / 12.0, 5.0 / 12.0, 5.0 / 12.0, 1.0 / 12.0});
+  return integrator;
+}
+
+}  // namespace integrators
+}  // namespace principia
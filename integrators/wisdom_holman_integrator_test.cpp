@@ -0,0 +1,286 @@
+#include "integrators/wisdom_holman_integrator.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/astronomy.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using geometry::Frame;
+using geometry::InnerProduct;
+using quantities::Exponentiation;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Product;
+using quantities::Sqrt;
+using si::AstronomicalUnit;
+using si::Day;
+using si::Metre;
+using si::Second;
+using testing_utilities::RelativeError;
+using ::std::placeholders::_1;
+using ::std::placeholders::_2;
+using ::std::placeholders::_3;
+using ::testing::AllOf;
+using ::testing::Gt;
+using ::testing::Lt;
+
+namespace integrators {
+
+class WisdomHolmanIntegratorTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+  using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
+  // The energy divided by the gravitational constant.
+  using ScaledEnergy =
+      Product<GravitationalParameter, Exponentiation<Speed, 2>>;
+
+  // The Sun, Jupiter and Saturn, with the planets on circular heliocentric
+  // orbits, Saturn being slightly inclined.
+  WisdomHolmanIntegratorTest() {
+    equation_.gravitational_parameters = {
+        1.32712440018E20 * Pow<3>(Metre) / Pow<2>(Second),
+        1.26686534E17 * Pow<3>(Metre) / Pow<2>(Second),
+        3.7931187E16 * Pow<3>(Metre) / Pow<2>(Second)};
+    equation_.compute_acceleration =
+        std::bind(&WisdomHolmanIntegratorTest::ComputeAccelerations,
+                  this, _1, _2, _3);
+    std::vector<GravitationalParameter> const& μ =
+        equation_.gravitational_parameters;
+    Length const r1 = 5.2 * AstronomicalUnit;
+    Length const r2 = 9.58 * AstronomicalUnit;
+    Speed const v1 = Sqrt((μ[0] + μ[1]) / r1);
+    Speed const v2 = Sqrt((μ[0] + μ[2]) / r2);
+    initial_state_.positions = {
+        World::origin,
+        World::origin + Displacement<World>({r1, 0 * Metre, 0 * Metre}),
+        World::origin + Displacement<World>({-0.8 * r2, 0.6 * r2, 0 * Metre})};
+    Velocity<World> const planet1_velocity({0 * v1, v1, 0 * v1});
+    Velocity<World> const planet2_velocity({-0.6 * v2, -0.8 * v2, 0.03 * v2});
+    initial_state_.velocities = {
+        -(μ[1] * planet1_velocity + μ[2] * planet2_velocity) / μ[0],
+        planet1_velocity,
+        planet2_velocity};
+    initial_state_.time = t0_;
+  }
+
+  void ComputeAccelerations(
+      Instant const& t,
+      std::vector<Position<World>> const& positions,
+      not_null<std::vector<Vector<Acceleration, World>>*> const accelerations) {
+    std::vector<GravitationalParameter> const& μ =
+        equation_.gravitational_parameters;
+    for (auto& acceleration : *accelerations) {
+      acceleration = Vector<Acceleration, World>();
+    }
+    for (std::size_t b1 = 0; b1 < positions.size(); ++b1) {
+      for (std::size_t b2 = b1 + 1; b2 < positions.size(); ++b2) {
+        Displacement<World> const Δq = positions[b1] - positions[b2];
+        Length const r = Δq.Norm();
+        auto const Δq_over_r_cubed = Δq / (r * r * r);
+        (*accelerations)[b1] -= μ[b2] * Δq_over_r_cubed;
+        (*accelerations)[b2] += μ[b1] * Δq_over_r_cubed;
+      }
+    }
+    ++evaluations_;
+  }
+
+  ScaledEnergy Energy(
+      ODE::SystemState const& state) const {
+    std::vector<GravitationalParameter> const& μ =
+        equation_.gravitational_parameters;
+    ScaledEnergy energy;
+    for (std::size_t b1 = 0; b1 < μ.size(); ++b1) {
+      Velocity<World> const& v = state.velocities[b1].value;
+      energy += 0.5 * μ[b1] * InnerProduct(v, v);
+      for (std::size_t b2 = b1 + 1; b2 < μ.size(); ++b2) {
+        energy -= μ[b1] * μ[b2] /
+                  (state.positions[b1].value - state.positions[b2].value).
+                      Norm();
+      }
+    }
+    return energy;
+  }
+
+  // Integrates from |t0_| to |t_final| and returns the final state; also
+  // records the largest relative energy error in |*energy_error| if it is not
+  // null.
+  template<typename Integrator>
+  ODE::SystemState Solve(Integrator const& integrator,
+                         Time const& step,
+                         Instant const& t_final,
+                         double* const energy_error = nullptr) {
+    auto const initial_energy = Energy(initial_state_);
+    ODE::SystemState final_state;
+    IntegrationProblem<ODE> problem;
+    problem.equation = equation_;
+    problem.initial_state = &initial_state_;
+    problem.t_final = t_final;
+    problem.append_state = [this, &final_state, energy_error, initial_energy](
+        ODE::SystemState const& state) {
+      final_state = state;
+      if (energy_error != nullptr) {
+        *energy_error = std::max(*energy_error,
+                                 RelativeError(initial_energy, Energy(state)));
+      }
+    };
+    integrator.Solve(problem, step);
+    return final_state;
+  }
+
+  // The largest error on the positions of the planets relative to the Sun.
+  static Length HeliocentricError(ODE::SystemState const& expected,
+                                  ODE::SystemState const& actual) {
+    Length error;
+    for (std::size_t b = 1; b < expected.positions.size(); ++b) {
+      error = std::max(
+          error,
+          ((expected.positions[b].value - expected.positions[0].value) -
+           (actual.positions[b].value - actual.positions[0].value)).Norm());
+    }
+    return error;
+  }
+
+  ODE equation_;
+  ODE::SystemState initial_state_;
+  Instant const t0_;
+  int evaluations_ = 0;
+};
+
+// The map is of order 2, with an error proportional to the masses of the
+// planets, so it is more accurate than a fifth-order method doing the same
+// amount of work with steps that are not small compared to the orbital periods.
+TEST_F(WisdomHolmanIntegratorTest, Convergence) {
+  Instant const t_final = t0_ + 36000 * Day;
+  ODE::SystemState const reference =
+      Solve(McLachlanAtela1992Order5Optimal<Position<World>>(),
+            1 * Day,
+            t_final + 0.5 * Day);
+  EXPECT_EQ(t_final, reference.time.value);
+
+  evaluations_ = 0;
+  Length const error_40_days =
+      HeliocentricError(reference,
+                        Solve(WisdomHolman1991<World>(),
+                              40 * Day,
+                              t_final + 20 * Day));
+  int const evaluations_40_days = evaluations_;
+  Length const error_20_days =
+      HeliocentricError(reference,
+                        Solve(WisdomHolman1991<World>(),
+                              20 * Day,
+                              t_final + 10 * Day));
+  EXPECT_THAT(error_40_days / error_20_days, AllOf(Gt(3.5), Lt(4.5)));
+  EXPECT_THAT(error_40_days, Lt(6E6 * Metre));
+
+  evaluations_ = 0;
+  Length const error_order_5 =
+      HeliocentricError(reference,
+                        Solve(McLachlanAtela1992Order5Optimal<
+                                  Position<World>>(),
+                              120 * Day,
+                              t_final + 60 * Day));
+  EXPECT_EQ(evaluations_40_days, evaluations_);
+  EXPECT_THAT(error_order_5, Gt(2 * error_40_days));
+}
+
+// The compositions of Laskar and Robutel remove the terms in ε h² of the error,
+// leaving those in ε² h².
+TEST_F(WisdomHolmanIntegratorTest, LaskarRobutel) {
+  Instant const t_final = t0_ + 36000 * Day;
+  Time const step = 40 * Day;
+  ODE::SystemState const reference =
+      Solve(McLachlanAtela1992Order5Optimal<Position<World>>(),
+            1 * Day,
+            t_final + 0.5 * Day);
+  Length const error_wisdom_holman =
+      HeliocentricError(reference,
+                        Solve(WisdomHolman1991<World>(),
+                              step,
+                              t_final + step / 2));
+  EXPECT_THAT(HeliocentricError(reference,
+                                Solve(LaskarRobutel2001SABA2<World>(),
+                                      step,
+                                      t_final + step / 2)),
+              Lt(error_wisdom_holman / 10));
+  EXPECT_THAT(HeliocentricError(reference,
+                                Solve(LaskarRobutel2001SABA3<World>(),
+                                      step,
+                                      t_final + step / 2)),
+              Lt(error_wisdom_holman / 10));
+  EXPECT_THAT(HeliocentricError(reference,
+                                Solve(LaskarRobutel2001SBAB2<World>(),
+                                      step,
+                                      t_final + step / 2)),
+              Lt(error_wisdom_holman / 10));
+  EXPECT_THAT(HeliocentricError(reference,
+                                Solve(LaskarRobutel2001SBAB3<World>(),
+                                      step,
+                                      t_final + step / 2)),
+              Lt(error_wisdom_holman / 10));
+}
+
+// The map is symplectic, so the energy error doesn't drift.
+TEST_F(WisdomHolmanIntegratorTest, Energy) {
+  Time const step = 100 * Day;
+  double first_half_energy_error = 0;
+  double second_half_energy_error = 0;
+  initial_state_ = Solve(WisdomHolman1991<World>(),
+                         step,
+                         t0_ + 5000 * step + step / 2,
+                         &first_half_energy_error);
+  Solve(WisdomHolman1991<World>(),
+        step,
+        t0_ + 10000 * step + step / 2,
+        &second_half_energy_error);
+  EXPECT_THAT(first_half_energy_error, Lt(1E-6));
+  EXPECT_THAT(second_half_energy_error, Lt(2 * first_half_energy_error));
+}
+
+// Without gravitational parameters the drifts are free motion and the map is
+// the velocity Verlet method, which is exact for a constant acceleration.
+TEST_F(WisdomHolmanIntegratorTest, FreeMotion) {
+  Vector<Acceleration, World> const g(
+      {0 * Metre / Pow<2>(Second),
+       0 * Metre / Pow<2>(Second),
+       -9.80665 * Metre / Pow<2>(Second)});
+  equation_.gravitational_parameters.clear();
+  equation_.compute_acceleration =
+      [&g](Instant const& t,
+           std::vector<Position<World>> const& positions,
+           not_null<std::vector<Vector<Acceleration, World>>*> const
+               accelerations) {
+        for (auto& acceleration : *accelerations) {
+          acceleration = g;
+        }
+      };
+  Time const duration = 10 * Second;
+  ODE::SystemState const final_state =
+      Solve(WisdomHolman1991<World>(),
+            1 * Second,
+            t0_ + duration + 0.5 * Second);
+  for (std::size_t b = 0; b < final_state.positions.size(); ++b) {
+    Position<World> const expected_position =
+        initial_state_.positions[b].value +
+        initial_state_.velocities[b].value * duration +
+        0.5 * g * duration * duration;
+    EXPECT_THAT((expected_position - final_state.positions[b].value).Norm(),
+                Lt(1E-3 * Metre));
+    EXPECT_THAT(RelativeError(initial_state_.velocities[b].value + g * duration,
+                              final_state.velocities[b].value),
+                Lt(1E-12));
+  }
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -36,3 +36,16 @@ Export[
  "planets_energy_error.cdf",
  IntegrationErrorPlot[eErrorData, names, "maximal energy error", 1.*^35],
  "CDF"];
+<<"planets_kepler_splitting_graphs.generated.wl";
+Export[
+ "planets_kepler_splitting_position_error.cdf",
+ IntegrationErrorPlot[qErrorData, names, "maximal position error", 1.*^10],
+ "CDF"];
+Export[
+ "planets_kepler_splitting_velocity_error.cdf",
+ IntegrationErrorPlot[vErrorData, names, "maximal velocity error", 1.*^4],
+ "CDF"];
+Export[
+ "planets_kepler_splitting_energy_error.cdf",
+ IntegrationErrorPlot[eErrorData, names, "maximal energy error", 1.*^35],
+ "CDF"];
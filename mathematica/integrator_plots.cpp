@@ -9,7 +9,10 @@
 
 #include "geometry/barycentre_calculator.hpp"
 #include "glog/logging.h"
+#include "integrators/ordinary_differential_equations.hpp"
 #include "integrators/sprk_integrator.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "integrators/wisdom_holman_integrator.hpp"
 #include "quantities/astronomy.hpp"
 #include "quantities/constants.hpp"
 #include "quantities/quantities.hpp"
@@ -20,6 +23,10 @@
 #include "testing_utilities/solar_system.hpp"
 
 #define INTEGRATOR(name) &integrators::name(), #name
+#define KEPLER_SPLITTING_INTEGRATOR(name) \
+    &integrators::name<ICRFJ2000Ecliptic>(), #name
+#define SRKN_INTEGRATOR(name) \
+    &integrators::name<Position<ICRFJ2000Ecliptic>>(), #name
 
 namespace principia {
 
@@ -28,11 +35,15 @@ using base::not_null;
 using constants::GravitationalConstant;
 using geometry::InnerProduct;
 using geometry::BarycentreCalculator;
+using integrators::FixedStepSizeIntegrator;
+using integrators::IntegrationProblem;
+using integrators::SpecialSecondOrderDifferentialEquation;
 using integrators::SRKNIntegrator;
 using quantities::AngularFrequency;
 using quantities::Cos;
 using quantities::Energy;
 using quantities::Length;
+using quantities::GravitationalParameter;
 using quantities::Pow;
 using quantities::Sin;
 using quantities::Speed;
@@ -136,6 +147,32 @@ std::vector<SimpleHarmonicMotionPlottedIntegrator> ReferenceMethods() {
       {INTEGRATOR(McLachlan1995SS17), 17}};
 }
 
+using PlanetaryEquation =
+    SpecialSecondOrderDifferentialEquation<Position<ICRFJ2000Ecliptic>>;
+
+struct PlanetaryPlottedIntegrator {
+  not_null<FixedStepSizeIntegrator<PlanetaryEquation> const*> integrator;
+  std::string name;
+  int evaluations;
+};
+
+// The Kepler splittings, followed by the SRKNs of |Methods| for comparison.
+// Each list is sorted as in |Methods|.
+std::vector<PlanetaryPlottedIntegrator> PlanetaryMethods() {
+  return {
+      // Kepler splittings
+      {KEPLER_SPLITTING_INTEGRATOR(WisdomHolman1991), 2},
+      {KEPLER_SPLITTING_INTEGRATOR(LaskarRobutel2001SABA2), 2},
+      {KEPLER_SPLITTING_INTEGRATOR(LaskarRobutel2001SBAB2), 3},
+      {KEPLER_SPLITTING_INTEGRATOR(LaskarRobutel2001SABA3), 3},
+      {KEPLER_SPLITTING_INTEGRATOR(LaskarRobutel2001SBAB3), 4},
+      // SRKNs
+      {SRKN_INTEGRATOR(McLachlanAtela1992Order4Optimal), 4},
+      {SRKN_INTEGRATOR(BlanesMoan2002SRKN6B), 6},
+      {SRKN_INTEGRATOR(McLachlanAtela1992Order5Optimal), 6},
+      {SRKN_INTEGRATOR(BlanesMoan2002SRKN11B), 11}};
+}
+
 }  // namespace
 
 void GenerateSimpleHarmonicMotionWorkErrorGraphs() {
@@ -468,5 +505,133 @@ void GenerateSolarSystemPlanetsWorkErrorGraph() {
   file.close();
 }
 
+void GenerateSolarSystemPlanetsKeplerSplittingWorkErrorGraph() {
+  int const last_planet = SolarSystem::kMercury;
+  Time const Δt_reference = 10 * Minute;
+  Time const duration = 1 * JulianYear;
+  int const max_evaluations = 100000;
+  double const step_reduction = 1.015;
+
+  std::vector<MassiveBody> bodies;
+  PlanetaryEquation equation;
+  PlanetaryEquation::SystemState initial_state;
+  initial_state.time = Instant();
+  {
+    not_null<std::unique_ptr<SolarSystem>> const solar_system =
+        SolarSystem::AtСпутник1Launch(SolarSystem::Accuracy::kMajorBodiesOnly);
+    SolarSystem::Bodies const solar_system_bodies =
+        solar_system->massive_bodies();
+    for (int i = 0; i <= last_planet; ++i) {
+      Trajectory<ICRFJ2000Ecliptic> const& trajectory =
+          *solar_system->trajectories()[i];
+      bodies.emplace_back(*solar_system_bodies[i]);
+      equation.gravitational_parameters.emplace_back(
+          bodies.back().gravitational_parameter());
+      initial_state.positions.emplace_back(
+          trajectory.last().degrees_of_freedom().position());
+      initial_state.velocities.emplace_back(
+          trajectory.last().degrees_of_freedom().velocity());
+    }
+  }
+  equation.compute_acceleration =
+      [&bodies](Instant const& t,
+                std::vector<Position<ICRFJ2000Ecliptic>> const& q,
+                not_null<std::vector<Vector<Acceleration, ICRFJ2000Ecliptic>>*>
+                    const result) {
+        ComputeGravitationalAcceleration<ICRFJ2000Ecliptic>(
+            t - Instant(), q, result, bodies);
+      };
+  auto const energy = [&bodies](
+      PlanetaryEquation::SystemState const& state) {
+    Energy energy;
+    for (int i = 0; i <= last_planet; ++i) {
+      // Kinetic energy.
+      energy += 0.5 * bodies[i].mass() *
+                    InnerProduct(state.velocities[i].value,
+                                 state.velocities[i].value);
+      for (int j = 0; j < i; ++j) {
+        // Potential energy.
+        energy -= GravitationalConstant * bodies[i].mass() * bodies[j].mass() /
+                      (state.positions[i].value -
+                       state.positions[j].value).Norm();
+      }
+    }
+    return energy;
+  };
+  Energy const initial_energy = energy(initial_state);
+
+  IntegrationProblem<PlanetaryEquation> problem;
+  problem.equation = equation;
+  problem.initial_state = &initial_state;
+
+  // The reference solution is only needed at the end of the integration.
+  PlanetaryEquation::SystemState reference_state;
+  LOG(INFO) << "Computing reference solution";
+  problem.t_final = initial_state.time.value + duration + Δt_reference / 2;
+  problem.append_state =
+      [&reference_state](PlanetaryEquation::SystemState const& state) {
+        reference_state = state;
+      };
+  integrators::BlanesMoan2002SRKN14A<Position<ICRFJ2000Ecliptic>>().Solve(
+      problem, Δt_reference);
+  LOG(INFO) << "Done";
+
+  std::vector<std::string> q_error_data;
+  std::vector<std::string> v_error_data;
+  std::vector<std::string> e_error_data;
+  std::vector<std::string> names;
+  for (auto const& method : PlanetaryMethods()) {
+    LOG(INFO) << method.name;
+    std::vector<Length> q_errors;
+    std::vector<Speed> v_errors;
+    std::vector<Energy> e_errors;
+    std::vector<double> evaluations;
+    // The steps divide the duration, so that all the methods are compared with
+    // the reference solution at the same time.  The first step is 30 days per
+    // evaluation.
+    for (int steps = std::ceil(duration / (method.evaluations * 30 * Day));
+         steps * method.evaluations <= max_evaluations;
+         steps = std::max(steps + 1,
+                          static_cast<int>(steps * step_reduction))) {
+      Time const Δt = duration / steps;
+      PlanetaryEquation::SystemState final_state;
+      Energy e_error;
+      problem.t_final = initial_state.time.value + duration + Δt / 2;
+      problem.append_state = [&energy, &e_error, &final_state, initial_energy](
+          PlanetaryEquation::SystemState const& state) {
+        e_error = std::max(e_error,
+                           AbsoluteError(initial_energy, energy(state)));
+        final_state = state;
+      };
+      method.integrator->Solve(problem, Δt);
+      Length q_error;
+      Speed v_error;
+      for (int body = 0; body <= last_planet; ++body) {
+        q_error = std::max(q_error,
+                           (final_state.positions[body].value -
+                            reference_state.positions[body].value).Norm());
+        v_error = std::max(v_error,
+                           (final_state.velocities[body].value -
+                            reference_state.velocities[body].value).Norm());
+      }
+      q_errors.emplace_back(q_error);
+      v_errors.emplace_back(v_error);
+      e_errors.emplace_back(e_error);
+      evaluations.emplace_back(steps * method.evaluations);
+    }
+    q_error_data.emplace_back(PlottableDataset(evaluations, q_errors));
+    v_error_data.emplace_back(PlottableDataset(evaluations, v_errors));
+    e_error_data.emplace_back(PlottableDataset(evaluations, e_errors));
+    names.emplace_back(Escape(method.name));
+  }
+  std::ofstream file;
+  file.open("planets_kepler_splitting_graphs.generated.wl");
+  file << Assign("qErrorData", q_error_data);
+  file << Assign("vErrorData", v_error_data);
+  file << Assign("eErrorData", e_error_data);
+  file << Assign("names", names);
+  file.close();
+}
+
 }  // namespace mathematica
 }  // namespace principia
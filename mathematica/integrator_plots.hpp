@@ -6,6 +6,7 @@ namespace mathematica {
 void GenerateSimpleHarmonicMotionWorkErrorGraphs();
 void GenerateKeplerProblemWorkErrorGraphs();
 void GenerateSolarSystemPlanetsWorkErrorGraph();
+void GenerateSolarSystemPlanetsKeplerSplittingWorkErrorGraph();
 
 }  // namespace mathematica
 }  // namespace principia
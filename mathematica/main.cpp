@@ -8,5 +8,7 @@ int main(int argc, char const* argv[]) {
   principia::mathematica::GenerateSimpleHarmonicMotionWorkErrorGraphs();
   principia::mathematica::GenerateKeplerProblemWorkErrorGraphs();
   principia::mathematica::GenerateSolarSystemPlanetsWorkErrorGraph();
+  principia::mathematica::
+      GenerateSolarSystemPlanetsKeplerSplittingWorkErrorGraph();
   return 0;
 }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "base/not_null.hpp"
+
+namespace principia {
+
+using base::not_null;
+
+namespace numerics {
+
+// The Lagrange coefficients, which give the state at some time as a linear
+// combination of the initial position r₀ and velocity v₀:
+//   r = f r₀ + g v₀,  v = ḟ r₀ + ġ v₀.
+struct LagrangeCoefficients {
+  double f;
+  double g;
+  double ḟ;
+  double ġ;
+};
+
+// The universal variable formulation of Kepler's equation, which covers the
+// elliptic, parabolic and hyperbolic cases uniformly (Danby, Fundamentals of
+// Celestial Mechanics, 1988, section 6.9).  The equation is solved using the
+// Laguerre-Conway iteration, which converges from a crude initial guess
+// (Conway, An improved algorithm due to Laguerre for the solution of Kepler's
+// equation, 1986).  All the quantities are in SI units, so that this class may
+// be used both for evaluating orbits and as the Keplerian step of an
+// integrator.
+class UniversalKeplerEquation {
+ public:
+  // The equation for a body at distance |r0| from a point mass with
+  // gravitational parameter |μ|, where |r0_dot_v0| is the inner product of the
+  // position and velocity of the body relative to the point mass, and
+  // |v0_squared| the square of that velocity.
+  UniversalKeplerEquation(double const μ,
+                          double const r0,
+                          double const r0_dot_v0,
+                          double const v0_squared);
+
+  // Returns the universal anomaly χ reached |Δt| after the initial state.
+  double UniversalAnomaly(double const Δt) const;
+
+  // Returns the time elapsed since the initial state when the universal anomaly
+  // is |χ|.  This is the inverse of |UniversalAnomaly|, and it doesn't require
+  // any iteration.
+  double ElapsedTime(double const χ) const;
+
+  // The Lagrange coefficients at the universal anomaly |χ|, which is reached
+  // |Δt| after the initial state.
+  LagrangeCoefficients Coefficients(double const χ, double const Δt) const;
+
+  double sqrt_μ() const;
+  double r0() const;
+
+ private:
+  // √μ, the initial distance r₀, r₀ · v₀ / √μ, and the inverse of the
+  // semimajor axis α = 2 / r₀ - v₀² / μ, which is negative for hyperbolic
+  // orbits.
+  double const sqrt_μ_;
+  double const r0_;
+  double const σ0_;
+  double const α_;
+};
+
+}  // namespace numerics
+}  // namespace principia
+
+#include "numerics/universal_kepler_equation_body.hpp"
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "numerics/universal_kepler_equation.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace numerics {
+
+namespace {
+
+// The maximum number of Laguerre-Conway iterations.  In practice convergence
+// takes fewer than 10 iterations.
+int const kMaxLaguerreConwayIterations = 50;
+
+// The Stumpff functions c₂(ψ) = (1 - cos √ψ) / ψ and
+// c₃(ψ) = (√ψ - sin √ψ) / √ψ³, continued analytically to ψ ≤ 0.
+inline void StumpffFunctions(double const ψ,
+                             not_null<double*> const c2,
+                             not_null<double*> const c3) {
+  if (std::abs(ψ) < 1) {
+    // The closed forms cancel catastrophically near 0; use the series
+    // c₂(ψ) = Σ (-ψ)ᵏ / (2k + 2)!, c₃(ψ) = Σ (-ψ)ᵏ / (2k + 3)!.  With 12 terms
+    // the truncation error is below 1 / 26!.
+    double term2 = 1.0 / 2.0;
+    double term3 = 1.0 / 6.0;
+    *c2 = 0;
+    *c3 = 0;
+    for (int k = 0; k < 12; ++k) {
+      *c2 += term2;
+      *c3 += term3;
+      term2 *= -ψ / ((2 * k + 3) * (2 * k + 4));
+      term3 *= -ψ / ((2 * k + 4) * (2 * k + 5));
+    }
+  } else if (ψ > 0) {
+    double const s = std::sqrt(ψ);
+    double const sin_half_s = std::sin(s / 2);
+    *c2 = 2 * sin_half_s * sin_half_s / ψ;
+    *c3 = (s - std::sin(s)) / (ψ * s);
+  } else {
+    double const s = std::sqrt(-ψ);
+    double const sinh_half_s = std::sinh(s / 2);
+    *c2 = -2 * sinh_half_s * sinh_half_s / ψ;
+    *c3 = (std::sinh(s) - s) / (-ψ * s);
+  }
+}
+
+}  // namespace
+
+inline UniversalKeplerEquation::UniversalKeplerEquation(
+    double const μ,
+    double const r0,
+    double const r0_dot_v0,
+    double const v0_squared)
+    : sqrt_μ_(std::sqrt(μ)),
+      r0_(r0),
+      σ0_(r0_dot_v0 / sqrt_μ_),
+      α_(2 / r0_ - v0_squared / (sqrt_μ_ * sqrt_μ_)) {
+  CHECK_LT(0, μ);
+  CHECK_LT(0, r0_);
+}
+
+inline double UniversalKeplerEquation::UniversalAnomaly(
+    double const Δt) const {
+  // Solve the universal Kepler equation
+  //   F(χ) = σ₀ χ² c₂(ψ) + (1 - α r₀) χ³ c₃(ψ) + r₀ χ - √μ Δt = 0,
+  // where ψ = α χ².  F'(χ) is the distance r at time |t|.  The initial
+  // guesses are those of Vallado, Fundamentals of Astrodynamics and
+  // Applications, 2013, algorithm 8.  For hyperbolic orbits, a linear guess is
+  // much too large when |Δt| is large, and the iteration takes forever to come
+  // back down the exponential.
+  double χ = α_ > 0 ? sqrt_μ_ * Δt * α_ : sqrt_μ_ * Δt / r0_;
+  if (α_ < 0) {
+    double const sign = Δt > 0 ? 1 : -1;
+    double const sqrt_minus_a = 1 / std::sqrt(-α_);
+    double const argument =
+        -2 * sqrt_μ_ * α_ * Δt /
+        (σ0_ + sign * sqrt_minus_a * (1 - r0_ * α_));
+    if (argument > 1) {
+      χ = sign * sqrt_minus_a * std::log(argument);
+    }
+  }
+  double previous_Δχ = std::numeric_limits<double>::infinity();
+  for (int iteration = 0;; ++iteration) {
+    CHECK_LT(iteration, kMaxLaguerreConwayIterations)
+        << "No convergence for Δt = " << Δt;
+    double const ψ = α_ * χ * χ;
+    double c2;
+    double c3;
+    StumpffFunctions(ψ, &c2, &c3);
+    double const F = σ0_ * χ * χ * c2 + (1 - α_ * r0_) * χ * χ * χ * c3 +
+                     r0_ * χ - sqrt_μ_ * Δt;
+    double const r = σ0_ * χ * (1 - ψ * c3) + (1 - α_ * r0_) * χ * χ * c2 + r0_;
+    double const dr_dχ = σ0_ * (1 - ψ * c2) + (1 - α_ * r0_) * χ * (1 - ψ * c3);
+    // The Laguerre step with n = 5.
+    int const n = 5;
+    double const Δχ =
+        n * F /
+        (r + (r >= 0 ? 1 : -1) *
+                 std::sqrt(std::abs((n - 1) * (n - 1) * r * r -
+                                    n * (n - 1) * F * dr_dχ)));
+    χ -= Δχ;
+    // Near the root the iterates wander at the level of roundoff, so we also
+    // stop as soon as the correction stops decreasing.  Far from the root,
+    // notably from the hyperbolic initial guess, the corrections need not
+    // decrease monotonically, so this only applies once the residual is small
+    // compared to the terms of the equation.
+    bool const near_root =
+        std::abs(F) <= 1E-10 * (sqrt_μ_ * std::abs(Δt) + r0_ * std::abs(χ));
+    if (std::abs(Δχ) <= 1E-15 * std::abs(χ) ||
+        (near_root && std::abs(Δχ) >= previous_Δχ) || F == 0) {
+      break;
+    }
+    previous_Δχ = std::abs(Δχ);
+  }
+  return χ;
+}
+
+inline double UniversalKeplerEquation::ElapsedTime(double const χ) const {
+  double const ψ = α_ * χ * χ;
+  double c2;
+  double c3;
+  StumpffFunctions(ψ, &c2, &c3);
+  return (σ0_ * χ * χ * c2 + (1 - α_ * r0_) * χ * χ * χ * c3 + r0_ * χ) /
+         sqrt_μ_;
+}
+
+inline LagrangeCoefficients UniversalKeplerEquation::Coefficients(
+    double const χ,
+    double const Δt) const {
+  double const ψ = α_ * χ * χ;
+  double c2;
+  double c3;
+  StumpffFunctions(ψ, &c2, &c3);
+  double const r = χ * χ * c2 + σ0_ * χ * (1 - ψ * c3) + r0_ * (1 - ψ * c2);
+  LagrangeCoefficients coefficients;
+  coefficients.f = 1 - χ * χ * c2 / r0_;
+  coefficients.g = Δt - χ * χ * χ * c3 / sqrt_μ_;
+  coefficients.ḟ = sqrt_μ_ * χ * (ψ * c3 - 1) / (r * r0_);
+  coefficients.ġ = 1 - χ * χ * c2 / r;
+  return coefficients;
+}
+
+inline double UniversalKeplerEquation::sqrt_μ() const {
+  return sqrt_μ_;
+}
+
+inline double UniversalKeplerEquation::r0() const {
+  return r0_;
+}
+
+}  // namespace numerics
+}  // namespace principia
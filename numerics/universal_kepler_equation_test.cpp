@@ -0,0 +1,42 @@
+#include "numerics/universal_kepler_equation.hpp"
+
+#include <cmath>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+
+using ::testing::Lt;
+
+namespace numerics {
+
+class UniversalKeplerEquationTest : public ::testing::Test {
+ protected:
+  // Roughly the Earth, and a body in low orbit.
+  double const μ_ = 3.986004418E14;
+  double const r0_ = 7E6;
+};
+
+// The universal anomaly is the inverse of the elapsed time, and the Lagrange
+// coefficients preserve the Wronskian f ġ - ḟ g = 1, for elliptic, barely
+// hyperbolic and hyperbolic orbits, before and after the initial state.
+TEST_F(UniversalKeplerEquationTest, Consistency) {
+  double const circular_speed = std::sqrt(μ_ / r0_);
+  for (double const speed_factor : {0.7, 1.3, 1.42, 3.0}) {
+    double const v0 = speed_factor * circular_speed;
+    UniversalKeplerEquation const equation(
+        μ_, r0_, 0.2 * r0_ * v0, v0 * v0);
+    for (double const Δt : {-1E6, -3E3, -1.0, 1E-3, 5E2, 4E4, 1E7}) {
+      double const χ = equation.UniversalAnomaly(Δt);
+      EXPECT_THAT(std::abs(equation.ElapsedTime(χ) - Δt) / std::abs(Δt),
+                  Lt(1E-12)) << speed_factor << " " << Δt;
+      LagrangeCoefficients const c = equation.Coefficients(χ, Δt);
+      EXPECT_THAT(std::abs(c.f * c.ġ - c.ḟ * c.g - 1), Lt(1E-8))
+          << speed_factor << " " << Δt;
+    }
+  }
+}
+
+}  // namespace numerics
+}  // namespace principia
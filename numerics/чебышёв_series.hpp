@@ -44,10 +44,30 @@ class ЧебышёвSeries {
   // a better approximation.
   Vector const& last_coefficient() const;
 
+  // The coefficients, starting with the one of T₀.
+  std::vector<Vector> const& coefficients() const;
+
   // Uses the Clenshaw algorithm.  |t| must be in the range [t_min, t_max].
   Vector Evaluate(Instant const& t) const;
   Variation<Vector> EvaluateDerivative(Instant const& t) const;
 
+  // Same as above, for a series of the given |degree| whose |coefficients| are
+  // not owned by a |ЧебышёвSeries|, e.g., because they are in a memory-mapped
+  // file.  |t_mean| and |two_over_duration| must be computed from the interval
+  // of the series as in the constructor.  The results are bitwise identical to
+  // those of the member functions.
+  static Vector Evaluate(Vector const* const coefficients,
+                         int const degree,
+                         Instant const& t_mean,
+                         Time::Inverse const& two_over_duration,
+                         Instant const& t);
+  static Variation<Vector> EvaluateDerivative(
+      Vector const* const coefficients,
+      int const degree,
+      Instant const& t_mean,
+      Time::Inverse const& two_over_duration,
+      Instant const& t);
+
   void WriteToMessage(
       not_null<serialization::ЧебышёвSeries*> const message) const;
   static ЧебышёвSeries ReadFromMessage(
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "geometry/grassmann.hpp"
 #include "glog/logging.h"
 #include "numerics/fixed_arrays.hpp"
 #include "numerics/newhall.mathematica.cpp"
@@ -10,10 +11,36 @@
 
 namespace principia {
 
+using geometry::Multivector;
 using quantities::QuantityOrDoubleSerializer;
 
 namespace numerics {
 
+// A helper class that serializes the coefficients of a series, which may be
+// |double|s, |Quantity|s or |Multivector|s.
+template<typename Vector>
+class ЧебышёвCoefficientSerializer
+    : public QuantityOrDoubleSerializer<
+                 Vector,
+                 serialization::ЧебышёвSeries::Coefficient> {};
+
+template<typename Scalar, typename Frame, int rank>
+class ЧебышёвCoefficientSerializer<Multivector<Scalar, Frame, rank>> {
+ public:
+  using Vector = Multivector<Scalar, Frame, rank>;
+  static void WriteToMessage(
+      Vector const& coefficient,
+      not_null<serialization::ЧебышёвSeries::Coefficient*> const message) {
+    coefficient.WriteToMessage(message->mutable_multivector());
+  }
+
+  static Vector ReadFromMessage(
+      serialization::ЧебышёвSeries::Coefficient const& message) {
+    CHECK(message.has_multivector());
+    return Vector::ReadFromMessage(message.multivector());
+  }
+};
+
 template<typename Vector>
 ЧебышёвSeries<Vector>::ЧебышёвSeries(std::vector<Vector> const& coefficients,
                                      Instant const& t_min,
@@ -80,9 +107,37 @@ Vector const& ЧебышёвSeries<Vector>::last_coefficient() const {
   return coefficients_[degree_];
 }
 
+template<typename Vector>
+std::vector<Vector> const& ЧебышёвSeries<Vector>::coefficients() const {
+  return coefficients_;
+}
+
 template<typename Vector>
 Vector ЧебышёвSeries<Vector>::Evaluate(Instant const& t) const {
-  double const scaled_t = (t - t_mean_) * two_over_duration_;
+  return Evaluate(coefficients_.data(),
+                  degree_,
+                  t_mean_,
+                  two_over_duration_,
+                  t);
+}
+
+template<typename Vector>
+Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivative(
+    Instant const& t) const {
+  return EvaluateDerivative(coefficients_.data(),
+                            degree_,
+                            t_mean_,
+                            two_over_duration_,
+                            t);
+}
+
+template<typename Vector>
+Vector ЧебышёвSeries<Vector>::Evaluate(Vector const* const coefficients,
+                                      int const degree,
+                                      Instant const& t_mean,
+                                      Time::Inverse const& two_over_duration,
+                                      Instant const& t) {
+  double const scaled_t = (t - t_mean) * two_over_duration;
   double const two_scaled_t = scaled_t + scaled_t;
   // We have to allow |scaled_t| to go slightly out of [-1, 1] because of
   // computation errors.  But if it goes too far, something is broken.
@@ -103,19 +158,23 @@ Vector ЧебышёвSeries<Vector>::Evaluate(Instant const& t) const {
   Vector* b_kplus2 = &b_kplus2_vector;
   Vector* b_kplus1 = &b_kplus1_vector;
   Vector* const& b_k = b_kplus2;  // An overlay.
-  for (int k = degree_; k >= 1; --k) {
-    *b_k = coefficients_[k] + two_scaled_t * *b_kplus1 - *b_kplus2;
+  for (int k = degree; k >= 1; --k) {
+    *b_k = coefficients[k] + two_scaled_t * *b_kplus1 - *b_kplus2;
     Vector* const last_b_k = b_k;
     b_kplus2 = b_kplus1;
     b_kplus1 = last_b_k;
   }
-  return coefficients_[0] + scaled_t * *b_kplus1 - *b_kplus2;
+  return coefficients[0] + scaled_t * *b_kplus1 - *b_kplus2;
 }
 
 template<typename Vector>
 Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivative(
-    Instant const& t) const {
-  double const scaled_t = (t - t_mean_) * two_over_duration_;
+    Vector const* const coefficients,
+    int const degree,
+    Instant const& t_mean,
+    Time::Inverse const& two_over_duration,
+    Instant const& t) {
+  double const scaled_t = (t - t_mean) * two_over_duration;
   double const two_scaled_t = scaled_t + scaled_t;
   // We have to allow |scaled_t| to go slightly out of [-1, 1] because of
   // computation errors.  But if it goes too far, something is broken.
@@ -130,23 +189,21 @@ Variation<Vector> ЧебышёвSeries<Vector>::EvaluateDerivative(
   Vector* b_kplus2 = &b_kplus2_vector;
   Vector* b_kplus1 = &b_kplus1_vector;
   Vector* const& b_k = b_kplus2;  // An overlay.
-  for (int k = degree_ - 1; k >= 1; --k) {
-    *b_k = coefficients_[k + 1] * (k + 1) +
+  for (int k = degree - 1; k >= 1; --k) {
+    *b_k = coefficients[k + 1] * (k + 1) +
            two_scaled_t * *b_kplus1 - *b_kplus2;
     Vector* const last_b_k = b_k;
     b_kplus2 = b_kplus1;
     b_kplus1 = last_b_k;
   }
-  return (coefficients_[1] + two_scaled_t * *b_kplus1 - *b_kplus2) *
-             two_over_duration_;
+  return (coefficients[1] + two_scaled_t * *b_kplus1 - *b_kplus2) *
+             two_over_duration;
 }
 
 template<typename Vector>
 void ЧебышёвSeries<Vector>::WriteToMessage(
     not_null<serialization::ЧебышёвSeries*> const message) const {
-  using Serializer =
-      QuantityOrDoubleSerializer<Vector,
-                                 serialization::ЧебышёвSeries::Coefficient>;
+  using Serializer = ЧебышёвCoefficientSerializer<Vector>;
   for (auto const& coefficient : coefficients_) {
     Serializer::WriteToMessage(coefficient, message->add_coefficient());
   }
@@ -157,9 +214,7 @@ void ЧебышёвSeries<Vector>::WriteToMessage(
 template<typename Vector>
 ЧебышёвSeries<Vector> ЧебышёвSeries<Vector>::ReadFromMessage(
     serialization::ЧебышёвSeries const& message) {
-  using Serializer =
-      QuantityOrDoubleSerializer<Vector,
-                                 serialization::ЧебышёвSeries::Coefficient>;
+  using Serializer = ЧебышёвCoefficientSerializer<Vector>;
   std::vector<Vector> coefficients;
   coefficients.reserve(message.coefficient_size());
   for (auto const& coefficient : message.coefficient()) {
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "physics/pairwise_gravity.hpp"
+
+namespace principia {
+
+using base::not_null;
+
+namespace physics {
+namespace internal {
+
+// An octree used to approximate the Newtonian accelerations between many point
+// masses in O(N log N) instead of O(N²), following Barnes and Hut, A
+// hierarchical O(N log N) force-calculation algorithm, 1986.  Like the kernels
+// of pairwise_gravity.hpp, it works on coordinates in SI units stored as
+// structures of arrays.
+class BarnesHutTree {
+ public:
+  BarnesHutTree() = default;
+
+  // Builds the tree for the bodies with indices in [begin, end[ in the
+  // |positions| and |gravitational_parameters| arrays.  Any previous content is
+  // discarded, but the storage is reused.
+  void Build(std::size_t const begin,
+             std::size_t const end,
+             R3ElementsSoA const& positions,
+             std::vector<double> const& gravitational_parameters);
+
+  // Adds to |*accelerations| the accelerations exerted by the bodies of the
+  // tree on the bodies with indices in [target_begin, target_end[, which must
+  // be bodies of the tree.  A cell of the tree that doesn't contain the target
+  // and whose size, seen from the target, is less than |opening_angle| (in
+  // radians) is replaced by a point mass at its centre of mass.  With an
+  // |opening_angle| of 0 this is the direct sum, computed in a different order.
+  // The arguments must be the ones given to |Build|.  May be called
+  // concurrently for disjoint target ranges.
+  void AddAccelerations(
+      double const opening_angle,
+      std::size_t const target_begin,
+      std::size_t const target_end,
+      R3ElementsSoA const& positions,
+      std::vector<double> const& gravitational_parameters,
+      not_null<R3ElementsSoA*> const accelerations) const;
+
+ private:
+  struct Node {
+    // The geometric centre and the half-size of the cubic cell.
+    double centre_x;
+    double centre_y;
+    double centre_z;
+    double half_size;
+    // The centre of mass and the total gravitational parameter of the bodies
+    // in the cell.
+    double barycentre_x;
+    double barycentre_y;
+    double barycentre_z;
+    double gravitational_parameter;
+    // The bodies in the cell are |bodies_[first_body, end_body[|.
+    std::int32_t first_body;
+    std::int32_t end_body;
+    // The indices in |nodes_| of the children, or -1 for the octants that have
+    // no bodies.  All -1 for a leaf.
+    std::int32_t children[8];
+    bool is_leaf;
+  };
+
+  // Adds to |nodes_| a node for the cell with the given centre and half-size
+  // containing the bodies |bodies_[first_body, end_body[|, and, recursively,
+  // its children.  Returns the index of the node.
+  std::int32_t BuildNode(std::int32_t const first_body,
+                         std::int32_t const end_body,
+                         double const centre_x,
+                         double const centre_y,
+                         double const centre_z,
+                         double const half_size,
+                         int const depth,
+                         R3ElementsSoA const& positions,
+                         std::vector<double> const& gravitational_parameters);
+
+  // The indices of the bodies in the tree, permuted so that the bodies of each
+  // cell are contiguous.
+  std::vector<std::size_t> bodies_;
+  // Scratch space for the permutation.
+  std::vector<std::size_t> scratch_;
+  // The root is at index 0.
+  std::vector<Node> nodes_;
+};
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/barnes_hut_tree_body.hpp"
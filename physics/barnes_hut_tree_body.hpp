@@ -0,0 +1,270 @@
+#pragma once
+
+#include "physics/barnes_hut_tree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace physics {
+namespace internal {
+
+namespace {
+
+// Cells with at most that many bodies are not subdivided.
+std::int32_t const kMaxBodiesPerLeaf = 8;
+// Cells at that depth are not subdivided, whatever the number of bodies they
+// contain.  This avoids infinite recursion for coincident bodies.
+int const kMaxDepth = 32;
+// Each node popped from the traversal stack pushes at most 8 children, and
+// the depth is bounded, so the stack never exceeds that size.
+int const kMaxStackSize = 8 * (kMaxDepth + 1);
+
+// The octant of the point (x, y, z) in a cell centred at (cx, cy, cz).  Bit 0
+// is set for the upper half in x, bit 1 in y and bit 2 in z.
+FORCE_INLINE int Octant(double const x,
+                        double const y,
+                        double const z,
+                        double const cx,
+                        double const cy,
+                        double const cz) {
+  return (x >= cx ? 1 : 0) | (y >= cy ? 2 : 0) | (z >= cz ? 4 : 0);
+}
+
+// Subtracts from (*ax, *ay, *az) the acceleration exerted on a body at
+// (x, y, z) by a point mass of gravitational parameter |μ2| at (x2, y2, z2).
+// Same operations as in the kernels of pairwise_gravity_body.hpp.
+FORCE_INLINE void AddAccelerationByPointMass(double const x,
+                                             double const y,
+                                             double const z,
+                                             double const x2,
+                                             double const y2,
+                                             double const z2,
+                                             double const μ2,
+                                             double* const ax,
+                                             double* const ay,
+                                             double* const az) {
+  double const Δqx = x - x2;
+  double const Δqy = y - y2;
+  double const Δqz = z - z2;
+  double const Δq_squared = Δqx * Δqx + Δqy * Δqy + Δqz * Δqz;
+  double const μ2_over_Δq_cubed =
+      μ2 * std::sqrt(Δq_squared) / (Δq_squared * Δq_squared);
+  *ax -= Δqx * μ2_over_Δq_cubed;
+  *ay -= Δqy * μ2_over_Δq_cubed;
+  *az -= Δqz * μ2_over_Δq_cubed;
+}
+
+}  // namespace
+
+inline void BarnesHutTree::Build(
+    std::size_t const begin,
+    std::size_t const end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters) {
+  CHECK_LE(begin, end);
+  nodes_.clear();
+  bodies_.clear();
+  if (begin == end) {
+    return;
+  }
+
+  // The root is the bounding cube of the bodies.
+  double min_x = positions.x[begin];
+  double min_y = positions.y[begin];
+  double min_z = positions.z[begin];
+  double max_x = min_x;
+  double max_y = min_y;
+  double max_z = min_z;
+  for (std::size_t b = begin; b < end; ++b) {
+    bodies_.push_back(b);
+    min_x = std::min(min_x, positions.x[b]);
+    min_y = std::min(min_y, positions.y[b]);
+    min_z = std::min(min_z, positions.z[b]);
+    max_x = std::max(max_x, positions.x[b]);
+    max_y = std::max(max_y, positions.y[b]);
+    max_z = std::max(max_z, positions.z[b]);
+  }
+  scratch_.resize(bodies_.size());
+  double const half_size =
+      0.5 * std::max({max_x - min_x, max_y - min_y, max_z - min_z});
+  BuildNode(0,
+            static_cast<std::int32_t>(bodies_.size()),
+            0.5 * (min_x + max_x),
+            0.5 * (min_y + max_y),
+            0.5 * (min_z + max_z),
+            half_size,
+            0 /*depth*/,
+            positions,
+            gravitational_parameters);
+}
+
+inline void BarnesHutTree::AddAccelerations(
+    double const opening_angle,
+    std::size_t const target_begin,
+    std::size_t const target_end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations) const {
+  if (nodes_.empty()) {
+    return;
+  }
+  double const opening_angle_squared = opening_angle * opening_angle;
+  std::array<std::int32_t, kMaxStackSize> stack;
+  for (std::size_t target = target_begin; target < target_end; ++target) {
+    double const x = positions.x[target];
+    double const y = positions.y[target];
+    double const z = positions.z[target];
+    double ax = 0.0;
+    double ay = 0.0;
+    double az = 0.0;
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+      Node const& node = nodes_[stack[--stack_size]];
+      if (node.is_leaf) {
+        for (std::int32_t i = node.first_body; i < node.end_body; ++i) {
+          std::size_t const b = bodies_[i];
+          if (b != target) {
+            AddAccelerationByPointMass(x, y, z,
+                                       positions.x[b],
+                                       positions.y[b],
+                                       positions.z[b],
+                                       gravitational_parameters[b],
+                                       &ax, &ay, &az);
+          }
+        }
+        continue;
+      }
+      bool const contains_target =
+          std::abs(x - node.centre_x) <= node.half_size &&
+          std::abs(y - node.centre_y) <= node.half_size &&
+          std::abs(z - node.centre_z) <= node.half_size;
+      if (!contains_target) {
+        double const Δqx = x - node.barycentre_x;
+        double const Δqy = y - node.barycentre_y;
+        double const Δqz = z - node.barycentre_z;
+        double const size = 2.0 * node.half_size;
+        if (size * size <
+                opening_angle_squared *
+                    (Δqx * Δqx + Δqy * Δqy + Δqz * Δqz)) {
+          AddAccelerationByPointMass(x, y, z,
+                                     node.barycentre_x,
+                                     node.barycentre_y,
+                                     node.barycentre_z,
+                                     node.gravitational_parameter,
+                                     &ax, &ay, &az);
+          continue;
+        }
+      }
+      for (std::int32_t const child : node.children) {
+        if (child >= 0) {
+          stack[stack_size++] = child;
+        }
+      }
+    }
+    accelerations->x[target] += ax;
+    accelerations->y[target] += ay;
+    accelerations->z[target] += az;
+  }
+}
+
+inline std::int32_t BarnesHutTree::BuildNode(
+    std::int32_t const first_body,
+    std::int32_t const end_body,
+    double const centre_x,
+    double const centre_y,
+    double const centre_z,
+    double const half_size,
+    int const depth,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters) {
+  double μ = 0.0;
+  double μx = 0.0;
+  double μy = 0.0;
+  double μz = 0.0;
+  for (std::int32_t i = first_body; i < end_body; ++i) {
+    std::size_t const b = bodies_[i];
+    double const μb = gravitational_parameters[b];
+    μ += μb;
+    μx += μb * positions.x[b];
+    μy += μb * positions.y[b];
+    μz += μb * positions.z[b];
+  }
+
+  // Note that |nodes_| may be reallocated by the recursive calls below, so we
+  // must not keep a reference to |node| across them.
+  std::int32_t const index = static_cast<std::int32_t>(nodes_.size());
+  nodes_.emplace_back();
+  Node& node = nodes_.back();
+  node.centre_x = centre_x;
+  node.centre_y = centre_y;
+  node.centre_z = centre_z;
+  node.half_size = half_size;
+  node.gravitational_parameter = μ;
+  if (μ > 0.0) {
+    node.barycentre_x = μx / μ;
+    node.barycentre_y = μy / μ;
+    node.barycentre_z = μz / μ;
+  } else {
+    node.barycentre_x = centre_x;
+    node.barycentre_y = centre_y;
+    node.barycentre_z = centre_z;
+  }
+  node.first_body = first_body;
+  node.end_body = end_body;
+  std::fill(std::begin(node.children), std::end(node.children), -1);
+  node.is_leaf =
+      end_body - first_body <= kMaxBodiesPerLeaf || depth == kMaxDepth;
+  if (node.is_leaf) {
+    return index;
+  }
+
+  // Sort the bodies by octant, using a counting sort through |scratch_|.
+  std::int32_t octant_begin[9] = {};
+  for (std::int32_t i = first_body; i < end_body; ++i) {
+    std::size_t const b = bodies_[i];
+    ++octant_begin[1 + Octant(positions.x[b], positions.y[b], positions.z[b],
+                              centre_x, centre_y, centre_z)];
+  }
+  octant_begin[0] = first_body;
+  for (int o = 1; o <= 8; ++o) {
+    octant_begin[o] += octant_begin[o - 1];
+  }
+  std::int32_t octant_end[8];
+  std::copy(octant_begin, octant_begin + 8, octant_end);
+  for (std::int32_t i = first_body; i < end_body; ++i) {
+    std::size_t const b = bodies_[i];
+    scratch_[octant_end[Octant(positions.x[b], positions.y[b], positions.z[b],
+                               centre_x, centre_y, centre_z)]++] = b;
+  }
+  std::copy(scratch_.begin() + first_body,
+            scratch_.begin() + end_body,
+            bodies_.begin() + first_body);
+
+  double const child_half_size = 0.5 * half_size;
+  for (int o = 0; o < 8; ++o) {
+    if (octant_begin[o] < octant_begin[o + 1]) {
+      std::int32_t const child =
+          BuildNode(octant_begin[o],
+                    octant_begin[o + 1],
+                    centre_x + ((o & 1) ? child_half_size : -child_half_size),
+                    centre_y + ((o & 2) ? child_half_size : -child_half_size),
+                    centre_z + ((o & 4) ? child_half_size : -child_half_size),
+                    child_half_size,
+                    depth + 1,
+                    positions,
+                    gravitational_parameters);
+      nodes_[index].children[o] = child;
+    }
+  }
+  return index;
+}
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
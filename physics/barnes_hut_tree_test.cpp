@@ -0,0 +1,177 @@
+#include "physics/barnes_hut_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/pairwise_gravity.hpp"
+#include "quantities/numbers.hpp"
+
+namespace principia {
+
+using ::testing::Eq;
+using ::testing::Lt;
+
+namespace physics {
+namespace internal {
+
+class BarnesHutTreeTest : public testing::Test {
+ protected:
+  // A disk of bodies with a few clumps, so that the tree is unbalanced.  The
+  // bodies with indices below |kFirstBody| are not part of the tree.
+  BarnesHutTreeTest()
+      : positions_(kBodies),
+        tree_accelerations_(kBodies),
+        direct_accelerations_(kBodies) {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<> radius_distribution(1E11, 5E11);
+    std::uniform_real_distribution<> angle_distribution(0, 2 * π);
+    std::uniform_real_distribution<> height_distribution(-1E9, 1E9);
+    std::uniform_real_distribution<> clump_distribution(-1E8, 1E8);
+    std::uniform_real_distribution<> μ_distribution(1E5, 1E9);
+    for (int b = 0; b < kBodies; ++b) {
+      if (b % 10 == 0 || b < kFirstBody) {
+        double const r = radius_distribution(random);
+        double const θ = angle_distribution(random);
+        positions_.x[b] = r * std::cos(θ);
+        positions_.y[b] = r * std::sin(θ);
+        positions_.z[b] = height_distribution(random);
+      } else {
+        positions_.x[b] = positions_.x[b - 1] + clump_distribution(random);
+        positions_.y[b] = positions_.y[b - 1] + clump_distribution(random);
+        positions_.z[b] = positions_.z[b - 1] + clump_distribution(random);
+      }
+      gravitational_parameters_.push_back(μ_distribution(random));
+    }
+    // The direct sum over the bodies of the tree.
+    for (std::size_t b1 = kFirstBody; b1 < kBodies; ++b1) {
+      AddGravitationalAccelerationsBetweenPointMassesScalar(
+          b1, b1 + 1, kBodies,
+          positions_,
+          gravitational_parameters_,
+          &direct_accelerations_);
+    }
+  }
+
+  // The norm of the difference between the tree and direct accelerations of
+  // body |b|, divided by the norm of its direct acceleration.
+  double RelativeError(std::size_t const b) const {
+    double const Δx = tree_accelerations_.x[b] - direct_accelerations_.x[b];
+    double const Δy = tree_accelerations_.y[b] - direct_accelerations_.y[b];
+    double const Δz = tree_accelerations_.z[b] - direct_accelerations_.z[b];
+    double const x = direct_accelerations_.x[b];
+    double const y = direct_accelerations_.y[b];
+    double const z = direct_accelerations_.z[b];
+    return std::sqrt((Δx * Δx + Δy * Δy + Δz * Δz) / (x * x + y * y + z * z));
+  }
+
+  double MaxRelativeError() const {
+    double max_relative_error = 0;
+    for (std::size_t b = kFirstBody; b < kBodies; ++b) {
+      max_relative_error = std::max(max_relative_error, RelativeError(b));
+    }
+    return max_relative_error;
+  }
+
+  double MeanRelativeError() const {
+    double sum_relative_error = 0;
+    for (std::size_t b = kFirstBody; b < kBodies; ++b) {
+      sum_relative_error += RelativeError(b);
+    }
+    return sum_relative_error / (kBodies - kFirstBody);
+  }
+
+  static int const kBodies = 2000;
+  static int const kFirstBody = 3;
+
+  R3ElementsSoA positions_;
+  std::vector<double> gravitational_parameters_;
+  R3ElementsSoA tree_accelerations_;
+  R3ElementsSoA direct_accelerations_;
+  BarnesHutTree tree_;
+};
+
+// With an opening angle of 0 the tree computes the direct sum.
+TEST_F(BarnesHutTreeTest, DirectSum) {
+  tree_.Build(kFirstBody, kBodies, positions_, gravitational_parameters_);
+  tree_.AddAccelerations(0 /*opening_angle*/,
+                         kFirstBody, kBodies,
+                         positions_,
+                         gravitational_parameters_,
+                         &tree_accelerations_);
+  EXPECT_THAT(MaxRelativeError(), Lt(1E-13));
+  // The bodies not in the tree are not touched.
+  EXPECT_THAT(tree_accelerations_.x[kFirstBody - 1], Eq(0));
+}
+
+// The error decreases with the opening angle.  We look at the mean error,
+// because the maximum error is reached for isolated bodies for which the
+// accelerations nearly cancel out.
+TEST_F(BarnesHutTreeTest, OpeningAngle) {
+  tree_.Build(kFirstBody, kBodies, positions_, gravitational_parameters_);
+  double previous_error = 1;
+  for (double const opening_angle : {1.0, 0.5, 0.25}) {
+    tree_accelerations_.Clear(0, kBodies);
+    tree_.AddAccelerations(opening_angle,
+                           kFirstBody, kBodies,
+                           positions_,
+                           gravitational_parameters_,
+                           &tree_accelerations_);
+    double const error = MeanRelativeError();
+    EXPECT_THAT(error, Lt(previous_error));
+    previous_error = error;
+  }
+  EXPECT_THAT(previous_error, Lt(1E-5));
+}
+
+// Building the tree for a subset of the bodies and the computation for
+// disjoint ranges of targets give the same result as for all the targets at
+// once.
+TEST_F(BarnesHutTreeTest, TargetRanges) {
+  tree_.Build(kFirstBody, kBodies, positions_, gravitational_parameters_);
+  tree_.AddAccelerations(0.5 /*opening_angle*/,
+                         kFirstBody, kBodies,
+                         positions_,
+                         gravitational_parameters_,
+                         &tree_accelerations_);
+  R3ElementsSoA split_accelerations(kBodies);
+  tree_.AddAccelerations(0.5 /*opening_angle*/,
+                         kFirstBody, kBodies / 3,
+                         positions_,
+                         gravitational_parameters_,
+                         &split_accelerations);
+  tree_.AddAccelerations(0.5 /*opening_angle*/,
+                         kBodies / 3, kBodies,
+                         positions_,
+                         gravitational_parameters_,
+                         &split_accelerations);
+  for (int b = 0; b < kBodies; ++b) {
+    EXPECT_THAT(split_accelerations.x[b], Eq(tree_accelerations_.x[b]));
+    EXPECT_THAT(split_accelerations.y[b], Eq(tree_accelerations_.y[b]));
+    EXPECT_THAT(split_accelerations.z[b], Eq(tree_accelerations_.z[b]));
+  }
+}
+
+// Coincident bodies don't cause infinite recursion.
+TEST_F(BarnesHutTreeTest, CoincidentBodies) {
+  for (int b = 1; b < 20; ++b) {
+    positions_.x[b] = positions_.x[0];
+    positions_.y[b] = positions_.y[0];
+    positions_.z[b] = positions_.z[0];
+  }
+  tree_.Build(0, 20, positions_, gravitational_parameters_);
+  tree_.Build(0, kBodies, positions_, gravitational_parameters_);
+  tree_.AddAccelerations(0.5 /*opening_angle*/,
+                         30, kBodies,
+                         positions_,
+                         gravitational_parameters_,
+                         &tree_accelerations_);
+  EXPECT_TRUE(std::isfinite(tree_accelerations_.x[kBodies - 1]));
+}
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
@@ -1,15 +1,21 @@
 ﻿#pragma once
 
+#include <atomic>  // NOLINT(build/c++11)
+#include <memory>
 #include <vector>
 #include <utility>
 
+#include "base/not_null.hpp"
 #include "geometry/named_quantities.hpp"
 #include "numerics/чебышёв_series.hpp"
 #include "physics/degrees_of_freedom.hpp"
+#include "physics/flat_ephemeris_format.hpp"
 #include "quantities/quantities.hpp"
+#include "serialization/physics.pb.h"
 
 namespace principia {
 
+using base::not_null;
 using geometry::Instant;
 using quantities::Length;
 using quantities::Time;
@@ -17,6 +23,13 @@ using numerics::ЧебышёвSeries;
 
 namespace physics {
 
+template<typename Frame>
+class FlatEphemeris;
+
+// One thread may |Append| to a trajectory while other threads evaluate it: the
+// readers never block, and see the series that were completed before they
+// called |empty|, |t_max| or one of the evaluation functions.  The functions
+// that don't say otherwise may be called concurrently with |Append|.
 template<typename Frame>
 class ContinuousTrajectory {
  public:
@@ -56,11 +69,13 @@ class ContinuousTrajectory {
   // Appends one point to the trajectory.  |time| must be after the last time
   // passed to |Append| if the trajectory is not empty.  The |time|s passed to
   // successive calls to |Append| must be equally spaced with the |step| given
-  // at construction.
+  // at construction.  The trajectory must not be mapped from a
+  // |FlatEphemeris|.
   void Append(Instant const& time,
               DegreesOfFreedom<Frame> const& degrees_of_freedom);
 
-  // Removes all data for times strictly less than |time|.
+  // Removes all data for times strictly less than |time|.  Must not be called
+  // concurrently with any other member function.
   void ForgetBefore(Instant const& time);
 
   // Evaluates the trajectory at the given |time|, which must be in
@@ -74,6 +89,16 @@ class ContinuousTrajectory {
   DegreesOfFreedom<Frame> EvaluateDegreesOfFreedom(Instant const& time,
                                                    Hint* const hint) const;
 
+  // The construction parameters, the series, the current degree and the points
+  // not yet incorporated in a series are serialized, so that a trajectory read
+  // from a message may be appended to exactly like the original one.  The
+  // trajectory must not be mapped from a |FlatEphemeris|.  |WriteToMessage| must
+  // not be called concurrently with |Append|.
+  void WriteToMessage(
+      not_null<serialization::ContinuousTrajectory*> const message) const;
+  static not_null<std::unique_ptr<ContinuousTrajectory>> ReadFromMessage(
+      serialization::ContinuousTrajectory const& message);
+
   // The only thing that clients may do with |Hint| objects is to
   // default-initialize them.
   class Hint {
@@ -86,11 +111,28 @@ class ContinuousTrajectory {
   };
 
  private:
-  // Returns an iterator to the series applicable for the given |time|, or
-  // |begin()| if |time| is before the first series or |end()| if |time| is
-  // after the last series.  Time complexity is O(N Log N).
-  typename std::vector<ЧебышёвSeries<Displacement<Frame>>>::const_iterator
-  FindSeriesForInstant(Instant const& time) const;
+  // Appends |series| to |series_| and makes it visible to the readers.
+  void PushBackSeries(ЧебышёвSeries<Displacement<Frame>> series);
+
+  // The series are either owned by this object, in |series_|, or in a file
+  // mapped by a |FlatEphemeris|, in |mapped_series_|.  These functions access
+  // them uniformly by index.
+  int number_of_series() const;
+  // The series at |index| in the published ones.  The trajectory must not be
+  // mapped.
+  ЧебышёвSeries<Displacement<Frame>> const& published_series(
+      int const index) const;
+  Instant series_t_min(int const index) const;
+  Instant series_t_max(int const index) const;
+  Displacement<Frame> EvaluateSeries(int const index,
+                                     Instant const& time) const;
+  Velocity<Frame> EvaluateSeriesDerivative(int const index,
+                                           Instant const& time) const;
+
+  // Returns the index of the series applicable for the given |time|, or 0 if
+  // |time| is before the first series.  |time| must not be after the last
+  // series.  Time complexity is O(Log N).
+  int FindSeriesForInstant(Instant const& time) const;
 
   // Returns true if the given |hint| is usable for the given |time|.  If it is,
   // |hint->index| is the index of the series to use.
@@ -105,8 +147,20 @@ class ContinuousTrajectory {
   int degree_;
 
   // The series are in increasing time order.  Their intervals are consecutive.
+  // Only accessed by the thread that appends; the readers go through the
+  // published fields below.
   std::vector<ЧебышёвSeries<Displacement<Frame>>> series_;
 
+  // The series visible to the readers.  |published_series_size_| is stored
+  // after |published_series_data_| and loaded before it, so a reader never
+  // sees a size larger than the buffer it reads.  When |series_| is full, its
+  // elements are copied to a larger vector and its buffer is retired instead of
+  // being freed, since readers may still be using it.  The retired buffers are
+  // freed by |ForgetBefore|, which is never concurrent with the readers.
+  std::atomic<ЧебышёвSeries<Displacement<Frame>> const*> published_series_data_;
+  std::atomic<int> published_series_size_;
+  std::vector<std::vector<ЧебышёвSeries<Displacement<Frame>>>> retired_series_;
+
   // The time at which this trajectory starts.  Set for a nonempty trajectory.
   // |first_time_ >= series_.front().t_min()|
   std::unique_ptr<Instant> first_time_;  // std::optional.
@@ -115,6 +169,17 @@ class ContinuousTrajectory {
   // nonempty trajectory.
   // |last_points_.begin()->first == series_.back().t_max()|
   std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_;
+
+  // Set for a trajectory mapped from a |FlatEphemeris|, in which case
+  // |series_| and |last_points_| are empty and the trajectory is read-only.
+  // |mapped_file_| is the beginning of the mapping, from which the offsets of
+  // the coefficients are computed.
+  char const* mapped_file_ = nullptr;
+  internal::FlatSeriesEntry const* mapped_series_ = nullptr;
+  int number_of_mapped_series_ = 0;
+
+  template<typename>
+  friend class FlatEphemeris;
 };
 
 }  // namespace physics
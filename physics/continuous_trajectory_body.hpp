@@ -9,6 +9,7 @@
 
 namespace principia {
 
+using base::make_not_null_unique;
 using testing_utilities::ULPDistance;
 
 namespace physics {
@@ -30,13 +31,15 @@ ContinuousTrajectory<Frame>::ContinuousTrajectory(Time const& step,
     : step_(step),
       low_tolerance_(low_tolerance),
       high_tolerance_(high_tolerance),
-      degree_((kMinDegree + kMaxDegree) / 2) {
+      degree_((kMinDegree + kMaxDegree) / 2),
+      published_series_data_(nullptr),
+      published_series_size_(0) {
   CHECK_LT(low_tolerance_, high_tolerance_);
 }
 
 template<typename Frame>
 bool ContinuousTrajectory<Frame>::empty() const {
-  return series_.empty();
+  return number_of_series() == 0;
 }
 
 template<typename Frame>
@@ -48,13 +51,14 @@ Instant ContinuousTrajectory<Frame>::t_min() const {
 template<typename Frame>
 Instant ContinuousTrajectory<Frame>::t_max() const {
   CHECK(!empty()) << "Empty trajectory";
-  return series_.back().t_max();
+  return series_t_max(number_of_series() - 1);
 }
 
 template<typename Frame>
 void ContinuousTrajectory<Frame>::Append(
     Instant const& time,
     DegreesOfFreedom<Frame> const& degrees_of_freedom) {
+  CHECK(mapped_series_ == nullptr) << "Append to a mapped trajectory";
   // Consistency checks.
   if (first_time_ == nullptr) {
     first_time_ = std::make_unique<Instant>(time);
@@ -69,9 +73,10 @@ void ContinuousTrajectory<Frame>::Append(
 
   if (last_points_.size() == kDivisions) {
     // These vectors are static to avoid deallocation/reallocation each time we
-    // go through this code path.
-    static std::vector<Displacement<Frame>> q(kDivisions + 1);
-    static std::vector<Velocity<Frame>> v(kDivisions + 1);
+    // go through this code path.  They are thread-local because trajectories
+    // may be appended to by different threads.
+    static thread_local std::vector<Displacement<Frame>> q(kDivisions + 1);
+    static thread_local std::vector<Velocity<Frame>> v(kDivisions + 1);
     q.clear();
     v.clear();
 
@@ -84,21 +89,21 @@ void ContinuousTrajectory<Frame>::Append(
     v.push_back(degrees_of_freedom.velocity());
 
     // Compute the approximation with the current degree.
-    series_.push_back(
+    // The series is only published once its degree has been chosen.
+    ЧебышёвSeries<Displacement<Frame>> series =
         ЧебышёвSeries<Displacement<Frame>>::NewhallApproximation(
-            degree_, q, v, last_points_.cbegin()->first, time));
+            degree_, q, v, last_points_.cbegin()->first, time);
 
-    Length error_estimate = series_.back().last_coefficient().Norm();
+    Length error_estimate = series.last_coefficient().Norm();
 
     // Increase the degree if the approximation is not accurate enough.
     while (error_estimate > high_tolerance_ && degree_ < kMaxDegree) {
       ++degree_;
       VLOG(1) << "Increasing degree for " << this << " to " <<degree_
               << " because error estimate was " << error_estimate;
-      series_.back() =
-          ЧебышёвSeries<Displacement<Frame>>::NewhallApproximation(
-              degree_, q, v, last_points_.cbegin()->first, time);
-      error_estimate = series_.back().last_coefficient().Norm();
+      series = ЧебышёвSeries<Displacement<Frame>>::NewhallApproximation(
+                   degree_, q, v, last_points_.cbegin()->first, time);
+      error_estimate = series.last_coefficient().Norm();
     }
 
     // Try to decrease the degree if the approximation is too accurate, but make
@@ -119,11 +124,12 @@ void ContinuousTrajectory<Frame>::Append(
       } else {
         degree_ = tentative_degree;
         error_estimate = tentative_error_estimate;
-        series_.back() = std::move(tentative_series);
+        series = std::move(tentative_series);
       }
     }
     VLOG(1) << "Using degree " << degree_ << " for " << this
             << " with error estimate " << error_estimate;
+    PushBackSeries(std::move(series));
 
     // Wipe-out the vector.
     last_points_.clear();
@@ -137,11 +143,22 @@ void ContinuousTrajectory<Frame>::Append(
 
 template<typename Frame>
 void ContinuousTrajectory<Frame>::ForgetBefore(Instant const& time) {
-  series_.erase(series_.begin(), FindSeriesForInstant(time));
+  int const first_index = FindSeriesForInstant(time);
+  if (mapped_series_ == nullptr) {
+    series_.erase(series_.begin(), series_.begin() + first_index);
+    published_series_data_.store(series_.data(), std::memory_order_release);
+    published_series_size_.store(static_cast<int>(series_.size()),
+                                 std::memory_order_release);
+    retired_series_.clear();
+  } else {
+    // The file is read-only, just skip the forgotten entries.
+    mapped_series_ += first_index;
+    number_of_mapped_series_ -= first_index;
+  }
 
-  // If there are no |series_| left, clear everything.  Otherwise, update the
+  // If there are no series left, clear everything.  Otherwise, update the
   // first time.
-  if (series_.empty()) {
+  if (empty()) {
     first_time_.reset();
     last_points_.clear();
   } else {
@@ -156,13 +173,13 @@ Position<Frame> ContinuousTrajectory<Frame>::EvaluatePosition(
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   if (MayUseHint(time, hint)) {
-    return series_[hint->index_].Evaluate(time) + Frame::origin;
+    return EvaluateSeries(hint->index_, time) + Frame::origin;
   } else {
-    auto const it = FindSeriesForInstant(time);
+    int const index = FindSeriesForInstant(time);
     if (hint != nullptr) {
-      hint->index_ = it - series_.cbegin();
+      hint->index_ = index;
     }
-    return it->Evaluate(time) + Frame::origin;
+    return EvaluateSeries(index, time) + Frame::origin;
   }
 }
 
@@ -173,13 +190,13 @@ Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocity(
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   if (MayUseHint(time, hint)) {
-    return series_[hint->index_].EvaluateDerivative(time);
+    return EvaluateSeriesDerivative(hint->index_, time);
   } else {
-    auto const it = FindSeriesForInstant(time);
+    int const index = FindSeriesForInstant(time);
     if (hint != nullptr) {
-      hint->index_ = it - series_.cbegin();
+      hint->index_ = index;
     }
-    return it->EvaluateDerivative(time);
+    return EvaluateSeriesDerivative(index, time);
   }
 }
 
@@ -190,35 +207,183 @@ DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
   CHECK_LE(t_min(), time);
   CHECK_GE(t_max(), time);
   if (MayUseHint(time, hint)) {
-    ЧебышёвSeries<Displacement<Frame>> const& series = series_[hint->index_];
-    return DegreesOfFreedom<Frame>(series.Evaluate(time) + Frame::origin,
-                                   series.EvaluateDerivative(time));
+    return DegreesOfFreedom<Frame>(
+               EvaluateSeries(hint->index_, time) + Frame::origin,
+               EvaluateSeriesDerivative(hint->index_, time));
   } else {
-    auto const it = FindSeriesForInstant(time);
+    int const index = FindSeriesForInstant(time);
     if (hint != nullptr) {
-      hint->index_ = it - series_.cbegin();
+      hint->index_ = index;
     }
-    return DegreesOfFreedom<Frame>(it->Evaluate(time) + Frame::origin,
-                                   it->EvaluateDerivative(time));
+    return DegreesOfFreedom<Frame>(EvaluateSeries(index, time) + Frame::origin,
+                                   EvaluateSeriesDerivative(index, time));
   }
 }
 
+template<typename Frame>
+void ContinuousTrajectory<Frame>::WriteToMessage(
+    not_null<serialization::ContinuousTrajectory*> const message) const {
+  CHECK(mapped_series_ == nullptr) << "Serialization of a mapped trajectory";
+  step_.WriteToMessage(message->mutable_step());
+  low_tolerance_.WriteToMessage(message->mutable_low_tolerance());
+  high_tolerance_.WriteToMessage(message->mutable_high_tolerance());
+  message->set_degree(degree_);
+  for (auto const& s : series_) {
+    s.WriteToMessage(message->add_series());
+  }
+  if (first_time_ != nullptr) {
+    first_time_->WriteToMessage(message->mutable_first_time());
+  }
+  for (auto const& pair : last_points_) {
+    Instant const& instant = pair.first;
+    DegreesOfFreedom<Frame> const& degrees_of_freedom = pair.second;
+    auto const instantaneous_degrees_of_freedom = message->add_last_point();
+    instant.WriteToMessage(instantaneous_degrees_of_freedom->mutable_instant());
+    degrees_of_freedom.WriteToMessage(
+        instantaneous_degrees_of_freedom->mutable_degrees_of_freedom());
+  }
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>
+ContinuousTrajectory<Frame>::ReadFromMessage(
+    serialization::ContinuousTrajectory const& message) {
+  not_null<std::unique_ptr<ContinuousTrajectory<Frame>>> continuous_trajectory =
+      make_not_null_unique<ContinuousTrajectory<Frame>>(
+          Time::ReadFromMessage(message.step()),
+          Length::ReadFromMessage(message.low_tolerance()),
+          Length::ReadFromMessage(message.high_tolerance()));
+  CHECK_LE(kMinDegree, message.degree());
+  CHECK_GE(kMaxDegree, message.degree());
+  continuous_trajectory->degree_ = message.degree();
+  continuous_trajectory->series_.reserve(message.series_size());
+  for (auto const& s : message.series()) {
+    continuous_trajectory->PushBackSeries(
+        ЧебышёвSeries<Displacement<Frame>>::ReadFromMessage(s));
+  }
+  if (message.has_first_time()) {
+    continuous_trajectory->first_time_ = std::make_unique<Instant>(
+        Instant::ReadFromMessage(message.first_time()));
+  }
+  for (auto const& l : message.last_point()) {
+    continuous_trajectory->last_points_.emplace_back(
+        Instant::ReadFromMessage(l.instant()),
+        DegreesOfFreedom<Frame>::ReadFromMessage(l.degrees_of_freedom()));
+  }
+  return continuous_trajectory;
+}
+
 template<typename Frame>
 ContinuousTrajectory<Frame>::Hint::Hint()
     : index_(std::numeric_limits<int>::max()) {}
 
 template<typename Frame>
-typename std::vector<ЧебышёвSeries<Displacement<Frame>>>::const_iterator
-ContinuousTrajectory<Frame>::FindSeriesForInstant(Instant const& time) const {
-  // Need to use |lower_bound|, not |upper_bound|, because it allows
-  // heterogeneous arguments.
-  auto const it = std::lower_bound(series_.begin(), series_.end(), time,
-                      [](ЧебышёвSeries<Displacement<Frame>> const& left,
-                         Instant const& right) {
-                        return left.t_max() < right;
-                      });
-  CHECK(it != series_.end());
-  return it;
+void ContinuousTrajectory<Frame>::PushBackSeries(
+    ЧебышёвSeries<Displacement<Frame>> series) {
+  if (series_.size() == series_.capacity()) {
+    // Pushing would reallocate the buffer that the readers are using.
+    std::vector<ЧебышёвSeries<Displacement<Frame>>> new_series;
+    new_series.reserve(std::max<std::size_t>(kDivisions, 2 * series_.size()));
+    for (auto const& s : series_) {
+      new_series.emplace_back(s.coefficients(), s.t_min(), s.t_max());
+    }
+    // Moving a vector doesn't move its buffer.
+    retired_series_.push_back(std::move(series_));
+    series_ = std::move(new_series);
+  }
+  series_.push_back(std::move(series));
+  published_series_data_.store(series_.data(), std::memory_order_release);
+  published_series_size_.store(static_cast<int>(series_.size()),
+                               std::memory_order_release);
+}
+
+template<typename Frame>
+ЧебышёвSeries<Displacement<Frame>> const&
+ContinuousTrajectory<Frame>::published_series(int const index) const {
+  return published_series_data_.load(std::memory_order_acquire)[index];
+}
+
+template<typename Frame>
+int ContinuousTrajectory<Frame>::number_of_series() const {
+  if (mapped_series_ == nullptr) {
+    return published_series_size_.load(std::memory_order_acquire);
+  } else {
+    return number_of_mapped_series_;
+  }
+}
+
+template<typename Frame>
+Instant ContinuousTrajectory<Frame>::series_t_min(int const index) const {
+  if (mapped_series_ == nullptr) {
+    return published_series(index).t_min();
+  } else {
+    return Instant() + mapped_series_[index].t_min * SIUnit<Time>();
+  }
+}
+
+template<typename Frame>
+Instant ContinuousTrajectory<Frame>::series_t_max(int const index) const {
+  if (mapped_series_ == nullptr) {
+    return published_series(index).t_max();
+  } else {
+    return Instant() + mapped_series_[index].t_max * SIUnit<Time>();
+  }
+}
+
+template<typename Frame>
+Displacement<Frame> ContinuousTrajectory<Frame>::EvaluateSeries(
+    int const index,
+    Instant const& time) const {
+  if (mapped_series_ == nullptr) {
+    return published_series(index).Evaluate(time);
+  } else {
+    internal::FlatSeriesEntry const& entry = mapped_series_[index];
+    return ЧебышёвSeries<Displacement<Frame>>::Evaluate(
+        reinterpret_cast<Displacement<Frame> const*>(
+            mapped_file_ + entry.coefficients_offset),
+        entry.degree,
+        Instant() + entry.t_mean * SIUnit<Time>(),
+        entry.two_over_duration / SIUnit<Time>(),
+        time);
+  }
+}
+
+template<typename Frame>
+Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateSeriesDerivative(
+    int const index,
+    Instant const& time) const {
+  if (mapped_series_ == nullptr) {
+    return published_series(index).EvaluateDerivative(time);
+  } else {
+    internal::FlatSeriesEntry const& entry = mapped_series_[index];
+    return ЧебышёвSeries<Displacement<Frame>>::EvaluateDerivative(
+        reinterpret_cast<Displacement<Frame> const*>(
+            mapped_file_ + entry.coefficients_offset),
+        entry.degree,
+        Instant() + entry.t_mean * SIUnit<Time>(),
+        entry.two_over_duration / SIUnit<Time>(),
+        time);
+  }
+}
+
+template<typename Frame>
+int ContinuousTrajectory<Frame>::FindSeriesForInstant(
+    Instant const& time) const {
+  // A binary search for the first series whose |t_max| is not before |time|.
+  int first = 0;
+  int count = number_of_series();
+  while (count > 0) {
+    int const half = count / 2;
+    int const middle = first + half;
+    if (series_t_max(middle) < time) {
+      first = middle + 1;
+      count -= half + 1;
+    } else {
+      count = half;
+    }
+  }
+  CHECK_LT(first, number_of_series());
+  return first;
 }
 
 template<typename Frame>
@@ -227,12 +392,12 @@ bool ContinuousTrajectory<Frame>::MayUseHint(Instant const& time,
   if (hint != nullptr) {
     // A shorthand for the index held by the |hint|.
     int& index = hint->index_;
-    if (index < series_.size() && series_[index].t_min() <= time) {
-      if (time <= series_[index].t_max()) {
+    int const size = number_of_series();
+    if (index < size && series_t_min(index) <= time) {
+      if (time <= series_t_max(index)) {
         // Use this interval.
         return true;
-      } else if (index < series_.size() - 1 &&
-                 time <= series_[index + 1].t_max()) {
+      } else if (index < size - 1 && time <= series_t_max(index + 1)) {
         // Move to the next interval.
         ++index;
         return true;
@@ -1,6 +1,8 @@
 ﻿#include "physics/continuous_trajectory.hpp"
 
+#include <atomic>  // NOLINT(build/c++11)
 #include <functional>
+#include <thread>  // NOLINT(build/c++11)
 
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
@@ -192,5 +194,138 @@ TEST_F(ContinuousTrajectoryTest, Io) {
   }
 }
 
+// Check that a trajectory read from a message evaluates to the same values as
+// the original one, and that it keeps doing so after appending more points.
+TEST_F(ContinuousTrajectoryTest, Serialization) {
+  int const kNumberOfSteps = 100;
+  Time const kStep = 3600 * Second;
+  AngularFrequency const ω = 2 * π * Radian / (40 * kStep);
+  Length const kRadius = 421700 * Kilo(Metre);
+  Instant const t0;
+
+  auto position_function = [t0, ω, kRadius](Instant const t) {
+    Angle const angle = ω * (t - t0);
+    return World::origin + Displacement<World>({kRadius * Cos(angle),
+                                                kRadius * Sin(angle),
+                                                0 * Metre});
+  };
+  auto velocity_function = [t0, ω, kRadius](Instant const t) {
+    Angle const angle = ω * (t - t0);
+    return Velocity<World>({-ω * kRadius * Sin(angle) / Radian,
+                            ω * kRadius * Cos(angle) / Radian,
+                            0 * Metre / Second});
+  };
+
+  trajectory_ = std::make_unique<ContinuousTrajectory<World>>(
+                    kStep,
+                    1 * Milli(Metre) /*low_tolerance*/,
+                    5 * Milli(Metre) /*high_tolerance*/);
+  FillTrajectory(kNumberOfSteps, kStep, position_function, velocity_function);
+
+  serialization::ContinuousTrajectory message;
+  trajectory_->WriteToMessage(&message);
+  EXPECT_EQ(kNumberOfSteps / 8, message.series_size());
+  EXPECT_EQ(kNumberOfSteps % 8, message.last_point_size());
+  EXPECT_TRUE(message.has_first_time());
+
+  not_null<std::unique_ptr<ContinuousTrajectory<World>>> const
+      deserialized_trajectory =
+          ContinuousTrajectory<World>::ReadFromMessage(message);
+  serialization::ContinuousTrajectory second_message;
+  deserialized_trajectory->WriteToMessage(&second_message);
+  EXPECT_EQ(message.SerializeAsString(), second_message.SerializeAsString());
+  EXPECT_EQ(trajectory_->t_min(), deserialized_trajectory->t_min());
+  EXPECT_EQ(trajectory_->t_max(), deserialized_trajectory->t_max());
+
+  // Append the same points to both trajectories.
+  Instant time = t0 + kNumberOfSteps * kStep;
+  for (int i = 0; i < kNumberOfSteps; ++i) {
+    time += kStep;
+    DegreesOfFreedom<World> const degrees_of_freedom(position_function(time),
+                                                     velocity_function(time));
+    trajectory_->Append(time, degrees_of_freedom);
+    deserialized_trajectory->Append(time, degrees_of_freedom);
+  }
+  EXPECT_EQ(trajectory_->t_max(), deserialized_trajectory->t_max());
+  for (Instant time = trajectory_->t_min();
+       time <= trajectory_->t_max();
+       time += kStep / 7) {
+    EXPECT_EQ(trajectory_->EvaluateDegreesOfFreedom(time, nullptr),
+              deserialized_trajectory->EvaluateDegreesOfFreedom(time, nullptr));
+  }
+
+  // An empty trajectory.
+  ContinuousTrajectory<World> const empty_trajectory(
+      kStep,
+      1 * Milli(Metre) /*low_tolerance*/,
+      5 * Milli(Metre) /*high_tolerance*/);
+  serialization::ContinuousTrajectory empty_message;
+  empty_trajectory.WriteToMessage(&empty_message);
+  EXPECT_FALSE(empty_message.has_first_time());
+  EXPECT_TRUE(
+      ContinuousTrajectory<World>::ReadFromMessage(empty_message)->empty());
+}
+
+// A reader may evaluate a trajectory while another thread appends to it, and
+// sees the same values as in a trajectory that was built beforehand.
+TEST_F(ContinuousTrajectoryTest, ConcurrentReader) {
+  int const kNumberOfSteps = 2000;
+  Time const kStep = 3600 * Second;
+  AngularFrequency const ω = 2 * π * Radian / (40 * kStep);
+  Length const kRadius = 421700 * Kilo(Metre);
+  Instant const t0;
+
+  auto position_function = [t0, ω, kRadius](Instant const t) {
+    Angle const angle = ω * (t - t0);
+    return World::origin + Displacement<World>({kRadius * Cos(angle),
+                                                kRadius * Sin(angle),
+                                                0 * Metre});
+  };
+  auto velocity_function = [t0, ω, kRadius](Instant const t) {
+    Angle const angle = ω * (t - t0);
+    return Velocity<World>({-ω * kRadius * Sin(angle) / Radian,
+                            ω * kRadius * Cos(angle) / Radian,
+                            0 * Metre / Second});
+  };
+
+  trajectory_ = std::make_unique<ContinuousTrajectory<World>>(
+                    kStep,
+                    1 * Milli(Metre) /*low_tolerance*/,
+                    5 * Milli(Metre) /*high_tolerance*/);
+  FillTrajectory(kNumberOfSteps, kStep, position_function, velocity_function);
+  std::unique_ptr<ContinuousTrajectory<World>> const reference =
+      std::move(trajectory_);
+
+  trajectory_ = std::make_unique<ContinuousTrajectory<World>>(
+                    kStep,
+                    1 * Milli(Metre) /*low_tolerance*/,
+                    5 * Milli(Metre) /*high_tolerance*/);
+  std::atomic<bool> done(false);
+  std::thread writer([this, kNumberOfSteps, kStep, &done,
+                      &position_function, &velocity_function]() {
+    FillTrajectory(kNumberOfSteps, kStep, position_function, velocity_function);
+    done = true;
+  });
+  // The last iteration starts after the writer is done, so that there is at
+  // least one evaluation even if the writer finishes before we get going.
+  int evaluations = 0;
+  ContinuousTrajectory<World>::Hint hint;
+  for (bool last = false; !last;) {
+    last = done;
+    if (!trajectory_->empty()) {
+      Instant const t_max = trajectory_->t_max();
+      EXPECT_EQ(reference->EvaluateDegreesOfFreedom(t_max, nullptr),
+                trajectory_->EvaluateDegreesOfFreedom(t_max, &hint));
+      Instant const t_mid = trajectory_->t_min() + (t_max - t0) / 2;
+      EXPECT_EQ(reference->EvaluatePosition(t_mid, nullptr),
+                trajectory_->EvaluatePosition(t_mid, nullptr));
+      ++evaluations;
+    }
+  }
+  writer.join();
+  EXPECT_EQ(reference->t_max(), trajectory_->t_max());
+  EXPECT_LT(0, evaluations);
+}
+
 }  // namespace physics
 }  // namespace principia
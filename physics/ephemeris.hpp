@@ -1,26 +1,42 @@
-#pragma once
+﻿#pragma once
 
+#include <array>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/parareal_integrator.hpp"
+#include "physics/barnes_hut_tree.hpp"
 #include "physics/continuous_trajectory.hpp"
+#include "physics/kepler_orbit.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/oblate_body.hpp"
+#include "physics/pairwise_gravity.hpp"
 #include "physics/trajectory.hpp"
+#include "serialization/physics.pb.h"
 
 namespace principia {
 
+using base::ThreadPool;
 using geometry::Position;
 using geometry::Vector;
 using integrators::AdaptiveStepSizeIntegrator;
+using integrators::AdaptiveStepSizeStatistics;
 using integrators::FixedStepSizeIntegrator;
+using integrators::PararealIntegrator;
 using integrators::SpecialSecondOrderDifferentialEquation;
+using integrators::StepSizeController;
+using integrators::kElementary;
 
 namespace physics {
 
@@ -33,8 +49,83 @@ class Ephemeris {
   using NewtonianMotionEquation =
       SpecialSecondOrderDifferentialEquation<Position<Frame>>;
 
+  // The parameters of the integration of one massless body by
+  // |FlowWithAdaptiveStep|.  The |controller| selects the step size control
+  // (see |AdaptiveStepSize|).  If |statistics| is not null, the steps and
+  // evaluations of the integration are added to it.  Both may be omitted from
+  // an aggregate initialization, in which case the elementary controller is
+  // used and no statistics are collected.
+  struct AdaptiveStepFlow {
+    not_null<Trajectory<Frame>*> trajectory;
+    Length length_integration_tolerance;
+    Speed speed_integration_tolerance;
+    Instant t;
+    StepSizeController controller;
+    AdaptiveStepSizeStatistics* statistics;
+  };
+
+  // A policy for ignoring, in the integration of massless bodies, the massive
+  // bodies whose attraction is negligible.  Every |reevaluation_interval| of
+  // integration time, the accelerations exerted by each massive body on the
+  // massless bodies are computed.  The weakest massive bodies are then skipped
+  // until the next reevaluation, as long as the displacement that their
+  // combined accelerations could cause over the interval stays below
+  // |tolerance_fraction| times the length integration tolerance.  This
+  // estimate allows for the accelerations to quadruple, i.e., for the distances
+  // to halve, during the interval.  |FlowWithFixedStep| has no tolerance of its
+  // own, so it uses the |low_fitting_tolerance| of the ephemeris.
+  struct PerturberPruning {
+    Time reevaluation_interval;
+    double tolerance_fraction;
+  };
+
+  // A policy for integrating a massless body that stays close to a |primary|,
+  // e.g., a spacecraft in low orbit, using Encke's method: the integrator
+  // carries the deviation of the massless body from a reference Keplerian orbit
+  // around the |primary|, which only changes under the effect of the
+  // perturbations and may therefore be integrated with much larger steps than
+  // the position itself.  The reference orbit is rectified, i.e., replaced by
+  // the osculating orbit, when the deviation exceeds |rectification_threshold|
+  // times the distance to the |primary|.  If |primary| is null, the primary is
+  // the body that exerts the largest acceleration on the massless body; it is
+  // reassessed every time the deviation is checked, and a change of primary
+  // causes a rectification.
+  struct EnckeIntegration {
+    MassiveBody const* primary;
+    double rectification_threshold;
+  };
+
+  // A policy for integrating the close encounters of a massless body with the
+  // massive bodies, e.g., flybys or passages at the periapsis of highly
+  // eccentric orbits, during which the steps of Cowell's method collapse.
+  // Within |radius| of a massive body, the massless body is integrated as for
+  // |EnckeIntegration| relative to a reference orbit around that body, which is
+  // rectified as specified by |rectification_threshold|.  The independent
+  // variable is the Sundman time of the reference orbit, so that a step in
+  // Sundman time corresponds to a step in time proportional to the distance to
+  // the body.
+  struct CloseEncounterRegularization {
+    Length radius;
+    double rectification_threshold;
+  };
+
+  // A policy for integrating an ensemble of massless bodies in lockstep with
+  // |FlowEnsembleWithAdaptiveStep|.  The integration is cut in segments of
+  // |regrouping_interval|.  At the beginning of each segment, the members are
+  // sorted by their dynamical timescale √(r³ / μ) with respect to the body that
+  // exerts the largest acceleration on them, and partitioned in groups in which
+  // the largest timescale is at most |grouping_ratio| times the smallest one.
+  struct EnsembleIntegration {
+    Time regrouping_interval;
+    double grouping_ratio;
+  };
+
   // Constructs an Ephemeris that owns the |bodies|.  The elements of vectors
-  // |bodies| and |initial_state| correspond to one another.
+  // |bodies| and |initial_state| correspond to one another.  If
+  // |number_of_threads| is greater than 1, the pairwise accelerations between
+  // the massive bodies are computed by that many threads, each of which
+  // handles a fixed subset of the pairs; the partial results are combined in
+  // a fixed order, so the integration is reproducible from run to run.
   Ephemeris(std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies,
             std::vector<DegreesOfFreedom<Frame>> const& initial_state,
             Instant const& initial_time,
@@ -42,7 +133,11 @@ class Ephemeris {
                 planetary_integrator,
             Time const& step,
             Length const& low_fitting_tolerance,
-            Length const& high_fitting_tolerance);
+            Length const& high_fitting_tolerance,
+            int const number_of_threads = 1);
+
+  // Stops the background prolongation, if any.
+  ~Ephemeris();
 
   // Returns the bodies in the order in which they were given at construction.
   std::vector<MassiveBody const*> const& bodies() const;
@@ -59,34 +154,383 @@ class Ephemeris {
   // The mimimum of the |t_max|s of the trajectories.
   Instant t_max() const;
 
-  // Calls |ForgetBefore| on all trajectories.
+  // Calls |ForgetBefore| on all trajectories.  With background prolongation,
+  // waits for the current integration step to complete.  The trajectories must
+  // not be evaluated concurrently.
   void ForgetBefore(Instant const& t);
 
   // Prolongs the ephemeris up to at least |t|.  After the call, |t_max() >= t|.
+  // With background prolongation, |t| becomes the latest requested time if it
+  // is after the previous one, and the call only waits if |t > t_max()|.
   void Prolong(Instant const& t);
 
+  // From now on, approximates the accelerations between the minor bodies,
+  // i.e., the spherical bodies whose gravitational parameter is less than
+  // |minor_body_gravitational_parameter|, using a Barnes-Hut tree rebuilt at
+  // each evaluation with the given |opening_angle| (see |BarnesHutTree|).  The
+  // accelerations that involve an oblate body or a spherical body above the
+  // threshold, and the accelerations on the massless bodies, are still computed
+  // exactly.  This makes the evaluation O(N Log N) in the number of minor
+  // bodies, at the cost of an error that decreases with |opening_angle|.  This
+  // setting is not serialized.
+  void UseTreeGravityForMinorBodies(
+      GravitationalParameter const& minor_body_gravitational_parameter,
+      double const opening_angle);
+
+  // From now on, integrates the massive bodies with a hierarchical multirate
+  // scheme, so that the slow bodies don't use the step chosen for the fastest
+  // ones.  The bodies are partitioned in subsystems, each made of a primary and
+  // its satellites, i.e., the less massive bodies within its Hill sphere with
+  // respect to the most massive body, and in slow bodies, which are the others.
+  // The slow bodies and the barycentres of the subsystems form the slow group;
+  // its step, the macro step, is |step| times the largest power of 2 that
+  // exceeds neither |maximum_step_multiple| nor the ratio of its dynamical
+  // timescale to the smallest one, and similarly for the step of each
+  // subsystem.  The dynamical timescale of a group is the smallest
+  // √(r³ / (μ₁ + μ₂)) over its pairs of bodies.  For each macro step, the
+  // bodies of each subsystem are first integrated relative to its barycentre,
+  // with the tidal accelerations exerted by the rest of the system, whose
+  // positions are extrapolated from the previous macro step and where the other
+  // subsystems are point masses.  The slow group is then integrated with all
+  // the interactions between the bodies, the positions of the bodies of the
+  // subsystems being interpolated.  The trajectory of each body is fitted with
+  // the step of its group.  Must be called before the first prolongation, and
+  // cannot be combined with |UseTreeGravityForMinorBodies|.  This setting is
+  // not serialized, so an ephemeris that uses it cannot be written to a
+  // message.
+  void UseMultirateIntegration(int const maximum_step_multiple);
+
+  // From now on, integrates the massive bodies with the Parareal algorithm (see
+  // |PararealIntegrator|), with the integrator passed at construction as the
+  // fine integrator, so that the prolongations over long intervals use all the
+  // threads of this object.  The prolongations are cut in windows of
+  // |number_of_slices| slices of |steps_per_slice| steps, integrated
+  // concurrently and corrected by |coarse_integrator| with
+  // |coarse_steps_per_slice| steps per slice until the discontinuities between
+  // the slices are below the |length_integration_tolerance| and
+  // |speed_integration_tolerance|.  The trajectories are then fitted to the
+  // fine solution.  The accelerations between the massive bodies of a slice are
+  // computed by a single thread.  The coarse integrations and the prolongations
+  // shorter than a window, such as those of the background prolongation, are
+  // integrated serially, with the accelerations computed by all the threads.
+  // This object must have been constructed with more than one thread, and this
+  // cannot be combined with |UseTreeGravityForMinorBodies| or
+  // |UseMultirateIntegration|.  This setting is not serialized.
+  void UsePararealIntegration(
+      FixedStepSizeIntegrator<NewtonianMotionEquation> const&
+          coarse_integrator,
+      int const number_of_slices,
+      int const steps_per_slice,
+      int const coarse_steps_per_slice,
+      Length const& length_integration_tolerance,
+      Speed const& speed_integration_tolerance);
+
+  // Starts a thread that prolongs the ephemeris so that it extends at least
+  // |look_ahead| past the latest time requested through |Prolong| or one of
+  // the |Flow| functions.  While that thread runs, the trajectories may be
+  // evaluated, and massless bodies may be flowed, concurrently with the
+  // integration of the massive bodies: the readers never wait for the
+  // integrator unless they need a time beyond |t_max()|.  The background
+  // prolongation must not already be running.
+  void StartBackgroundProlongation(Time const& look_ahead);
+
+  // Stops the background prolongation after its current integration step.  No
+  // effect if it is not running.
+  void StopBackgroundProlongation();
+
   // Integrates, until exactly |t|, the |trajectory| followed by a massless body
   // in the gravitational potential described by |*this|.  If |t > t_max()|,
   // calls |Prolong(t)| beforehand.  The |length_| and
   // |speed_integration_tolerance|s are used to compute the
-  // |tolerance_to_error_ratio| for step size control.
+  // |tolerance_to_error_ratio| for step size control.  If |pruning| is not
+  // null, the negligible massive bodies are skipped as described above.  If
+  // |regularization| is not null, the close encounters are regularized as
+  // described above; the |pruning| only applies outside of them.  The
+  // |controller| selects the step size control, and if |statistics| is not
+  // null, the steps and evaluations of the integration are added to it, e.g.,
+  // to compare the rejections of the controllers.
   void FlowWithAdaptiveStep(
       not_null<Trajectory<Frame>*> const trajectory,
       Length const& length_integration_tolerance,
       Speed const& speed_integration_tolerance,
       AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
-      Instant const& t);
+      Instant const& t,
+      PerturberPruning const* const pruning = nullptr,
+      CloseEncounterRegularization const* const regularization = nullptr,
+      StepSizeController const controller = kElementary,
+      AdaptiveStepSizeStatistics* const statistics = nullptr);
+
+  // Same as above for each of the |flows|, which may have different tolerances
+  // and final times.  Calls |Prolong| once for the largest final time
+  // beforehand.  If this object was constructed with more than one thread, the
+  // |flows| are integrated concurrently: each thread picks the next flow as soon
+  // as it is done with the previous one, so the load is balanced even if the
+  // number of steps varies widely from one flow to the next.  Flows integrated
+  // concurrently must not share their |statistics|.
+  void FlowWithAdaptiveStep(
+      std::vector<AdaptiveStepFlow> const& flows,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      PerturberPruning const* const pruning = nullptr,
+      CloseEncounterRegularization const* const regularization = nullptr);
+
+  // Same as the first |FlowWithAdaptiveStep|, but using Encke's method as
+  // described by |encke|.  The integration proceeds in segments of about one
+  // radian of the reference orbit, at the end of which the deviation is checked
+  // and the reference orbit possibly rectified.  The step size of the
+  // integrator carries over from one segment to the next.
+  void FlowWithAdaptiveStepRelativeToPrimary(
+      not_null<Trajectory<Frame>*> const trajectory,
+      Length const& length_integration_tolerance,
+      Speed const& speed_integration_tolerance,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      Instant const& t,
+      EnckeIntegration const& encke);
+
+  // Integrates, until exactly |t|, the |trajectories| of an ensemble of
+  // massless bodies, e.g., the dispersed states of a Monte-Carlo analysis,
+  // which must all end at the same time, not after |t|.  If |t > t_max()|,
+  // calls |Prolong(t)| beforehand.  The members of each group defined by
+  // |ensemble| are integrated in lockstep as a single system: the massive
+  // bodies are evaluated once per evaluation for the whole group, the
+  // accelerations that the spherical bodies exert are computed by the
+  // vectorized kernel, and a step is accepted if the tolerances are met for all
+  // the members.  The grouping keeps the members that need small steps, e.g.,
+  // during a close encounter, from imposing them on the others.  If this object
+  // was constructed with more than one thread, the groups of a segment are
+  // integrated concurrently; the result doesn't depend on the number of
+  // threads.
+  void FlowEnsembleWithAdaptiveStep(
+      std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+      Length const& length_integration_tolerance,
+      Speed const& speed_integration_tolerance,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      Instant const& t,
+      EnsembleIntegration const& ensemble);
 
   // Integrates, until at least |t|, the |trajectories| followed by massless
   // bodies in the gravitational potential described by |*this|.  The integrator
   // passed at construction is used with the given |step|.  If |t > t_max()|,
-  // calls |Prolong(t)| beforehand.
+  // calls |Prolong(t)| beforehand.  If this object was constructed with more
+  // than one thread, the |trajectories| are split in shards which are
+  // integrated concurrently; since massless bodies don't interact, the result
+  // doesn't depend on the sharding, except through the |pruning|, if any,
+  // which is done for each shard.
   void FlowWithFixedStep(
       std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
       Time const& step,
-      Instant const& t);
+      Instant const& t,
+      PerturberPruning const* const pruning = nullptr);
+
+  // The number of evaluations of the accelerations of massless bodies that were
+  // done with a |PerturberPruning| policy, and the number of those in which
+  // |body| was skipped, accumulated over all the flows since construction.
+  // The ratio of the two is the fraction of the work on |body| that was saved.
+  std::int64_t number_of_pruned_evaluations() const;
+  std::int64_t number_of_skipped_evaluations(
+      not_null<MassiveBody const*> const body) const;
+
+  // The bodies, their trajectories and the state of the integration are
+  // serialized, so that an ephemeris read from a message may be prolonged
+  // without recomputing the existing trajectories.  The integrator is not
+  // serialized and must be given to |ReadFromMessage|, as well as the number
+  // of threads to use.  With background prolongation, |WriteToMessage| waits
+  // for the current integration step to complete.
+  void WriteToMessage(not_null<serialization::Ephemeris*> const message) const;
+  static not_null<std::unique_ptr<Ephemeris>> ReadFromMessage(
+      serialization::Ephemeris const& message,
+      FixedStepSizeIntegrator<NewtonianMotionEquation> const&
+          planetary_integrator,
+      int const number_of_threads = 1);
 
  private:
+  // The state of a |PerturberPruning| policy during the integration of some
+  // massless bodies.  The vectors are indexed like |bodies_|.
+  struct PrunedPerturbers {
+    PerturberPruning policy;
+    // |policy.tolerance_fraction| times the length integration tolerance.
+    Length negligible_displacement;
+    // The |skipped| bodies were chosen at |last_reevaluation| and are valid
+    // until |next_reevaluation|.  The integrator may evaluate the accelerations
+    // outside of that interval, e.g., when it tries a step that gets rejected,
+    // and this causes a reevaluation.
+    Instant last_reevaluation;
+    Instant next_reevaluation;
+    std::vector<bool> skipped;
+    std::int64_t evaluations;
+    std::vector<std::int64_t> skipped_evaluations;
+    // Scratch space for the reevaluations.
+    std::vector<Acceleration> largest_accelerations;
+    std::vector<Vector<Acceleration, Frame>> body_accelerations;
+  };
+
+  // A group of massive bodies integrated together, with a common step, by the
+  // multirate scheme of |UseMultirateIntegration|.
+  struct MultirateGroup {
+    // The bodies of the group, in the order of the |state|: the oblate ones
+    // first, then the spherical ones.  For the slow group, the last spherical
+    // bodies are the point masses that stand for the subsystems.
+    std::vector<not_null<MassiveBody const*>> oblate_bodies;
+    std::vector<not_null<MassiveBody const*>> spherical_bodies;
+    // The indices in |bodies_| of the bodies of the group, in the order of the
+    // |state|.  The subsystems of the slow group have no index.
+    std::vector<std::size_t> indices;
+    Time step;
+    NewtonianMotionEquation equation;
+    // For a subsystem, the positions are relative to its barycentre, i.e.,
+    // they are |Frame::origin + displacement|.
+    typename NewtonianMotionEquation::SystemState state;
+
+    // The remaining fields are only used for a subsystem.  The index of the
+    // subsystem in the state of the slow group, and the ratios of the
+    // gravitational parameters of its bodies to that of the subsystem.
+    std::size_t slow_index;
+    std::vector<double> mass_fractions;
+    // The states at the steps of the current macro step, including its
+    // beginning.
+    std::vector<typename NewtonianMotionEquation::SystemState> states;
+    // The indices in the state of the slow group of its spherical bodies,
+    // except for the subsystem itself.  Their accelerations on the bodies of
+    // the subsystem are computed by the vectorized kernel, with the bodies of
+    // the subsystem first in |perturbers_positions_soa|.
+    std::vector<std::size_t> spherical_perturbers;
+    std::vector<double> perturbers_gravitational_parameters;
+    // Scratch space for the evaluation of the accelerations.
+    std::vector<Position<Frame>> absolute_positions;
+    std::vector<Vector<Acceleration, Frame>> external_accelerations;
+    internal::R3ElementsSoA perturbers_positions_soa;
+    internal::R3ElementsSoA perturbers_accelerations_soa;
+  };
+
+  // The state of the multirate scheme.  The slow group is interpolated over
+  // the last macro step, which starts at |t0|, by the quintic Hermite
+  // polynomials |q0[i] + Σ coefficients[j][i] sʲ⁺¹|, where s is the fraction
+  // of the macro step that has elapsed; these polynomials are extrapolated
+  // over the next macro step for the integration of the subsystems.
+  struct Multirate {
+    MultirateGroup slow;
+    std::vector<not_null<std::unique_ptr<MultirateGroup>>> subsystems;
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>>
+        subsystem_bodies;
+    Instant t0;
+    std::vector<Position<Frame>> q0;
+    std::array<std::vector<Displacement<Frame>>, 5> coefficients;
+    // The accelerations of the slow group at the end of the last macro step.
+    std::vector<Vector<Acceleration, Frame>> accelerations;
+    // Scratch space for the evaluation of the accelerations of the slow group,
+    // indexed like |bodies_|.
+    std::vector<Position<Frame>> all_positions;
+    std::vector<Vector<Acceleration, Frame>> all_accelerations;
+  };
+
+  // Chooses the |worker_b1_begin_| so that each of |number_of_threads|
+  // workers handles about the same number of pairs computed by the direct
+  // kernel.
+  void BalanceWorkers(int const number_of_threads);
+
+  // Calls |Prolong(t)| if the ephemeris doesn't extend to |t| or if it is
+  // prolonged in the background.
+  void ProlongIfNeeded(Instant const& t);
+
+  // Integrates the massive bodies until |t_max() >= t|.  The caller must be
+  // the only thread that integrates.
+  void ProlongSynchronously(Instant const& t);
+
+  // Integrates all the groups of the multirate scheme over one macro step and
+  // appends the results to the trajectories.
+  void AdvanceMultirateIntegration();
+
+  // The position and degrees of freedom of the body with index |i| in the slow
+  // group at |t|, given by the polynomials of the last macro step.
+  Position<Frame> InterpolateSlowGroupPosition(std::size_t const i,
+                                               Instant const& t) const;
+  DegreesOfFreedom<Frame> InterpolateSlowGroupDegreesOfFreedom(
+      std::size_t const i,
+      Instant const& t) const;
+
+  // The position relative to its barycentre of the body with index |i| in
+  // |subsystem| at |t|, interpolated from the |states| of the subsystem.
+  static Position<Frame> InterpolateSubsystemPosition(
+      MultirateGroup const& subsystem,
+      std::size_t const i,
+      Instant const& t);
+
+  // The body of the background prolongation thread.
+  void ProlongInBackground();
+
+  // Integrates one of the |flows| of |FlowWithAdaptiveStep|, which must have
+  // prolonged the ephemeris.  Only reads the state of |*this|, so flows may be
+  // integrated concurrently.
+  void FlowProlongedWithAdaptiveStep(
+      AdaptiveStepFlow const& flow,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      PerturberPruning const* const pruning,
+      CloseEncounterRegularization const* const regularization);
+
+  // Integrates |flow| using Cowell's method.  The first step tried is
+  // |*time_step|, which is set on return to a step suitable for continuing the
+  // integration.
+  void FlowProlongedWithCowell(
+      AdaptiveStepFlow const& flow,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      PerturberPruning const* const pruning,
+      not_null<Time*> const time_step);
+
+  // Integrates |flow| using Cowell's method away from the massive bodies and
+  // |FlowProlongedCloseEncounter| near them.
+  void FlowProlongedWithRegularization(
+      AdaptiveStepFlow const& flow,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      PerturberPruning const* const pruning,
+      CloseEncounterRegularization const& regularization);
+
+  // Integrates |flow| relative to the body with index |primary| in |bodies_|,
+  // in Sundman time, until |flow.t| or until the massless body is farther than
+  // |regularization.radius| from the |primary| at the end of a segment.
+  void FlowProlongedCloseEncounter(
+      AdaptiveStepFlow const& flow,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      std::size_t const primary,
+      CloseEncounterRegularization const& regularization,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints);
+
+  // Integrates the |trajectories| of one group of
+  // |FlowEnsembleWithAdaptiveStep| in lockstep until |t|.  The ephemeris must
+  // have been prolonged.  The first step tried is |*time_step|, which is set on
+  // return as for |FlowProlongedWithCowell|.
+  void FlowProlongedEnsembleGroup(
+      std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+      Length const& length_integration_tolerance,
+      Speed const& speed_integration_tolerance,
+      AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+      Instant const& t,
+      not_null<Time*> const time_step) const;
+
+  // Integrates the |trajectories| of one shard for |FlowWithFixedStep|, which
+  // must have prolonged the ephemeris.  Only reads the state of |*this|, so
+  // shards may be integrated concurrently.
+  void FlowShardWithFixedStep(
+      std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+      Time const& step,
+      Instant const& t,
+      PerturberPruning const* const pruning);
+
+  // Returns null if |pruning| is null, otherwise the state of that policy for
+  // an integration starting at |t| with the given tolerance.
+  std::unique_ptr<PrunedPerturbers> MakePrunedPerturbers(
+      PerturberPruning const* const pruning,
+      Length const& length_integration_tolerance,
+      Instant const& t) const;
+
+  // Adds the counts of |pruned_perturbers| to the statistics of |*this|.
+  void RecordPrunedPerturbers(PrunedPerturbers const& pruned_perturbers);
+
+  // Chooses the massive bodies to skip until |t + reevaluation_interval| from
+  // the |largest_accelerations| that they exerted at |t|.
+  static void PrunePerturbers(
+      Instant const& t,
+      not_null<PrunedPerturbers*> const pruned_perturbers);
+
   void AppendMassiveBodiesState(
       typename NewtonianMotionEquation::SystemState const& state);
   static void AppendMasslessBodiesState(
@@ -109,19 +553,136 @@ class Ephemeris {
       std::vector<Position<Frame>> const& positions,
       not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
 
-  // Computes the accelerations due to one body, |body1| (with index |b1| in the
-  // |hints|, |bodies_| and |trajectories_| arrays) on massless bodies at the
-  // given |positions|.  The template parameter specifies what we know about the
-  // massive body, and therefore what forces apply.
+  // Computes the accelerations due to one body, |body1|, located at |position1|,
+  // on massless bodies at the given |positions|.  The template parameter
+  // specifies what we know about the massive body, and therefore what forces
+  // apply.
   template<bool body1_is_oblate>
-  void ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
-      Instant const& t,
+  static void ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
       MassiveBody const& body1,
-      size_t const b1,
+      Position<Frame> const& position1,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
+
+  // Evaluates the position of the massive body |body1|, with index |b1| in
+  // |bodies_|, at |t| and adds the accelerations that it exerts on the massless
+  // bodies at the given |positions| to |accelerations|.  If
+  // |pruned_perturbers| is not null, does nothing if the body is skipped, and
+  // records the largest of the accelerations if |reevaluate| is true.
+  template<bool body1_is_oblate>
+  void AddGravitationalAccelerationByMassiveBodyOnMasslessBodies(
+      MassiveBody const& body1,
+      std::size_t const b1,
+      Instant const& t,
       std::vector<Position<Frame>> const& positions,
       not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
       not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
-          const hints);
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const massive_bodies_positions,
+      PrunedPerturbers* const pruned_perturbers,
+      bool const reevaluate) const;
+
+  // Returns the index in |bodies_| of the body that exerts the largest
+  // acceleration on a massless body at |position| at time |t|.
+  std::size_t DominantBody(
+      Instant const& t,
+      Position<Frame> const& position,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints) const;
+
+  // Returns the second derivative of the deviation |δ| of the massless body
+  // following |trajectory| from a Keplerian orbit around the body with index
+  // |primary| in |bodies_|, whose position relative to the |primary| is |ρ| at
+  // time |t|.  |positions| and |perturbations| must have two elements and are
+  // only used as scratch.
+  Vector<Acceleration, Frame> ComputeMasslessBodyDeviationAcceleration(
+      Trajectory<Frame> const& trajectory,
+      std::size_t const primary,
+      Instant const& t,
+      Displacement<Frame> const& ρ,
+      Displacement<Frame> const& δ,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+      const;
+
+  // Computes the second derivative of the |deviations| (stored as
+  // |Frame::origin + deviation|) of the massless body following |trajectory|
+  // from the |reference_orbit| around the body with index |primary| in
+  // |bodies_|.  The scratch arguments are as above.
+  void ComputeMasslessBodyDeviationAccelerations(
+      Trajectory<Frame> const& trajectory,
+      std::size_t const primary,
+      KeplerOrbit<Frame> const& reference_orbit,
+      Instant const& t,
+      std::vector<Position<Frame>> const& deviations,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+      const;
+
+  // Same as above, but in the Sundman time s of the |reference_orbit|,
+  // represented by the instant |reference_orbit.epoch() + s|.  In order for the
+  // equation not to depend on the velocity, the deviations δ are scaled: the
+  // |scaled_deviations| are δ / √(dt / ds).
+  void ComputeMasslessBodyRegularizedDeviationAccelerations(
+      Trajectory<Frame> const& trajectory,
+      std::size_t const primary,
+      KeplerOrbit<Frame> const& reference_orbit,
+      Instant const& sundman_time,
+      std::vector<Position<Frame>> const& scaled_deviations,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+      const;
+
+  // Computes the accelerations between the massive bodies with indices in
+  // [b1_begin, b1_end[ and the massive bodies with greater indices, and adds
+  // them to |accelerations|.  The pairs of spherical bodies are handled by the
+  // vectorized kernel, which reads the packed |positions_soa| and uses
+  // |spherical_accelerations| as scratch.  The pairs of minor bodies are
+  // skipped if there is a |tree_|.
+  void ComputeGravitationalAccelerationsBetweenMassiveBodies(
+      size_t const b1_begin,
+      size_t const b1_end,
+      std::vector<Position<Frame>> const& positions,
+      internal::R3ElementsSoA const& positions_soa,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+      not_null<internal::R3ElementsSoA*> const spherical_accelerations) const;
+
+  // Adds to |accelerations| the accelerations between the minor bodies,
+  // computed using the |tree_|, which must not be null.  |positions_soa_| must
+  // have been packed.
+  void AddMinorBodiesGravitationalAccelerations(
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
+
+  // Computes the accelerations between the bodies of |group| at the given
+  // |positions|.
+  static void ComputeGravitationalAccelerationsWithinGroup(
+      MultirateGroup const& group,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
+
+  // Computes the accelerations of the slow group at the given |positions|,
+  // where the positions of the bodies of the subsystems are interpolated.
+  void ComputeSlowGroupGravitationalAccelerations(
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
+
+  // Computes the accelerations of the bodies of |subsystem| relative to its
+  // barycentre, at the given relative |positions|.
+  void ComputeSubsystemGravitationalAccelerations(
+      not_null<MultirateGroup*> const subsystem,
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations)
+      const;
 
   // Computes the accelerations between all the massive bodies in |bodies_|.
   void ComputeMassiveBodiesGravitationalAccelerations(
@@ -129,18 +690,45 @@ class Ephemeris {
       std::vector<Position<Frame>> const& positions,
       not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations);
 
-  // Computes the acceleration exerted by the massive bodies in |bodies_| on a
-  // massless body.  The massless body may have an intrinsic acceleration
-  // described in its |trajectory| object.  The |hints| are passed to
-  // ComputeGravitationalAccelerationByMassiveBodyOnMasslessBody for efficient
-  // computation of the positions of the massive bodies.
+  // Same as above, but without threads and with scratch space local to the
+  // calling thread, so that the slices of the Parareal integration may call it
+  // concurrently.  There must be no |tree_|.
+  void ComputeMassiveBodiesGravitationalAccelerationsConcurrently(
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations)
+      const;
+
+  // Computes the acceleration exerted by the massive bodies in |bodies_| on
+  // massless bodies.  The massless bodies may have an intrinsic acceleration
+  // described in their |trajectories| objects.  The positions of the massive
+  // bodies at |t| are evaluated once, using the |hints|, and stored in
+  // |massive_bodies_positions|, which must have one element per body and is
+  // only used as scratch.  If |pruned_perturbers| is not null, the negligible
+  // massive bodies are skipped.
   void ComputeMasslessBodiesGravitationalAccelerations(
       std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
       not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
       not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
-          const hints);
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const massive_bodies_positions,
+      PrunedPerturbers* const pruned_perturbers);
+
+  // Same as |ComputeMasslessBodiesGravitationalAccelerations| without pruning,
+  // except that the accelerations exerted by the spherical bodies are computed
+  // by the vectorized kernel on the |positions| packed in |positions_soa|, and
+  // accumulated in |accelerations_soa|.  The results are bitwise identical.
+  void ComputeEnsembleGravitationalAccelerations(
+      std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+      not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+          const hints,
+      not_null<internal::R3ElementsSoA*> const positions_soa,
+      not_null<internal::R3ElementsSoA*> const accelerations_soa) const;
 
   // Computes an estimate of the ratio |tolerance / error|.
   static double ToleranceToErrorRatio(
@@ -165,7 +753,8 @@ class Ephemeris {
   // The indices in |bodies_| correspond to those in |trajectories_|.
   std::vector<not_null<ContinuousTrajectory<Frame>*>> trajectories_;
 
-  std::map<not_null<MassiveBody const*>, ContinuousTrajectory<Frame>>
+  std::map<not_null<MassiveBody const*>,
+           not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
       bodies_to_trajectories_;
 
   // This will refer to a static object returned by a factory.
@@ -174,11 +763,78 @@ class Ephemeris {
   Length const low_fitting_tolerance_;
   Length const high_fitting_tolerance_;
   typename NewtonianMotionEquation::SystemState last_state_;
+  // The integration of the massive bodies, which carries its own copy of
+  // |last_state_| and its workspace from one prolongation to the next.
+  // Created by the first call to |ProlongSynchronously|, and reset when
+  // |last_state_| is modified other than by the integration.
+  std::unique_ptr<
+      typename FixedStepSizeIntegrator<NewtonianMotionEquation>::Session>
+      planetary_integration_;
 
   int number_of_spherical_bodies_ = 0;
   int number_of_oblate_bodies_ = 0;
 
+  // Null unless more than one thread was requested at construction.
+  std::unique_ptr<ThreadPool<void>> thread_pool_;
+  // The bodies with indices in [worker_b1_begin_[i], worker_b1_begin_[i + 1][
+  // are the |body1| of the pairs handled by the i-th worker.  The boundaries
+  // are chosen so that all the workers handle about the same number of pairs.
+  std::vector<size_t> worker_b1_begin_;
+  // The accelerations computed by each worker, summed in index order at the
+  // end of each evaluation.
+  std::vector<std::vector<Vector<Acceleration, Frame>>> worker_accelerations_;
+
+  // The gravitational parameters of the |bodies_|, in SI units, in the same
+  // order.  Set at construction since the bodies are immutable.
+  std::vector<double> gravitational_parameters_;
+  // The positions of the spherical bodies in SI units, repacked at each
+  // evaluation of the massive body accelerations.  The entries for the oblate
+  // bodies are unused.
+  internal::R3ElementsSoA positions_soa_;
+  // Scratch space for the vectorized kernel, one per worker (or just one if
+  // there is no |thread_pool_|).
+  std::vector<internal::R3ElementsSoA> worker_accelerations_soa_;
+
+  // Null unless |UseTreeGravityForMinorBodies| was called, in which case the
+  // minor bodies are the ones with indices in [first_minor_body_, n[ and the
+  // accelerations between them are computed using this tree, in
+  // |tree_accelerations_soa_|.
+  std::unique_ptr<internal::BarnesHutTree> tree_;
+  double tree_opening_angle_ = 0;
+  int first_minor_body_ = 0;
+  internal::R3ElementsSoA tree_accelerations_soa_;
+
+  // Null unless |UseMultirateIntegration| was called.
+  std::unique_ptr<Multirate> multirate_;
+
+  // Null unless |UsePararealIntegration| was called, in which case it is used
+  // instead of |planetary_integrator_|.  Uses the |thread_pool_|.
+  std::unique_ptr<PararealIntegrator<Position<Frame>>> parareal_;
+
+  // The statistics of the |PerturberPruning| policies.  The skipped evaluations
+  // are indexed like |bodies_|.
+  mutable std::mutex pruning_statistics_lock_;
+  std::int64_t number_of_pruned_evaluations_ = 0;
+  std::vector<std::int64_t> number_of_skipped_evaluations_;
+
   NewtonianMotionEquation massive_bodies_equation_;
+
+  // The background prolongation.  |prolongation_lock_| is held by the
+  // background thread while it integrates, and protects |last_state_| and the
+  // trajectories against |ForgetBefore| and |WriteToMessage|.
+  // |request_lock_| protects the fields below it; it is only held briefly, so
+  // that the requests never wait for the integrator.
+  std::unique_ptr<std::thread> background_prolongation_;  // std::optional.
+  Time look_ahead_;
+  mutable std::mutex prolongation_lock_;
+  std::mutex request_lock_;
+  // Signalled when the |requested_time_| is changed or the background
+  // prolongation is stopped.
+  std::condition_variable prolongation_requested_;
+  // Signalled after each background integration step.
+  std::condition_variable prolonged_;
+  Instant requested_time_;
+  bool stop_background_prolongation_ = false;
 };
 
 }  // namespace physics
@@ -3,7 +3,14 @@
 #include "physics/ephemeris.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <limits>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
 
 #include "base/map_util.hpp"
@@ -16,13 +23,16 @@
 
 namespace principia {
 
+using base::check_not_null;
 using base::FindOrDie;
+using base::make_not_null_unique;
 using geometry::InnerProduct;
 using geometry::R3Element;
 using integrators::AdaptiveStepSize;
 using integrators::IntegrationProblem;
 using quantities::Abs;
 using quantities::Exponentiation;
+using quantities::SIUnit;
 using ::std::placeholders::_1;
 using ::std::placeholders::_2;
 using ::std::placeholders::_3;
@@ -58,6 +68,58 @@ FORCE_INLINE Vector<Acceleration, Frame>
   return axis_acceleration + radial_acceleration;
 }
 
+// The derivatives of the time t with respect to the Sundman time s of |orbit|
+// (see |KeplerOrbit|) at the point where the state relative to the point mass
+// is |state|: dt / ds = r / r₀, d²t / ds² = r · v / r₀², and
+// d³t / ds³ = (r v² - μ) / r₀³.
+template<typename Frame>
+void SundmanTimeDerivatives(KeplerOrbit<Frame> const& orbit,
+                            RelativeDegreesOfFreedom<Frame> const& state,
+                            not_null<double*> const dt_ds,
+                            not_null<Exponentiation<Time, -1>*> const d2t_ds2,
+                            not_null<Exponentiation<Time, -2>*> const d3t_ds3) {
+  Length const r0 = orbit.initial_state().displacement().Norm();
+  Length const r = state.displacement().Norm();
+  *dt_ds = r / r0;
+  *d2t_ds2 = InnerProduct(state.displacement(), state.velocity()) / (r0 * r0);
+  *d3t_ds3 = (r * InnerProduct(state.velocity(), state.velocity()) -
+              orbit.gravitational_parameter()) / (r0 * r0 * r0);
+}
+
+// The smallest √(r³ / (μ₁ + μ₂)) over the pairs of point masses with the given
+// |positions| and |gravitational_parameters|, or infinity if there are fewer
+// than two of them.
+template<typename Frame>
+Time DynamicalTimescale(
+    std::vector<Position<Frame>> const& positions,
+    std::vector<GravitationalParameter> const& gravitational_parameters) {
+  Time timescale = std::numeric_limits<double>::infinity() * SIUnit<Time>();
+  for (std::size_t b1 = 0; b1 < positions.size(); ++b1) {
+    for (std::size_t b2 = b1 + 1; b2 < positions.size(); ++b2) {
+      Length const r = (positions[b1] - positions[b2]).Norm();
+      timescale = std::min(
+          timescale,
+          Sqrt(r * r * r / (gravitational_parameters[b1] +
+                            gravitational_parameters[b2])));
+    }
+  }
+  return timescale;
+}
+
+// Permutes the elements of |*v| so that the element at index |i| is the one
+// that was at index |order[i]|.
+template<typename T>
+void Permute(std::vector<std::size_t> const& order,
+             not_null<std::vector<T>*> const v) {
+  CHECK_EQ(order.size(), v->size());
+  std::vector<T> permuted;
+  permuted.reserve(v->size());
+  for (std::size_t const i : order) {
+    permuted.push_back(std::move((*v)[i]));
+  }
+  v->swap(permuted);
+}
+
 }  // namespace
 
 template<typename Frame>
@@ -69,13 +131,15 @@ Ephemeris<Frame>::Ephemeris(
         planetary_integrator,
     Time const& step,
     Length const& low_fitting_tolerance,
-    Length const& high_fitting_tolerance)
+    Length const& high_fitting_tolerance,
+    int const number_of_threads)
     : planetary_integrator_(planetary_integrator),
       step_(step),
       low_fitting_tolerance_(low_fitting_tolerance),
       high_fitting_tolerance_(high_fitting_tolerance) {
   CHECK(!bodies.empty());
   CHECK_EQ(bodies.size(), initial_state.size());
+  CHECK_LE(1, number_of_threads);
 
   last_state_.time = initial_time;
 
@@ -86,13 +150,14 @@ Ephemeris<Frame>::Ephemeris(
     unowned_bodies_.push_back(body.get());
 
     auto const inserted = bodies_to_trajectories_.emplace(
-                              std::piecewise_construct,
-                              std::forward_as_tuple(body.get()),
-                              std::forward_as_tuple(step_,
-                                                    low_fitting_tolerance_,
-                                                    high_fitting_tolerance_));
+                              body.get(),
+                              make_not_null_unique<ContinuousTrajectory<Frame>>(
+                                  step_,
+                                  low_fitting_tolerance_,
+                                  high_fitting_tolerance_));
     CHECK(inserted.second);
-    ContinuousTrajectory<Frame>* const trajectory = &inserted.first->second;
+    ContinuousTrajectory<Frame>* const trajectory =
+        inserted.first->second.get();
     trajectory->Append(initial_time, degrees_of_freedom);
 
     if (body->is_oblate()) {
@@ -116,11 +181,31 @@ Ephemeris<Frame>::Ephemeris(
     }
   }
 
+  first_minor_body_ = bodies_.size();
+  if (number_of_threads > 1) {
+    thread_pool_ = std::make_unique<ThreadPool<void>>(number_of_threads);
+  }
+  BalanceWorkers(number_of_threads);
+
+  for (auto const& body : bodies_) {
+    gravitational_parameters_.push_back(
+        body->gravitational_parameter() / SIUnit<GravitationalParameter>());
+    massive_bodies_equation_.gravitational_parameters.push_back(
+        body->gravitational_parameter());
+  }
+  positions_soa_.resize(bodies_.size());
+  number_of_skipped_evaluations_.resize(bodies_.size());
+
   massive_bodies_equation_.compute_acceleration =
       std::bind(&Ephemeris::ComputeMassiveBodiesGravitationalAccelerations,
                 this, _1, _2, _3);
 }
 
+template<typename Frame>
+Ephemeris<Frame>::~Ephemeris() {
+  StopBackgroundProlongation();
+}
+
 template<typename Frame>
 std::vector<MassiveBody const*> const& Ephemeris<Frame>::bodies() const {
   return unowned_bodies_;
@@ -129,13 +214,13 @@ std::vector<MassiveBody const*> const& Ephemeris<Frame>::bodies() const {
 template<typename Frame>
 ContinuousTrajectory<Frame> const& Ephemeris<Frame>::trajectory(
     not_null<MassiveBody const*> body) const {
-  return FindOrDie(bodies_to_trajectories_, body);
+  return *FindOrDie(bodies_to_trajectories_, body);
 }
 
 template<typename Frame>
 bool Ephemeris<Frame>::empty() const {
   for (auto const& pair : bodies_to_trajectories_) {
-    ContinuousTrajectory<Frame> const& trajectory = pair.second;
+    ContinuousTrajectory<Frame> const& trajectory = *pair.second;
     if (trajectory.empty()) {
       return true;
     }
@@ -147,7 +232,7 @@ template<typename Frame>
 Instant Ephemeris<Frame>::t_min() const {
   Instant t_min;
   for (auto const& pair : bodies_to_trajectories_) {
-    ContinuousTrajectory<Frame> const& trajectory = pair.second;
+    ContinuousTrajectory<Frame> const& trajectory = *pair.second;
     t_min = std::max(t_min, trajectory.t_min());
   }
   return t_min;
@@ -155,9 +240,9 @@ Instant Ephemeris<Frame>::t_min() const {
 
 template<typename Frame>
 Instant Ephemeris<Frame>::t_max() const {
-  Instant t_max = bodies_to_trajectories_.begin()->second.t_max();
+  Instant t_max = bodies_to_trajectories_.begin()->second->t_max();
   for (auto const& pair : bodies_to_trajectories_) {
-    ContinuousTrajectory<Frame> const& trajectory = pair.second;
+    ContinuousTrajectory<Frame> const& trajectory = *pair.second;
     t_max = std::min(t_max, trajectory.t_max());
   }
   return t_max;
@@ -165,31 +250,396 @@ Instant Ephemeris<Frame>::t_max() const {
 
 template<typename Frame>
 void Ephemeris<Frame>::ForgetBefore(Instant const& t) {
+  std::lock_guard<std::mutex> prolongation_lock(prolongation_lock_);
+  // The background thread reads the trajectories while it waits for requests.
+  std::lock_guard<std::mutex> request_lock(request_lock_);
   for (auto const& pair : bodies_to_trajectories_) {
-    ContinuousTrajectory<Frame>& trajectory = pair.second;
+    ContinuousTrajectory<Frame>& trajectory = *pair.second;
     trajectory.ForgetBefore(t);
   }
 }
 
 template<typename Frame>
 void Ephemeris<Frame>::Prolong(Instant const& t) {
-  IntegrationProblem<NewtonianMotionEquation> problem;
-  problem.equation = massive_bodies_equation_;
-  problem.append_state =
-      std::bind(&Ephemeris::AppendMassiveBodiesState, this, _1);
-  problem.t_final = t;
-  problem.initial_state = &last_state_;
+  if (background_prolongation_ == nullptr) {
+    ProlongSynchronously(t);
+  } else {
+    std::unique_lock<std::mutex> l(request_lock_);
+    if (requested_time_ < t) {
+      requested_time_ = t;
+      prolongation_requested_.notify_one();
+    }
+    prolonged_.wait(l, [this, &t]() { return !empty() && t <= t_max(); });
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::UseTreeGravityForMinorBodies(
+    GravitationalParameter const& minor_body_gravitational_parameter,
+    double const opening_angle) {
+  CHECK_LE(0, opening_angle);
+  CHECK(multirate_ == nullptr) << "Tree gravity with multirate integration";
+  CHECK(parareal_ == nullptr) << "Tree gravity with Parareal integration";
+  std::lock_guard<std::mutex> l(prolongation_lock_);
+
+  // Reorder the spherical bodies so that the minor ones come last, keeping
+  // the order within each group.  |order[i]| is the former index of the body
+  // that goes at index |i|.
+  std::vector<std::size_t> order;
+  for (std::size_t b = 0; b < number_of_oblate_bodies_; ++b) {
+    order.push_back(b);
+  }
+  for (bool const minor : {false, true}) {
+    if (minor) {
+      first_minor_body_ = order.size();
+    }
+    for (std::size_t b = number_of_oblate_bodies_; b < bodies_.size(); ++b) {
+      if ((bodies_[b]->gravitational_parameter() <
+               minor_body_gravitational_parameter) == minor) {
+        order.push_back(b);
+      }
+    }
+  }
+  Permute(order, check_not_null(&bodies_));
+  Permute(order, check_not_null(&trajectories_));
+  Permute(order, check_not_null(&last_state_.positions));
+  Permute(order, check_not_null(&last_state_.velocities));
+  Permute(order, check_not_null(&gravitational_parameters_));
+  Permute(order,
+          check_not_null(&massive_bodies_equation_.gravitational_parameters));
+  // The session has its own copy of the state, in the old order.
+  planetary_integration_.reset();
+  {
+    std::lock_guard<std::mutex> l(pruning_statistics_lock_);
+    Permute(order, check_not_null(&number_of_skipped_evaluations_));
+  }
+  for (std::size_t b = number_of_oblate_bodies_; b < bodies_.size(); ++b) {
+    spherical_bodies_[b - number_of_oblate_bodies_] = bodies_[b].get();
+  }
+
+  tree_ = std::make_unique<internal::BarnesHutTree>();
+  tree_opening_angle_ = opening_angle;
+  tree_accelerations_soa_.resize(bodies_.size());
+  BalanceWorkers(thread_pool_ == nullptr ? 1 : thread_pool_->size());
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::UseMultirateIntegration(
+    int const maximum_step_multiple) {
+  CHECK_LE(1, maximum_step_multiple);
+  CHECK_LE(2, bodies_.size());
+  CHECK(tree_ == nullptr) << "Multirate integration with tree gravity";
+  CHECK(multirate_ == nullptr) << "Multirate integration already in use";
+  CHECK(parareal_ == nullptr)
+      << "Multirate integration with Parareal integration";
+  std::lock_guard<std::mutex> l(prolongation_lock_);
+  CHECK(empty()) << "Multirate integration after the first prolongation";
+
+  std::size_t const n = bodies_.size();
+  std::vector<Position<Frame>> positions;
+  std::vector<GravitationalParameter> gravitational_parameters;
+  for (std::size_t b = 0; b < n; ++b) {
+    positions.push_back(last_state_.positions[b].value);
+    gravitational_parameters.push_back(bodies_[b]->gravitational_parameter());
+  }
+
+  // Find the satellites.  |primaries[b]| is the index of the most massive body
+  // whose Hill sphere contains |b|, or |n| if there is none.  Since a primary
+  // is more massive than its satellites, following the primaries always
+  // terminates, and the satellites of satellites are attached to the outermost
+  // primary.
+  std::size_t const central =
+      std::max_element(gravitational_parameters.begin(),
+                       gravitational_parameters.end()) -
+      gravitational_parameters.begin();
+  std::vector<std::size_t> primaries(n, n);
+  for (std::size_t b = 0; b < n; ++b) {
+    if (b == central) {
+      continue;
+    }
+    for (std::size_t p = 0; p < n; ++p) {
+      if (p == b || p == central ||
+          gravitational_parameters[p] <= gravitational_parameters[b] ||
+          (primaries[b] != n &&
+           gravitational_parameters[p] <=
+               gravitational_parameters[primaries[b]])) {
+        continue;
+      }
+      Length const hill_radius =
+          (positions[p] - positions[central]).Norm() *
+          std::cbrt(gravitational_parameters[p] /
+                    (3 * gravitational_parameters[central]));
+      if ((positions[b] - positions[p]).Norm() < hill_radius) {
+        primaries[b] = p;
+      }
+    }
+  }
+  std::vector<bool> has_satellites(n, false);
+  for (std::size_t b = 0; b < n; ++b) {
+    while (primaries[b] != n && primaries[primaries[b]] != n) {
+      primaries[b] = primaries[primaries[b]];
+    }
+    if (primaries[b] != n) {
+      has_satellites[primaries[b]] = true;
+    }
+  }
+
+  // Build the groups.  Since the oblate bodies come first in |bodies_|, they
+  // also come first in each group.
+  auto multirate = std::make_unique<Multirate>();
+  MultirateGroup& slow = multirate->slow;
+  std::vector<std::size_t> subsystem_indices(n, n);
+  for (std::size_t b = 0; b < n; ++b) {
+    std::size_t const primary = primaries[b] == n ? b : primaries[b];
+    MultirateGroup* group;
+    if (has_satellites[primary]) {
+      if (subsystem_indices[primary] == n) {
+        subsystem_indices[primary] = multirate->subsystems.size();
+        multirate->subsystems.push_back(
+            make_not_null_unique<MultirateGroup>());
+      }
+      group = multirate->subsystems[subsystem_indices[primary]].get();
+    } else {
+      group = &slow;
+    }
+    if (bodies_[b]->is_oblate()) {
+      group->oblate_bodies.push_back(bodies_[b].get());
+    } else {
+      group->spherical_bodies.push_back(bodies_[b].get());
+    }
+    group->indices.push_back(b);
+  }
+
+  slow.state.time = last_state_.time;
+  std::vector<GravitationalParameter> slow_gravitational_parameters;
+  for (std::size_t const b : slow.indices) {
+    slow.state.positions.push_back(last_state_.positions[b].value);
+    slow.state.velocities.push_back(last_state_.velocities[b].value);
+    slow_gravitational_parameters.push_back(gravitational_parameters[b]);
+  }
+  std::vector<Time> subsystem_timescales;
+  for (auto const& subsystem : multirate->subsystems) {
+    // The barycentre of the subsystem goes in the slow group, and its bodies
+    // are integrated relative to it.
+    std::size_t const primary = subsystem->indices.front();
+    GravitationalParameter total_gravitational_parameter;
+    std::vector<GravitationalParameter> subsystem_gravitational_parameters;
+    for (std::size_t const b : subsystem->indices) {
+      total_gravitational_parameter += gravitational_parameters[b];
+      subsystem_gravitational_parameters.push_back(
+          gravitational_parameters[b]);
+    }
+    Displacement<Frame> barycentre_displacement;
+    Velocity<Frame> barycentre_velocity;
+    for (std::size_t const b : subsystem->indices) {
+      double const mass_fraction =
+          gravitational_parameters[b] / total_gravitational_parameter;
+      subsystem->mass_fractions.push_back(mass_fraction);
+      barycentre_displacement +=
+          mass_fraction * (positions[b] - positions[primary]);
+      barycentre_velocity += mass_fraction * last_state_.velocities[b].value;
+    }
+    Position<Frame> const barycentre =
+        positions[primary] + barycentre_displacement;
+
+    subsystem->slow_index = slow.state.positions.size();
+    multirate->subsystem_bodies.push_back(
+        make_not_null_unique<MassiveBody>(total_gravitational_parameter));
+    slow.spherical_bodies.push_back(multirate->subsystem_bodies.back().get());
+    slow.state.positions.push_back(barycentre);
+    slow.state.velocities.push_back(barycentre_velocity);
+    slow_gravitational_parameters.push_back(total_gravitational_parameter);
+
+    subsystem->state.time = last_state_.time;
+    std::vector<Position<Frame>> subsystem_positions;
+    for (std::size_t const b : subsystem->indices) {
+      subsystem->state.positions.push_back(
+          Frame::origin + (positions[b] - barycentre));
+      subsystem->state.velocities.push_back(
+          last_state_.velocities[b].value - barycentre_velocity);
+      subsystem_positions.push_back(positions[b]);
+    }
+    subsystem->absolute_positions.resize(subsystem->indices.size());
+    subsystem->external_accelerations.resize(subsystem->indices.size());
+    subsystem_timescales.push_back(
+        DynamicalTimescale(subsystem_positions,
+                           subsystem_gravitational_parameters));
+  }
+
+  // Choose the steps.
+  std::vector<Position<Frame>> slow_positions;
+  for (auto const& position : slow.state.positions) {
+    slow_positions.push_back(position.value);
+  }
+  Time const slow_timescale =
+      DynamicalTimescale(slow_positions, slow_gravitational_parameters);
+  Time const smallest_timescale =
+      std::min(slow_timescale,
+               subsystem_timescales.empty()
+                   ? slow_timescale
+                   : *std::min_element(subsystem_timescales.begin(),
+                                       subsystem_timescales.end()));
+  auto const step_multiple = [maximum_step_multiple, smallest_timescale](
+      Time const& timescale) {
+    int multiple = 1;
+    while (2 * multiple <= maximum_step_multiple &&
+           2 * multiple * smallest_timescale <= timescale) {
+      multiple *= 2;
+    }
+    return multiple;
+  };
+  int const slow_step_multiple = step_multiple(slow_timescale);
+  slow.step = slow_step_multiple * step_;
+  for (std::size_t s = 0; s < multirate->subsystems.size(); ++s) {
+    // The subsystems must be integrated over whole macro steps.
+    multirate->subsystems[s]->step =
+        std::min(step_multiple(subsystem_timescales[s]), slow_step_multiple) *
+        step_;
+  }
+
+  std::size_t const slow_number_of_oblate_bodies = slow.oblate_bodies.size();
+  for (auto const& subsystem : multirate->subsystems) {
+    // The subsystems are not isolated, so their equations don't get
+    // gravitational parameters: a Keplerian splitting wouldn't apply.
+    for (std::size_t const b : subsystem->indices) {
+      subsystem->perturbers_gravitational_parameters.push_back(
+          gravitational_parameters[b] / SIUnit<GravitationalParameter>());
+    }
+    for (std::size_t i = slow_number_of_oblate_bodies;
+         i < slow_positions.size();
+         ++i) {
+      if (i != subsystem->slow_index) {
+        subsystem->spherical_perturbers.push_back(i);
+        subsystem->perturbers_gravitational_parameters.push_back(
+            slow_gravitational_parameters[i] /
+            SIUnit<GravitationalParameter>());
+      }
+    }
+    subsystem->perturbers_positions_soa.resize(
+        subsystem->perturbers_gravitational_parameters.size());
+    subsystem->perturbers_accelerations_soa.resize(
+        subsystem->perturbers_gravitational_parameters.size());
+  }
+
+  slow.equation.gravitational_parameters = slow_gravitational_parameters;
+  slow.equation.compute_acceleration =
+      std::bind(&Ephemeris::ComputeSlowGroupGravitationalAccelerations,
+                this, _1, _2, _3);
+  for (auto const& subsystem : multirate->subsystems) {
+    subsystem->equation.compute_acceleration =
+        std::bind(&Ephemeris::ComputeSubsystemGravitationalAccelerations,
+                  this, subsystem.get(), _1, _2, _3);
+    subsystem->states.push_back(subsystem->state);
+  }
+  multirate->all_positions.resize(n);
+  multirate->all_accelerations.resize(n);
+
+  // Until the first macro step, the slow group is extrapolated by its Taylor
+  // polynomials of degree 2.
+  multirate_ = std::move(multirate);
+  std::size_t const slow_size = slow_positions.size();
+  Time const& macro_step = multirate_->slow.step;
+  multirate_->t0 = last_state_.time.value;
+  multirate_->q0 = slow_positions;
+  multirate_->accelerations.resize(slow_size);
+  ComputeSlowGroupGravitationalAccelerations(last_state_.time.value,
+                                             slow_positions,
+                                             &multirate_->accelerations);
+  for (auto& coefficients : multirate_->coefficients) {
+    coefficients.assign(slow_size, Displacement<Frame>());
+  }
+  for (std::size_t i = 0; i < slow_size; ++i) {
+    multirate_->coefficients[0][i] =
+        multirate_->slow.state.velocities[i].value * macro_step;
+    multirate_->coefficients[1][i] =
+        0.5 * multirate_->accelerations[i] * macro_step * macro_step;
+  }
+
+  // Restart the trajectories with the steps of their groups.
+  auto const restart_trajectories = [this](MultirateGroup const& group) {
+    for (std::size_t const b : group.indices) {
+      auto& trajectory =
+          FindOrDie(bodies_to_trajectories_, bodies_[b].get());
+      trajectory = make_not_null_unique<ContinuousTrajectory<Frame>>(
+                       group.step,
+                       low_fitting_tolerance_,
+                       high_fitting_tolerance_);
+      trajectory->Append(last_state_.time.value,
+                         DegreesOfFreedom<Frame>(
+                             last_state_.positions[b].value,
+                             last_state_.velocities[b].value));
+      trajectories_[b] = trajectory.get();
+    }
+  };
+  restart_trajectories(multirate_->slow);
+  for (auto const& subsystem : multirate_->subsystems) {
+    restart_trajectories(*subsystem);
+  }
+
+  LOG(INFO) << "Multirate integration with a macro step of " << macro_step
+            << " for " << multirate_->slow.indices.size() << " bodies and "
+            << multirate_->subsystems.size() << " subsystems";
+}
 
-  // Perform the integration.  Note that we may have to iterate until |t_max()|
-  // actually reaches |t| because the last series may not be fully determined
-  // after the first integration.
-  do {
-    planetary_integrator_.Solve(problem, step_);
-    // Here |problem.initial_state| still points at |last_state_|, which is the
-    // state at the end of the previous call to |Solve|.  It is therefore the
-    // right initial state for the next call to |Solve|, if any.
-    problem.t_final += step_;
-  } while (t_max() < t);
+template<typename Frame>
+void Ephemeris<Frame>::UsePararealIntegration(
+    FixedStepSizeIntegrator<NewtonianMotionEquation> const& coarse_integrator,
+    int const number_of_slices,
+    int const steps_per_slice,
+    int const coarse_steps_per_slice,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance) {
+  CHECK(thread_pool_ != nullptr) << "Parareal integration without threads";
+  CHECK(tree_ == nullptr) << "Parareal integration with tree gravity";
+  CHECK(multirate_ == nullptr)
+      << "Parareal integration with multirate integration";
+  CHECK(parareal_ == nullptr) << "Parareal integration already in use";
+  std::lock_guard<std::mutex> l(prolongation_lock_);
+
+  parareal_ = std::make_unique<PararealIntegrator<Position<Frame>>>(
+      planetary_integrator_,
+      coarse_integrator,
+      number_of_slices,
+      steps_per_slice,
+      coarse_steps_per_slice,
+      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                length_integration_tolerance,
+                speed_integration_tolerance,
+                _1, _2),
+      thread_pool_.get(),
+      // The slices are integrated concurrently by the threads of the pool, so
+      // the accelerations of a slice must not use them.  The serial steps keep
+      // using |massive_bodies_equation_|.
+      std::bind(&Ephemeris::
+                    ComputeMassiveBodiesGravitationalAccelerationsConcurrently,
+                this, _1, _2, _3));
+  // The session uses the former integrator.
+  planetary_integration_.reset();
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StartBackgroundProlongation(Time const& look_ahead) {
+  CHECK(background_prolongation_ == nullptr)
+      << "Background prolongation already running";
+  look_ahead_ = look_ahead;
+  requested_time_ = last_state_.time.value;
+  stop_background_prolongation_ = false;
+  background_prolongation_ = std::make_unique<std::thread>(
+      &Ephemeris::ProlongInBackground, this);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StopBackgroundProlongation() {
+  if (background_prolongation_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(request_lock_);
+    stop_background_prolongation_ = true;
+    prolongation_requested_.notify_one();
+  }
+  background_prolongation_->join();
+  background_prolongation_.reset();
 }
 
 template<typename Frame>
@@ -198,35 +648,1013 @@ void Ephemeris<Frame>::FlowWithAdaptiveStep(
     Length const& length_integration_tolerance,
     Speed const& speed_integration_tolerance,
     AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
-    Instant const& t) {
-  std::vector<not_null<Trajectory<Frame>*>> const trajectories = {trajectory};
-  if (empty() || t > t_max()) {
+    Instant const& t,
+    PerturberPruning const* const pruning,
+    CloseEncounterRegularization const* const regularization,
+    StepSizeController const controller,
+    AdaptiveStepSizeStatistics* const statistics) {
+  ProlongIfNeeded(t);
+  FlowProlongedWithAdaptiveStep({trajectory,
+                                 length_integration_tolerance,
+                                 speed_integration_tolerance,
+                                 t,
+                                 controller,
+                                 statistics},
+                                integrator,
+                                pruning,
+                                regularization);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowWithAdaptiveStep(
+    std::vector<AdaptiveStepFlow> const& flows,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    PerturberPruning const* const pruning,
+    CloseEncounterRegularization const* const regularization) {
+  if (flows.empty()) {
+    return;
+  }
+
+  // Prolong once and for all, so that the ephemeris is not modified while the
+  // flows are integrated.
+  Instant t = flows.front().t;
+  for (auto const& flow : flows) {
+    t = std::max(t, flow.t);
+  }
+  ProlongIfNeeded(t);
+
+  if (thread_pool_ == nullptr) {
+    for (auto const& flow : flows) {
+      FlowProlongedWithAdaptiveStep(flow, integrator, pruning, regularization);
+    }
+    return;
+  }
+
+  // The pool hands out the flows in order to the threads as they become idle.
+  std::vector<std::future<void>> futures;
+  futures.reserve(flows.size());
+  for (auto const& flow : flows) {
+    futures.push_back(
+        thread_pool_->Add(
+            [this, &flow, &integrator, pruning, regularization]() {
+              FlowProlongedWithAdaptiveStep(
+                  flow, integrator, pruning, regularization);
+            }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowWithAdaptiveStepRelativeToPrimary(
+    not_null<Trajectory<Frame>*> const trajectory,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    Instant const& t,
+    EnckeIntegration const& encke) {
+  ProlongIfNeeded(t);
+
+  std::size_t fixed_primary = bodies_.size();
+  if (encke.primary != nullptr) {
+    for (std::size_t b = 0; b < bodies_.size(); ++b) {
+      if (bodies_[b].get() == encke.primary) {
+        fixed_primary = b;
+      }
+    }
+    CHECK_LT(fixed_primary, bodies_.size()) << "Unknown primary";
+  }
+
+  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  std::vector<Position<Frame>> positions(2);
+  std::vector<Vector<Acceleration, Frame>> perturbations(2);
+
+  // The deviation from the reference orbit, carried over from one segment to
+  // the next unless the reference orbit is rectified.
+  typename NewtonianMotionEquation::SystemState state;
+  state.time = trajectory->last().time();
+  state.positions.emplace_back(Frame::origin);
+  state.velocities.emplace_back(Velocity<Frame>());
+  std::unique_ptr<KeplerOrbit<Frame>> reference_orbit;
+  std::size_t primary = bodies_.size();
+
+  // The last two steps of the integrator.  The last step of a segment is
+  // usually shortened to end at the segment boundary, so the next segment
+  // starts with the longer of the two.
+  Time last_step = t - state.time.value;
+  Time previous_step = last_step;
+
+  while (state.time.value < t) {
+    Instant const t0 = state.time.value;
+    DegreesOfFreedom<Frame> const degrees_of_freedom =
+        trajectory->last().degrees_of_freedom();
+    std::size_t const segment_primary =
+        encke.primary == nullptr
+            ? DominantBody(t0, degrees_of_freedom.position(), &hints)
+            : fixed_primary;
+    bool rectify = reference_orbit == nullptr || segment_primary != primary;
+    if (!rectify) {
+      Displacement<Frame> const deviation =
+          state.positions[0].value - Frame::origin;
+      Displacement<Frame> const relative_position =
+          reference_orbit->EvaluateRelativeDegreesOfFreedom(t0).displacement() +
+          deviation;
+      rectify = deviation.Norm() >
+                encke.rectification_threshold * relative_position.Norm();
+    }
+    if (rectify) {
+      primary = segment_primary;
+      reference_orbit = std::make_unique<KeplerOrbit<Frame>>(
+          bodies_[primary]->gravitational_parameter(),
+          degrees_of_freedom -
+              trajectories_[primary]->EvaluateDegreesOfFreedom(
+                  t0, &hints[primary]),
+          t0);
+      state.positions[0] = Frame::origin;
+      state.velocities[0] = Velocity<Frame>();
+    }
+
+    // The segment lasts for about one radian of the reference orbit.
+    RelativeDegreesOfFreedom<Frame> const relative_degrees_of_freedom =
+        reference_orbit->EvaluateRelativeDegreesOfFreedom(t0);
+    Instant const t1 =
+        std::min(t,
+                 t0 + relative_degrees_of_freedom.displacement().Norm() /
+                          relative_degrees_of_freedom.velocity().Norm());
+
+    NewtonianMotionEquation deviation_equation;
+    deviation_equation.compute_acceleration =
+        std::bind(&Ephemeris::ComputeMasslessBodyDeviationAccelerations,
+                  this, std::cref(*trajectory), primary,
+                  std::cref(*reference_orbit), _1, _2, _3,
+                  &hints, &positions, &perturbations);
+
+    typename NewtonianMotionEquation::SystemState const initial_state = state;
+    IntegrationProblem<NewtonianMotionEquation> problem;
+    problem.equation = deviation_equation;
+    problem.append_state =
+        [this, &hints, &last_step, primary, &previous_step, &reference_orbit,
+         &state, trajectory](
+            typename NewtonianMotionEquation::SystemState const& s) {
+          previous_step = last_step;
+          last_step = s.time.value - state.time.value;
+          state = s;
+          RelativeDegreesOfFreedom<Frame> const reference =
+              reference_orbit->EvaluateRelativeDegreesOfFreedom(s.time.value);
+          trajectory->Append(
+              s.time.value,
+              trajectories_[primary]->EvaluateDegreesOfFreedom(
+                  s.time.value, &hints[primary]) +
+                  RelativeDegreesOfFreedom<Frame>(
+                      reference.displacement() +
+                          (s.positions[0].value - Frame::origin),
+                      reference.velocity() + s.velocities[0].value));
+        };
+    problem.t_final = t1;
+    problem.initial_state = &initial_state;
+
+    AdaptiveStepSize<NewtonianMotionEquation> step_size;
+    step_size.first_time_step =
+        std::min(std::max(last_step, previous_step), t1 - t0);
+    step_size.safety_factor = 0.9;
+    step_size.tolerance_to_error_ratio =
+        std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                  std::cref(length_integration_tolerance),
+                  std::cref(speed_integration_tolerance),
+                  _1, _2);
+
+    integrator.Solve(problem, step_size);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowEnsembleWithAdaptiveStep(
+    std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    Instant const& t,
+    EnsembleIntegration const& ensemble) {
+  if (trajectories.empty()) {
+    return;
+  }
+  CHECK_LT(Time(), ensemble.regrouping_interval);
+  CHECK_LE(1.0, ensemble.grouping_ratio);
+  Instant const t0 = trajectories.front()->last().time();
+  for (auto const& trajectory : trajectories) {
+    CHECK_EQ(t0, trajectory->last().time());
+  }
+  CHECK_LE(t0, t);
+  ProlongIfNeeded(t);
+
+  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  // The step carried over from one segment to the next by each member.
+  std::vector<Time> time_steps(trajectories.size(), t - t0);
+  // The dynamical timescales of the members, paired with their indices in
+  // |trajectories| so that the sorting is deterministic.
+  std::vector<std::pair<Time, std::size_t>> timescales(trajectories.size());
+  // The groups of a segment, as indices in |trajectories|.
+  std::vector<std::vector<std::size_t>> groups;
+
+  Instant segment_begin = t0;
+  while (segment_begin < t) {
+    Instant const segment_end =
+        std::min(t, segment_begin + ensemble.regrouping_interval);
+
+    for (std::size_t i = 0; i < trajectories.size(); ++i) {
+      Position<Frame> const position =
+          trajectories[i]->last().degrees_of_freedom().position();
+      std::size_t const b = DominantBody(segment_begin, position, &hints);
+      Length const r = (trajectories_[b]->EvaluatePosition(segment_begin,
+                                                           &hints[b]) -
+                        position).Norm();
+      timescales[i] = {Sqrt(r * r * r / bodies_[b]->gravitational_parameter()),
+                       i};
+    }
+    std::sort(timescales.begin(), timescales.end());
+    groups.clear();
+    Time smallest_timescale;
+    for (auto const& timescale : timescales) {
+      if (groups.empty() ||
+          timescale.first > ensemble.grouping_ratio * smallest_timescale) {
+        groups.emplace_back();
+        smallest_timescale = timescale.first;
+      }
+      groups.back().push_back(timescale.second);
+    }
+
+    // The members of a group start with the smallest of their steps, and all
+    // continue with the step of the group.
+    auto const flow_group =
+        [this, &integrator, &length_integration_tolerance, segment_end,
+         &speed_integration_tolerance, &time_steps, &trajectories](
+            std::vector<std::size_t> const& group) {
+          std::vector<not_null<Trajectory<Frame>*>> group_trajectories;
+          Time time_step = time_steps[group.front()];
+          for (std::size_t const i : group) {
+            group_trajectories.push_back(trajectories[i]);
+            time_step = std::min(time_step, time_steps[i]);
+          }
+          FlowProlongedEnsembleGroup(group_trajectories,
+                                     length_integration_tolerance,
+                                     speed_integration_tolerance,
+                                     integrator,
+                                     segment_end,
+                                     &time_step);
+          for (std::size_t const i : group) {
+            time_steps[i] = time_step;
+          }
+        };
+
+    if (thread_pool_ == nullptr || groups.size() < 2) {
+      for (auto const& group : groups) {
+        flow_group(group);
+      }
+    } else {
+      std::vector<std::future<void>> futures;
+      futures.reserve(groups.size());
+      for (auto const& group : groups) {
+        futures.push_back(thread_pool_->Add([&flow_group, &group]() {
+          flow_group(group);
+        }));
+      }
+      for (auto& future : futures) {
+        future.get();
+      }
+    }
+    segment_begin = segment_end;
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::WriteToMessage(
+    not_null<serialization::Ephemeris*> const message) const {
+  CHECK(multirate_ == nullptr) << "Cannot serialize a multirate ephemeris";
+  std::lock_guard<std::mutex> l(prolongation_lock_);
+  for (MassiveBody const* const body : unowned_bodies_) {
+    body->WriteToMessage(message->add_body());
+    FindOrDie(bodies_to_trajectories_, body)->WriteToMessage(
+        message->add_trajectory());
+    // The state is indexed like |bodies_|.
+    std::size_t b = 0;
+    while (bodies_[b].get() != body) {
+      ++b;
+    }
+    auto const body_state = message->add_last_state();
+    DegreesOfFreedom<Frame>(last_state_.positions[b].value,
+                            last_state_.velocities[b].value).WriteToMessage(
+        body_state->mutable_degrees_of_freedom());
+    last_state_.positions[b].error.WriteToMessage(
+        body_state->mutable_position_error());
+    last_state_.velocities[b].error.WriteToMessage(
+        body_state->mutable_velocity_error());
+  }
+  last_state_.time.value.WriteToMessage(message->mutable_last_state_time());
+  last_state_.time.error.WriteToMessage(
+      message->mutable_last_state_time_error());
+  step_.WriteToMessage(message->mutable_step());
+  low_fitting_tolerance_.WriteToMessage(
+      message->mutable_low_fitting_tolerance());
+  high_fitting_tolerance_.WriteToMessage(
+      message->mutable_high_fitting_tolerance());
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<Ephemeris<Frame>>> Ephemeris<Frame>::ReadFromMessage(
+    serialization::Ephemeris const& message,
+    FixedStepSizeIntegrator<NewtonianMotionEquation> const&
+        planetary_integrator,
+    int const number_of_threads) {
+  CHECK_EQ(message.body_size(), message.trajectory_size());
+  CHECK_EQ(message.body_size(), message.last_state_size());
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<Frame>> last_state;
+  for (int i = 0; i < message.body_size(); ++i) {
+    bodies.push_back(MassiveBody::ReadFromMessage(message.body(i)));
+    last_state.push_back(DegreesOfFreedom<Frame>::ReadFromMessage(
+        message.last_state(i).degrees_of_freedom()));
+  }
+
+  // The constructor creates trajectories that only contain the last state.
+  // Replace them with the ones from the |message|, and restore the errors of
+  // the compensated summation.
+  auto ephemeris = make_not_null_unique<Ephemeris>(
+                       std::move(bodies),
+                       last_state,
+                       Instant::ReadFromMessage(message.last_state_time()),
+                       planetary_integrator,
+                       Time::ReadFromMessage(message.step()),
+                       Length::ReadFromMessage(
+                           message.low_fitting_tolerance()),
+                       Length::ReadFromMessage(
+                           message.high_fitting_tolerance()),
+                       number_of_threads);
+  ephemeris->last_state_.time.error =
+      Time::ReadFromMessage(message.last_state_time_error());
+  for (int i = 0; i < message.body_size(); ++i) {
+    MassiveBody const* const body = ephemeris->unowned_bodies_[i];
+    auto& trajectory = FindOrDie(ephemeris->bodies_to_trajectories_, body);
+    trajectory =
+        ContinuousTrajectory<Frame>::ReadFromMessage(message.trajectory(i));
+    std::size_t b = 0;
+    while (ephemeris->bodies_[b].get() != body) {
+      ++b;
+    }
+    ephemeris->trajectories_[b] = trajectory.get();
+    ephemeris->last_state_.positions[b].error =
+        Displacement<Frame>::ReadFromMessage(
+            message.last_state(i).position_error());
+    ephemeris->last_state_.velocities[b].error =
+        Velocity<Frame>::ReadFromMessage(
+            message.last_state(i).velocity_error());
+  }
+  return ephemeris;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::BalanceWorkers(int const number_of_threads) {
+  worker_b1_begin_.clear();
+  worker_accelerations_.clear();
+  if (number_of_threads > 1) {
+    // Body b1 interacts directly with the bodies with indices in ]b1, n[,
+    // except for the minor bodies which don't interact directly with one
+    // another, so the workload of the rows decreases linearly.  Cut the rows
+    // so that each worker gets about |pairs / number_of_threads| pairs.  A
+    // row is never split, so there may be fewer workers than threads for
+    // small systems.
+    std::int64_t const n = bodies_.size();
+    auto const row_pairs = [this, n](std::int64_t const b1) -> std::int64_t {
+      return b1 < first_minor_body_ ? n - 1 - b1 : 0;
+    };
+    std::int64_t pairs = 0;
+    for (std::int64_t b1 = 0; b1 < n; ++b1) {
+      pairs += row_pairs(b1);
+    }
+    std::int64_t pairs_so_far = 0;
+    worker_b1_begin_.push_back(0);
+    for (std::int64_t b1 = 0;
+         b1 < n - 1 && worker_b1_begin_.size() < number_of_threads;
+         ++b1) {
+      pairs_so_far += row_pairs(b1);
+      if (pairs_so_far * number_of_threads >=
+              pairs * static_cast<std::int64_t>(worker_b1_begin_.size())) {
+        worker_b1_begin_.push_back(b1 + 1);
+      }
+    }
+    if (worker_b1_begin_.back() != n) {
+      worker_b1_begin_.push_back(n);
+    }
+    worker_accelerations_.resize(worker_b1_begin_.size() - 1);
+  }
+  worker_accelerations_soa_.resize(
+      std::max<std::size_t>(1, worker_accelerations_.size()),
+      internal::R3ElementsSoA(bodies_.size()));
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ProlongIfNeeded(Instant const& t) {
+  if (background_prolongation_ != nullptr || empty() || t > t_max()) {
     Prolong(t);
   }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ProlongSynchronously(Instant const& t) {
+  if (multirate_ != nullptr) {
+    do {
+      AdvanceMultirateIntegration();
+    } while (empty() || t_max() < t);
+    return;
+  }
+
+  if (planetary_integration_ == nullptr) {
+    IntegrationProblem<NewtonianMotionEquation> problem;
+    problem.equation = massive_bodies_equation_;
+    problem.append_state =
+        std::bind(&Ephemeris::AppendMassiveBodiesState, this, _1);
+    problem.initial_state = &last_state_;
+    FixedStepSizeIntegrator<NewtonianMotionEquation> const& integrator =
+        parareal_ == nullptr ? planetary_integrator_ : *parareal_;
+    planetary_integration_.reset(
+        integrator.NewSession(problem, step_).release());
+  }
+
+  // Perform the integration.  |t| may be before the last state if it is in the
+  // interval of the points not yet incorporated in a series, but the
+  // integrator must make progress.  Note that we may have to iterate until
+  // |t_max()| actually reaches |t| because the last series may not be fully
+  // determined after the first integration.
+  planetary_integration_->AdvanceTo(
+      std::max(t, last_state_.time.value + step_));
+  while (empty() || t_max() < t) {
+    planetary_integration_->Step(1);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AdvanceMultirateIntegration() {
+  Multirate& multirate = *multirate_;
+  MultirateGroup& slow = multirate.slow;
+  std::size_t const slow_size = slow.state.positions.size();
+  Time const& macro_step = slow.step;
+  Instant const t0 = slow.state.time.value;
+
+  // Integrate the subsystems over the macro step, keeping their intermediate
+  // states.  They are independent of one another, so they may be integrated
+  // concurrently.
+  auto const integrate_subsystem = [this, &macro_step, &t0](
+      MultirateGroup& subsystem) {
+    subsystem.states.clear();
+    subsystem.states.push_back(subsystem.state);
+    IntegrationProblem<NewtonianMotionEquation> problem;
+    problem.equation = subsystem.equation;
+    problem.initial_state = &subsystem.state;
+    problem.t_final = t0 + macro_step + 0.5 * subsystem.step;
+    problem.append_state =
+        [&subsystem](
+            typename NewtonianMotionEquation::SystemState const& state) {
+          subsystem.state = state;
+          subsystem.states.push_back(state);
+        };
+    planetary_integrator_.Solve(problem, subsystem.step);
+  };
+  if (thread_pool_ == nullptr) {
+    for (auto const& subsystem : multirate.subsystems) {
+      integrate_subsystem(*subsystem);
+    }
+  } else {
+    std::vector<std::future<void>> futures;
+    for (auto const& subsystem : multirate.subsystems) {
+      MultirateGroup* const group = subsystem.get();
+      futures.push_back(thread_pool_->Add([&integrate_subsystem, group]() {
+        integrate_subsystem(*group);
+      }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+
+  // Integrate the slow group over one step.
+  std::vector<Position<Frame>> q0(slow_size);
+  std::vector<Velocity<Frame>> v0(slow_size);
+  for (std::size_t i = 0; i < slow_size; ++i) {
+    q0[i] = slow.state.positions[i].value;
+    v0[i] = slow.state.velocities[i].value;
+  }
+  IntegrationProblem<NewtonianMotionEquation> slow_problem;
+  slow_problem.equation = slow.equation;
+  slow_problem.initial_state = &slow.state;
+  // Any final time in ]t0 + H, t0 + 2 H[ results in exactly one step.
+  slow_problem.t_final = t0 + 1.5 * macro_step;
+  slow_problem.append_state =
+      [&slow](typename NewtonianMotionEquation::SystemState const& state) {
+        slow.state = state;
+      };
+  planetary_integrator_.Solve(slow_problem, macro_step);
+
+  // The quintic Hermite interpolation of the slow group is determined by the
+  // positions, velocities and accelerations at both ends of the step.
+  std::vector<Position<Frame>> q1(slow_size);
+  for (std::size_t i = 0; i < slow_size; ++i) {
+    q1[i] = slow.state.positions[i].value;
+  }
+  std::vector<Vector<Acceleration, Frame>> a0(slow_size);
+  a0.swap(multirate.accelerations);
+  ComputeSlowGroupGravitationalAccelerations(slow.state.time.value,
+                                             q1,
+                                             &multirate.accelerations);
+  multirate.t0 = t0;
+  multirate.q0.swap(q0);
+  for (std::size_t i = 0; i < slow_size; ++i) {
+    Displacement<Frame> const Δq = q1[i] - multirate.q0[i];
+    Displacement<Frame> const v0_h = v0[i] * macro_step;
+    Displacement<Frame> const v1_h =
+        slow.state.velocities[i].value * macro_step;
+    Displacement<Frame> const a0_h_squared = a0[i] * macro_step * macro_step;
+    Displacement<Frame> const a1_h_squared =
+        multirate.accelerations[i] * macro_step * macro_step;
+    multirate.coefficients[0][i] = v0_h;
+    multirate.coefficients[1][i] = 0.5 * a0_h_squared;
+    multirate.coefficients[2][i] =
+        10 * Δq - 6 * v0_h - 4 * v1_h - 1.5 * a0_h_squared + 0.5 * a1_h_squared;
+    multirate.coefficients[3][i] =
+        -15 * Δq + 8 * v0_h + 7 * v1_h + 1.5 * a0_h_squared - a1_h_squared;
+    multirate.coefficients[4][i] =
+        6 * Δq - 3 * v0_h - 3 * v1_h - 0.5 * a0_h_squared + 0.5 * a1_h_squared;
+  }
+
+  // Append the new states to the trajectories.
+  Instant const& t1 = slow.state.time.value;
+  for (std::size_t i = 0; i < slow.indices.size(); ++i) {
+    std::size_t const b = slow.indices[i];
+    trajectories_[b]->Append(t1,
+                             DegreesOfFreedom<Frame>(
+                                 slow.state.positions[i].value,
+                                 slow.state.velocities[i].value));
+    last_state_.positions[b] = slow.state.positions[i].value;
+    last_state_.velocities[b] = slow.state.velocities[i].value;
+  }
+  for (auto const& subsystem : multirate.subsystems) {
+    for (std::size_t k = 1; k < subsystem->states.size(); ++k) {
+      auto const& state = subsystem->states[k];
+      DegreesOfFreedom<Frame> const barycentre =
+          InterpolateSlowGroupDegreesOfFreedom(subsystem->slow_index,
+                                               state.time.value);
+      for (std::size_t i = 0; i < subsystem->indices.size(); ++i) {
+        std::size_t const b = subsystem->indices[i];
+        DegreesOfFreedom<Frame> const degrees_of_freedom(
+            barycentre.position() + (state.positions[i].value - Frame::origin),
+            barycentre.velocity() + state.velocities[i].value);
+        trajectories_[b]->Append(state.time.value, degrees_of_freedom);
+        last_state_.positions[b] = degrees_of_freedom.position();
+        last_state_.velocities[b] = degrees_of_freedom.velocity();
+      }
+    }
+  }
+  last_state_.time = slow.state.time;
+}
+
+template<typename Frame>
+Position<Frame> Ephemeris<Frame>::InterpolateSlowGroupPosition(
+    std::size_t const i,
+    Instant const& t) const {
+  Multirate const& multirate = *multirate_;
+  auto const& c = multirate.coefficients;
+  double const s = (t - multirate.t0) / multirate.slow.step;
+  return multirate.q0[i] +
+         s * (c[0][i] + s * (c[1][i] + s * (c[2][i] +
+                                            s * (c[3][i] + s * c[4][i]))));
+}
+
+template<typename Frame>
+DegreesOfFreedom<Frame> Ephemeris<Frame>::InterpolateSlowGroupDegreesOfFreedom(
+    std::size_t const i,
+    Instant const& t) const {
+  Multirate const& multirate = *multirate_;
+  auto const& c = multirate.coefficients;
+  double const s = (t - multirate.t0) / multirate.slow.step;
+  return DegreesOfFreedom<Frame>(
+      InterpolateSlowGroupPosition(i, t),
+      (c[0][i] + s * (2 * c[1][i] + s * (3 * c[2][i] +
+                                         s * (4 * c[3][i] +
+                                              s * 5 * c[4][i])))) /
+          multirate.slow.step);
+}
+
+template<typename Frame>
+Position<Frame> Ephemeris<Frame>::InterpolateSubsystemPosition(
+    MultirateGroup const& subsystem,
+    std::size_t const i,
+    Instant const& t) {
+  auto const& states = subsystem.states;
+  if (states.size() == 1) {
+    return states.front().positions[i].value;
+  }
+  // Cubic Hermite interpolation between the states that bracket |t|.
+  double const steps = (t - states.front().time.value) / subsystem.step;
+  std::size_t const k = std::min<std::size_t>(
+      std::max(0.0, std::floor(steps)), states.size() - 2);
+  double const s = steps - k;
+  Position<Frame> const& q0 = states[k].positions[i].value;
+  Displacement<Frame> const Δq = states[k + 1].positions[i].value - q0;
+  Displacement<Frame> const v0_h =
+      states[k].velocities[i].value * subsystem.step;
+  Displacement<Frame> const v1_h =
+      states[k + 1].velocities[i].value * subsystem.step;
+  return q0 + s * (v0_h + s * ((3 * Δq - 2 * v0_h - v1_h) +
+                               s * (v0_h + v1_h - 2 * Δq)));
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ProlongInBackground() {
+  for (;;) {
+    Instant target;
+    {
+      std::unique_lock<std::mutex> l(request_lock_);
+      prolongation_requested_.wait(l, [this]() {
+        return stop_background_prolongation_ ||
+               empty() ||
+               t_max() < requested_time_ + look_ahead_;
+      });
+      if (stop_background_prolongation_) {
+        return;
+      }
+      target = requested_time_ + look_ahead_;
+    }
+    {
+      // Integrate one series at a time, so that the waiters in |Prolong| are
+      // released as early as possible and |ForgetBefore| or |WriteToMessage|
+      // don't wait long.
+      std::lock_guard<std::mutex> l(prolongation_lock_);
+      ProlongSynchronously(empty() ? last_state_.time.value
+                                   : std::min(target, t_max() + step_));
+    }
+    {
+      std::lock_guard<std::mutex> l(request_lock_);
+      prolonged_.notify_all();
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowProlongedWithAdaptiveStep(
+    AdaptiveStepFlow const& flow,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    PerturberPruning const* const pruning,
+    CloseEncounterRegularization const* const regularization) {
+  if (regularization == nullptr) {
+    Time time_step = flow.t - flow.trajectory->last().time();
+    FlowProlongedWithCowell(flow, integrator, pruning, &time_step);
+  } else {
+    FlowProlongedWithRegularization(flow, integrator, pruning, *regularization);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowProlongedWithCowell(
+    AdaptiveStepFlow const& flow,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    PerturberPruning const* const pruning,
+    not_null<Time*> const time_step) {
+  std::vector<not_null<Trajectory<Frame>*>> const trajectories =
+      {flow.trajectory};
 
+  typename NewtonianMotionEquation::SystemState initial_state;
+  auto const trajectory_last = flow.trajectory->last();
+  auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
+  initial_state.time = trajectory_last.time();
+  initial_state.positions.push_back(last_degrees_of_freedom.position());
+  initial_state.velocities.push_back(last_degrees_of_freedom.velocity());
+
+  std::unique_ptr<PrunedPerturbers> const pruned_perturbers =
+      MakePrunedPerturbers(pruning,
+                           flow.length_integration_tolerance,
+                           initial_state.time.value);
   std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  std::vector<Position<Frame>> massive_bodies_positions(bodies_.size());
   NewtonianMotionEquation massless_body_equation;
   massless_body_equation.compute_acceleration =
       std::bind(&Ephemeris::ComputeMasslessBodiesGravitationalAccelerations,
-                this, std::cref(trajectories), _1, _2, _3, &hints);
+                this, std::cref(trajectories), _1, _2, _3,
+                &hints, &massive_bodies_positions, pruned_perturbers.get());
+
+  // The last step of the integration is usually shortened to end at |flow.t|,
+  // so the integration should continue with the longer of the last two steps.
+  Instant last_time = initial_state.time.value;
+  Time last_step = *time_step;
+  Time previous_step = *time_step;
+  IntegrationProblem<NewtonianMotionEquation> problem;
+  problem.equation = massless_body_equation;
+  problem.append_state =
+      [&last_step, &last_time, &previous_step, &trajectories](
+          typename NewtonianMotionEquation::SystemState const& state) {
+        previous_step = last_step;
+        last_step = state.time.value - last_time;
+        last_time = state.time.value;
+        AppendMasslessBodiesState(state, trajectories);
+      };
+  problem.t_final = flow.t;
+  problem.initial_state = &initial_state;
+
+  AdaptiveStepSize<NewtonianMotionEquation> step_size;
+  step_size.first_time_step =
+      std::min(*time_step, problem.t_final - initial_state.time.value);
+  step_size.safety_factor = 0.9;
+  step_size.tolerance_to_error_ratio =
+      std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                std::cref(flow.length_integration_tolerance),
+                std::cref(flow.speed_integration_tolerance),
+                _1, _2);
+  step_size.controller = flow.controller;
+  step_size.statistics = flow.statistics;
+
+  integrator.Solve(problem, step_size);
+  if (pruned_perturbers != nullptr) {
+    RecordPrunedPerturbers(*pruned_perturbers);
+  }
+  *time_step = std::max(last_step, previous_step);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowProlongedWithRegularization(
+    AdaptiveStepFlow const& flow,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    PerturberPruning const* const pruning,
+    CloseEncounterRegularization const& regularization) {
+  Length const& radius = regularization.radius;
+  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  // The step of Cowell's method carried over from one flow to the next, and the
+  // shortest duration of a flow, which avoids restarting at every step near
+  // the boundary of an encounter.
+  Time cowell_step = flow.t - flow.trajectory->last().time();
+  Time shortest_cowell_flow;
+  while (flow.trajectory->last().time() < flow.t) {
+    Instant const t0 = flow.trajectory->last().time();
+    DegreesOfFreedom<Frame> const degrees_of_freedom =
+        flow.trajectory->last().degrees_of_freedom();
+
+    // Find the nearest body, and a lower bound of the time that it takes to
+    // come within |radius| of any body, assuming that the radial acceleration
+    // toward a body never exceeds its attraction at |radius|.
+    std::size_t nearest_body = 0;
+    Length nearest_distance;
+    Time time_to_encounter = flow.t - t0;
+    for (std::size_t b = 0; b < bodies_.size(); ++b) {
+      RelativeDegreesOfFreedom<Frame> const relative =
+          degrees_of_freedom -
+          trajectories_[b]->EvaluateDegreesOfFreedom(t0, &hints[b]);
+      Length const distance = relative.displacement().Norm();
+      if (b == 0 || distance < nearest_distance) {
+        nearest_body = b;
+        nearest_distance = distance;
+      }
+      if (distance > radius) {
+        Speed const approach_speed =
+            -InnerProduct(relative.displacement(), relative.velocity()) /
+            distance;
+        Acceleration const attraction =
+            bodies_[b]->gravitational_parameter() / (radius * radius);
+        time_to_encounter = std::min(
+            time_to_encounter,
+            (Sqrt(approach_speed * approach_speed +
+                  2 * attraction * (distance - radius)) -
+             approach_speed) / attraction);
+      }
+    }
+
+    if (nearest_distance <= radius) {
+      FlowProlongedCloseEncounter(
+          flow, integrator, nearest_body, regularization, &hints);
+    } else {
+      AdaptiveStepFlow cowell_flow = flow;
+      cowell_flow.t = std::min(
+          flow.t, t0 + std::max(time_to_encounter, shortest_cowell_flow));
+      FlowProlongedWithCowell(cowell_flow, integrator, pruning, &cowell_step);
+      shortest_cowell_flow = cowell_step;
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowProlongedCloseEncounter(
+    AdaptiveStepFlow const& flow,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    std::size_t const primary,
+    CloseEncounterRegularization const& regularization,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints) {
+  not_null<Trajectory<Frame>*> const trajectory = flow.trajectory;
+  ContinuousTrajectory<Frame> const& primary_trajectory =
+      *trajectories_[primary];
+  typename ContinuousTrajectory<Frame>::Hint* const primary_hint =
+      &(*hints)[primary];
+  GravitationalParameter const& μ = bodies_[primary]->gravitational_parameter();
+  std::vector<Position<Frame>> positions(2);
+  std::vector<Vector<Acceleration, Frame>> perturbations(2);
+
+  // The scaled deviation from the reference orbit, and the Sundman time, which
+  // are carried over from one segment to the next unless the reference orbit
+  // is rectified.
+  typename NewtonianMotionEquation::SystemState state;
+  state.positions.emplace_back(Frame::origin);
+  state.velocities.emplace_back(Velocity<Frame>());
+  std::unique_ptr<KeplerOrbit<Frame>> reference_orbit;
+
+  // The steps in Sundman time, see |FlowProlongedWithCowell|.
+  Time last_step;
+  Time previous_step;
+
+  while (trajectory->last().time() < flow.t) {
+    Instant const t0 = trajectory->last().time();
+    RelativeDegreesOfFreedom<Frame> const relative_degrees_of_freedom =
+        trajectory->last().degrees_of_freedom() -
+        primary_trajectory.EvaluateDegreesOfFreedom(t0, primary_hint);
+    Displacement<Frame> const& relative_position =
+        relative_degrees_of_freedom.displacement();
+    if (relative_position.Norm() > regularization.radius) {
+      return;
+    }
+    bool rectify = reference_orbit == nullptr;
+    if (!rectify) {
+      Instant t;
+      Displacement<Frame> const deviation =
+          relative_position -
+          reference_orbit->EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+              state.time.value - reference_orbit->epoch(), &t).displacement();
+      rectify = deviation.Norm() >
+                regularization.rectification_threshold *
+                    relative_position.Norm();
+    }
+    if (rectify) {
+      reference_orbit = std::make_unique<KeplerOrbit<Frame>>(
+          μ, relative_degrees_of_freedom, t0);
+      state.time = t0;
+      state.positions[0] = Frame::origin;
+      state.velocities[0] = Velocity<Frame>();
+    }
+
+    // A segment lasts for about one radian of the reference orbit near the
+    // initial point of that orbit.
+    Length const r0 =
+        reference_orbit->initial_state().displacement().Norm();
+    Instant const s0 = state.time.value;
+    Instant const s_final =
+        reference_orbit->epoch() + reference_orbit->SundmanTime(flow.t);
+    Instant const s1 = std::min(s_final, s0 + Sqrt(r0 * r0 * r0 / μ));
+    if (rectify) {
+      last_step = s1 - s0;
+      previous_step = last_step;
+    }
+
+    NewtonianMotionEquation deviation_equation;
+    deviation_equation.compute_acceleration =
+        std::bind(
+            &Ephemeris::ComputeMasslessBodyRegularizedDeviationAccelerations,
+            this, std::cref(*trajectory), primary, std::cref(*reference_orbit),
+            _1, _2, _3, hints, &positions, &perturbations);
+
+    typename NewtonianMotionEquation::SystemState const initial_state = state;
+    IntegrationProblem<NewtonianMotionEquation> problem;
+    problem.equation = deviation_equation;
+    problem.append_state =
+        [&flow, &last_step, primary_hint, &primary_trajectory, &previous_step,
+         &reference_orbit, s_final, &state, trajectory](
+            typename NewtonianMotionEquation::SystemState const& s) {
+          previous_step = last_step;
+          last_step = s.time.value - state.time.value;
+          state = s;
+          Instant t;
+          RelativeDegreesOfFreedom<Frame> const reference =
+              reference_orbit->EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+                  s.time.value - reference_orbit->epoch(), &t);
+          if (s.time.value == s_final) {
+            t = flow.t;
+          }
+          double dt_ds;
+          Exponentiation<Time, -1> d2t_ds2;
+          Exponentiation<Time, -2> d3t_ds3;
+          SundmanTimeDerivatives(*reference_orbit, reference,
+                                 &dt_ds, &d2t_ds2, &d3t_ds3);
+          // δ = √(dt / ds) w, and its derivative with respect to t.
+          double const sqrt_dt_ds = std::sqrt(dt_ds);
+          Displacement<Frame> const w = s.positions[0].value - Frame::origin;
+          Velocity<Frame> const& dw_ds = s.velocities[0].value;
+          Displacement<Frame> const δ = sqrt_dt_ds * w;
+          Velocity<Frame> const dδ_dt =
+              (d2t_ds2 / (2 * sqrt_dt_ds) * w + sqrt_dt_ds * dw_ds) / dt_ds;
+          trajectory->Append(
+              t,
+              primary_trajectory.EvaluateDegreesOfFreedom(t, primary_hint) +
+                  RelativeDegreesOfFreedom<Frame>(
+                      reference.displacement() + δ,
+                      reference.velocity() + dδ_dt));
+        };
+    problem.t_final = s1;
+    problem.initial_state = &initial_state;
+
+    AdaptiveStepSize<NewtonianMotionEquation> step_size;
+    step_size.first_time_step =
+        std::min(std::max(last_step, previous_step), s1 - s0);
+    step_size.safety_factor = 0.9;
+    step_size.tolerance_to_error_ratio =
+        std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                  std::cref(flow.length_integration_tolerance),
+                  std::cref(flow.speed_integration_tolerance),
+                  _1, _2);
+    step_size.controller = flow.controller;
+    step_size.statistics = flow.statistics;
+
+    integrator.Solve(problem, step_size);
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowWithFixedStep(
+    std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+    Time const& step,
+    Instant const& t,
+    PerturberPruning const* const pruning) {
+  ProlongIfNeeded(t);
+
+  if (thread_pool_ == nullptr || trajectories.size() < 2) {
+    FlowShardWithFixedStep(trajectories, step, t, pruning);
+    return;
+  }
+
+  // Cut the |trajectories| in contiguous shards of (almost) equal sizes, one
+  // per thread.
+  std::size_t const number_of_shards =
+      std::min<std::size_t>(thread_pool_->size(), trajectories.size());
+  std::vector<std::vector<not_null<Trajectory<Frame>*>>> shards;
+  shards.reserve(number_of_shards);
+  for (std::size_t s = 0; s < number_of_shards; ++s) {
+    shards.emplace_back(
+        trajectories.begin() + trajectories.size() * s / number_of_shards,
+        trajectories.begin() +
+            trajectories.size() * (s + 1) / number_of_shards);
+  }
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(number_of_shards);
+  for (auto const& shard : shards) {
+    futures.push_back(thread_pool_->Add([this, &shard, &step, &t, pruning]() {
+      FlowShardWithFixedStep(shard, step, t, pruning);
+    }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlowProlongedEnsembleGroup(
+    std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+    Length const& length_integration_tolerance,
+    Speed const& speed_integration_tolerance,
+    AdaptiveStepSizeIntegrator<NewtonianMotionEquation> const& integrator,
+    Instant const& t,
+    not_null<Time*> const time_step) const {
+  typename NewtonianMotionEquation::SystemState initial_state;
+  for (auto const& trajectory : trajectories) {
+    auto const trajectory_last = trajectory->last();
+    auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
+    initial_state.time = trajectory_last.time();
+    initial_state.positions.push_back(last_degrees_of_freedom.position());
+    initial_state.velocities.push_back(last_degrees_of_freedom.velocity());
+  }
 
-  typename NewtonianMotionEquation::SystemState initial_state;
-  auto const trajectory_last = trajectory->last();
-  auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
-  initial_state.time = trajectory_last.time();
-  initial_state.positions.push_back(last_degrees_of_freedom.position());
-  initial_state.velocities.push_back(last_degrees_of_freedom.velocity());
+  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  internal::R3ElementsSoA positions_soa(trajectories.size());
+  internal::R3ElementsSoA accelerations_soa(trajectories.size());
+  NewtonianMotionEquation ensemble_equation;
+  ensemble_equation.compute_acceleration =
+      std::bind(&Ephemeris::ComputeEnsembleGravitationalAccelerations,
+                this, std::cref(trajectories), _1, _2, _3,
+                &hints, &positions_soa, &accelerations_soa);
 
+  // As in |FlowProlongedWithCowell|, the integration should continue with the
+  // longer of the last two steps.
+  Instant last_time = initial_state.time.value;
+  Time last_step = *time_step;
+  Time previous_step = *time_step;
   IntegrationProblem<NewtonianMotionEquation> problem;
-  problem.equation = massless_body_equation;
+  problem.equation = ensemble_equation;
   problem.append_state =
-      std::bind(&Ephemeris::AppendMasslessBodiesState,
-                _1, std::cref(trajectories));
+      [&last_step, &last_time, &previous_step, &trajectories](
+          typename NewtonianMotionEquation::SystemState const& state) {
+        previous_step = last_step;
+        last_step = state.time.value - last_time;
+        last_time = state.time.value;
+        AppendMasslessBodiesState(state, trajectories);
+      };
   problem.t_final = t;
   problem.initial_state = &initial_state;
 
   AdaptiveStepSize<NewtonianMotionEquation> step_size;
-  step_size.first_time_step = problem.t_final - initial_state.time.value;
+  step_size.first_time_step =
+      std::min(*time_step, problem.t_final - initial_state.time.value);
   step_size.safety_factor = 0.9;
   step_size.tolerance_to_error_ratio =
       std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
@@ -235,23 +1663,15 @@ void Ephemeris<Frame>::FlowWithAdaptiveStep(
                 _1, _2);
 
   integrator.Solve(problem, step_size);
+  *time_step = std::max(last_step, previous_step);
 }
 
 template<typename Frame>
-void Ephemeris<Frame>::FlowWithFixedStep(
+void Ephemeris<Frame>::FlowShardWithFixedStep(
     std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
     Time const& step,
-    Instant const& t) {
-  if (empty() || t > t_max()) {
-    Prolong(t);
-  }
-
-  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
-  NewtonianMotionEquation massless_body_equation;
-  massless_body_equation.compute_acceleration =
-      std::bind(&Ephemeris::ComputeMasslessBodiesGravitationalAccelerations,
-                this, std::cref(trajectories), _1, _2, _3, &hints);
-
+    Instant const& t,
+    PerturberPruning const* const pruning) {
   typename NewtonianMotionEquation::SystemState initial_state;
   for (auto const& trajectory : trajectories) {
     auto const trajectory_last = trajectory->last();
@@ -261,6 +1681,18 @@ void Ephemeris<Frame>::FlowWithFixedStep(
     initial_state.velocities.push_back(last_degrees_of_freedom.velocity());
   }
 
+  std::unique_ptr<PrunedPerturbers> const pruned_perturbers =
+      MakePrunedPerturbers(pruning,
+                           low_fitting_tolerance_,
+                           initial_state.time.value);
+  std::vector<typename ContinuousTrajectory<Frame>::Hint> hints(bodies_.size());
+  std::vector<Position<Frame>> massive_bodies_positions(bodies_.size());
+  NewtonianMotionEquation massless_body_equation;
+  massless_body_equation.compute_acceleration =
+      std::bind(&Ephemeris::ComputeMasslessBodiesGravitationalAccelerations,
+                this, std::cref(trajectories), _1, _2, _3,
+                &hints, &massive_bodies_positions, pruned_perturbers.get());
+
   IntegrationProblem<NewtonianMotionEquation> problem;
   problem.equation = massless_body_equation;
   problem.append_state =
@@ -270,6 +1702,101 @@ void Ephemeris<Frame>::FlowWithFixedStep(
   problem.initial_state = &initial_state;
 
   planetary_integrator_.Solve(problem, step);
+  if (pruned_perturbers != nullptr) {
+    RecordPrunedPerturbers(*pruned_perturbers);
+  }
+}
+
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::number_of_pruned_evaluations() const {
+  std::lock_guard<std::mutex> l(pruning_statistics_lock_);
+  return number_of_pruned_evaluations_;
+}
+
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::number_of_skipped_evaluations(
+    not_null<MassiveBody const*> const body) const {
+  std::lock_guard<std::mutex> l(pruning_statistics_lock_);
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    if (bodies_[b].get() == body) {
+      return number_of_skipped_evaluations_[b];
+    }
+  }
+  LOG(FATAL) << "Body not found in the ephemeris";
+  base::noreturn();
+}
+
+template<typename Frame>
+std::unique_ptr<typename Ephemeris<Frame>::PrunedPerturbers>
+Ephemeris<Frame>::MakePrunedPerturbers(
+    PerturberPruning const* const pruning,
+    Length const& length_integration_tolerance,
+    Instant const& t) const {
+  if (pruning == nullptr) {
+    return nullptr;
+  }
+  CHECK_LT(Time(), pruning->reevaluation_interval);
+  CHECK_LE(0, pruning->tolerance_fraction);
+  auto pruned_perturbers = std::make_unique<PrunedPerturbers>();
+  pruned_perturbers->policy = *pruning;
+  pruned_perturbers->negligible_displacement =
+      pruning->tolerance_fraction * length_integration_tolerance;
+  // Reevaluate at the first evaluation.
+  pruned_perturbers->last_reevaluation = t;
+  pruned_perturbers->next_reevaluation = t;
+  pruned_perturbers->skipped.resize(bodies_.size());
+  pruned_perturbers->evaluations = 0;
+  pruned_perturbers->skipped_evaluations.resize(bodies_.size());
+  return pruned_perturbers;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::RecordPrunedPerturbers(
+    PrunedPerturbers const& pruned_perturbers) {
+  std::lock_guard<std::mutex> l(pruning_statistics_lock_);
+  number_of_pruned_evaluations_ += pruned_perturbers.evaluations;
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    number_of_skipped_evaluations_[b] +=
+        pruned_perturbers.skipped_evaluations[b];
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::PrunePerturbers(
+    Instant const& t,
+    not_null<PrunedPerturbers*> const pruned_perturbers) {
+  std::vector<Acceleration> const& largest_accelerations =
+      pruned_perturbers->largest_accelerations;
+  Time const& Δt = pruned_perturbers->policy.reevaluation_interval;
+
+  // Skip the weakest bodies first, so that as many bodies as possible are
+  // skipped for a given bound on their combined acceleration.
+  std::vector<std::size_t> order(largest_accelerations.size());
+  for (std::size_t b = 0; b < order.size(); ++b) {
+    order[b] = b;
+  }
+  std::sort(order.begin(),
+            order.end(),
+            [&largest_accelerations](std::size_t const left,
+                                     std::size_t const right) {
+              return largest_accelerations[left] <
+                     largest_accelerations[right];
+            });
+
+  pruned_perturbers->skipped.assign(order.size(), false);
+  Acceleration skipped_acceleration;
+  for (std::size_t const b : order) {
+    skipped_acceleration += largest_accelerations[b];
+    // The displacement |a Δt² / 2| caused by an acceleration which may grow
+    // up to |4 a|.
+    if (2 * skipped_acceleration * Δt * Δt >
+            pruned_perturbers->negligible_displacement) {
+      break;
+    }
+    pruned_perturbers->skipped[b] = true;
+  }
+  pruned_perturbers->last_reevaluation = t;
+  pruned_perturbers->next_reevaluation = t + Δt;
 }
 
 template<typename Frame>
@@ -369,18 +1896,14 @@ template<typename Frame>
 template<bool body1_is_oblate>
 void Ephemeris<Frame>::
 ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
-    Instant const& t,
     MassiveBody const& body1,
-    size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
-    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
-    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
-        const hints) {
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
 
   for (size_t b2 = 0; b2 < positions.size(); ++b2) {
-    Displacement<Frame> const Δq =
-        trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]) - positions[b2];
+    Displacement<Frame> const Δq = position1 - positions[b2];
 
     Exponentiation<Length, 2> const Δq_squared = InnerProduct(Δq, Δq);
     // NOTE(phl): Don't try to compute one_over_Δq_squared here, it makes the
@@ -405,13 +1928,60 @@ ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
 }
 
 template<typename Frame>
-void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
+template<bool body1_is_oblate>
+void Ephemeris<Frame>::
+AddGravitationalAccelerationByMassiveBodyOnMasslessBodies(
+    MassiveBody const& body1,
+    std::size_t const b1,
     Instant const& t,
     std::vector<Position<Frame>> const& positions,
-    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
-  accelerations->assign(accelerations->size(), Vector<Acceleration, Frame>());
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints,
+    not_null<std::vector<Position<Frame>>*> const massive_bodies_positions,
+    PrunedPerturbers* const pruned_perturbers,
+    bool const reevaluate) const {
+  if (pruned_perturbers != nullptr &&
+      !reevaluate &&
+      pruned_perturbers->skipped[b1]) {
+    ++pruned_perturbers->skipped_evaluations[b1];
+    return;
+  }
 
-  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+  Position<Frame> const& position1 = (*massive_bodies_positions)[b1] =
+      trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]);
+  if (!reevaluate) {
+    ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+        body1_is_oblate>(body1, position1, positions, accelerations);
+    return;
+  }
+
+  // Compute the accelerations due to |body1| separately to find the largest.
+  std::vector<Vector<Acceleration, Frame>>& body_accelerations =
+      pruned_perturbers->body_accelerations;
+  body_accelerations.assign(positions.size(), Vector<Acceleration, Frame>());
+  ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+      body1_is_oblate>(body1, position1, positions, &body_accelerations);
+  Acceleration& largest_acceleration =
+      pruned_perturbers->largest_accelerations[b1];
+  for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+    largest_acceleration =
+        std::max(largest_acceleration, body_accelerations[b2].Norm());
+    (*accelerations)[b2] += body_accelerations[b2];
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeGravitationalAccelerationsBetweenMassiveBodies(
+    size_t const b1_begin,
+    size_t const b1_end,
+    std::vector<Position<Frame>> const& positions,
+    internal::R3ElementsSoA const& positions_soa,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+    not_null<internal::R3ElementsSoA*> const spherical_accelerations) const {
+  for (std::size_t b1 = b1_begin;
+       b1 < std::min<std::size_t>(b1_end, number_of_oblate_bodies_);
+       ++b1) {
     MassiveBody const& body1 = *oblate_bodies_[b1];
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         true /*body1_is_oblate*/,
@@ -433,25 +2003,341 @@ void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
         positions,
         accelerations);
   }
-  for (std::size_t b1 = number_of_oblate_bodies_;
-       b1 < number_of_oblate_bodies_ +
-            number_of_spherical_bodies_;
+  std::size_t const spherical_b1_begin =
+      std::max<std::size_t>(b1_begin, number_of_oblate_bodies_);
+  if (spherical_b1_begin >= b1_end) {
+    return;
+  }
+  std::size_t const n = number_of_oblate_bodies_ + number_of_spherical_bodies_;
+  spherical_accelerations->Clear(spherical_b1_begin, n);
+  for (std::size_t b1 = spherical_b1_begin;
+       b1 < std::min<std::size_t>(b1_end, first_minor_body_);
        ++b1) {
+    internal::AddGravitationalAccelerationsBetweenPointMasses(
+        b1,
+        b1 + 1 /*b2_begin*/,
+        n /*b2_end*/,
+        positions_soa,
+        gravitational_parameters_,
+        spherical_accelerations);
+  }
+  for (std::size_t b = spherical_b1_begin; b < n; ++b) {
+    (*accelerations)[b] += Vector<Acceleration, Frame>(
+        {spherical_accelerations->x[b] * SIUnit<Acceleration>(),
+         spherical_accelerations->y[b] * SIUnit<Acceleration>(),
+         spherical_accelerations->z[b] * SIUnit<Acceleration>()});
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AddMinorBodiesGravitationalAccelerations(
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
+  std::size_t const n = bodies_.size();
+  tree_->Build(first_minor_body_, n, positions_soa_, gravitational_parameters_);
+  tree_accelerations_soa_.Clear(first_minor_body_, n);
+  if (thread_pool_ == nullptr) {
+    tree_->AddAccelerations(tree_opening_angle_,
+                            first_minor_body_, n,
+                            positions_soa_,
+                            gravitational_parameters_,
+                            &tree_accelerations_soa_);
+  } else {
+    // The targets are independent, so they are split in contiguous shards.
+    std::size_t const minor_bodies = n - first_minor_body_;
+    std::size_t const shards = std::min<std::size_t>(thread_pool_->size(),
+                                                     minor_bodies);
+    std::vector<std::future<void>> futures;
+    for (std::size_t s = 0; s < shards; ++s) {
+      std::size_t const begin = first_minor_body_ + minor_bodies * s / shards;
+      std::size_t const end =
+          first_minor_body_ + minor_bodies * (s + 1) / shards;
+      futures.push_back(thread_pool_->Add([this, begin, end]() {
+        tree_->AddAccelerations(tree_opening_angle_,
+                                begin, end,
+                                positions_soa_,
+                                gravitational_parameters_,
+                                &tree_accelerations_soa_);
+      }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+  for (std::size_t b = first_minor_body_; b < n; ++b) {
+    (*accelerations)[b] += Vector<Acceleration, Frame>(
+        {tree_accelerations_soa_.x[b] * SIUnit<Acceleration>(),
+         tree_accelerations_soa_.y[b] * SIUnit<Acceleration>(),
+         tree_accelerations_soa_.z[b] * SIUnit<Acceleration>()});
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeGravitationalAccelerationsWithinGroup(
+    MultirateGroup const& group,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
+  accelerations->assign(accelerations->size(), Vector<Acceleration, Frame>());
+  std::size_t const number_of_oblate_bodies = group.oblate_bodies.size();
+  std::size_t const n =
+      number_of_oblate_bodies + group.spherical_bodies.size();
+  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies; ++b1) {
+    MassiveBody const& body1 = *group.oblate_bodies[b1];
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        true /*body1_is_oblate*/,
+        true /*body2_is_oblate*/>(
+        body1, b1,
+        group.oblate_bodies /*bodies2*/,
+        0 /*b2_begin*/,
+        number_of_oblate_bodies /*b2_end*/,
+        positions,
+        accelerations);
+    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
+        true /*body1_is_oblate*/,
+        false /*body2_is_oblate*/>(
+        body1, b1,
+        group.spherical_bodies /*bodies2*/,
+        number_of_oblate_bodies /*b2_begin*/,
+        n /*b2_end*/,
+        positions,
+        accelerations);
+  }
+  for (std::size_t b1 = number_of_oblate_bodies; b1 < n; ++b1) {
     MassiveBody const& body1 =
-        *spherical_bodies_[b1 - number_of_oblate_bodies_];
+        *group.spherical_bodies[b1 - number_of_oblate_bodies];
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         false /*body1_is_oblate*/,
         false /*body2_is_oblate*/>(
         body1, b1,
-        spherical_bodies_ /*bodies2*/,
-        number_of_oblate_bodies_ /*b2_begin*/,
-        number_of_oblate_bodies_ +
-            number_of_spherical_bodies_ /*b2_end*/,
+        group.spherical_bodies /*bodies2*/,
+        number_of_oblate_bodies /*b2_begin*/,
+        n /*b2_end*/,
         positions,
         accelerations);
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::ComputeSlowGroupGravitationalAccelerations(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
+  // Compute the accelerations of all the bodies, and those of the barycentres
+  // of the subsystems from them.  The interactions within the subsystems
+  // cancel out, except for those from which Newton's third law exempts the
+  // oblate bodies, so the result is the same as for the single-rate
+  // integration.
+  MultirateGroup const& slow = multirate_->slow;
+  std::vector<Position<Frame>>& all_positions = multirate_->all_positions;
+  std::vector<Vector<Acceleration, Frame>>& all_accelerations =
+      multirate_->all_accelerations;
+  for (std::size_t i = 0; i < slow.indices.size(); ++i) {
+    all_positions[slow.indices[i]] = positions[i];
+  }
+  for (auto const& subsystem : multirate_->subsystems) {
+    Position<Frame> const& barycentre = positions[subsystem->slow_index];
+    for (std::size_t i = 0; i < subsystem->indices.size(); ++i) {
+      all_positions[subsystem->indices[i]] =
+          barycentre +
+          (InterpolateSubsystemPosition(*subsystem, i, t) - Frame::origin);
+    }
+  }
+  ComputeMassiveBodiesGravitationalAccelerations(t,
+                                                 all_positions,
+                                                 &all_accelerations);
+  for (std::size_t i = 0; i < slow.indices.size(); ++i) {
+    (*accelerations)[i] = all_accelerations[slow.indices[i]];
+  }
+  for (auto const& subsystem : multirate_->subsystems) {
+    Vector<Acceleration, Frame>& barycentre_acceleration =
+        (*accelerations)[subsystem->slow_index];
+    barycentre_acceleration = Vector<Acceleration, Frame>();
+    for (std::size_t i = 0; i < subsystem->indices.size(); ++i) {
+      barycentre_acceleration += subsystem->mass_fractions[i] *
+                                 all_accelerations[subsystem->indices[i]];
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeSubsystemGravitationalAccelerations(
+    not_null<MultirateGroup*> const subsystem,
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations)
+    const {
+  ComputeGravitationalAccelerationsWithinGroup(*subsystem,
+                                               positions,
+                                               accelerations);
+
+  // The rest of the system is given by the slow group; the other subsystems
+  // are point masses at their barycentres.
+  MultirateGroup const& slow = multirate_->slow;
+  std::size_t const n = positions.size();
+  Position<Frame> const barycentre =
+      InterpolateSlowGroupPosition(subsystem->slow_index, t);
+  for (std::size_t b = 0; b < n; ++b) {
+    subsystem->absolute_positions[b] =
+        barycentre + (positions[b] - Frame::origin);
+  }
+  std::vector<Vector<Acceleration, Frame>>& external_accelerations =
+      subsystem->external_accelerations;
+  external_accelerations.assign(n, Vector<Acceleration, Frame>());
+  for (std::size_t i = 0; i < slow.oblate_bodies.size(); ++i) {
+    ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+        true /*body1_is_oblate*/>(
+        *slow.oblate_bodies[i],
+        InterpolateSlowGroupPosition(i, t),
+        subsystem->absolute_positions,
+        &external_accelerations);
+  }
+
+  // The spherical perturbers are far more numerous.  The accelerations on the
+  // bodies of the subsystem are the reactions computed by the vectorized
+  // kernel; those on the perturbers are discarded.
+  internal::R3ElementsSoA& positions_soa =
+      subsystem->perturbers_positions_soa;
+  internal::R3ElementsSoA& accelerations_soa =
+      subsystem->perturbers_accelerations_soa;
+  std::size_t const size =
+      subsystem->perturbers_gravitational_parameters.size();
+  for (std::size_t k = 0; k < size; ++k) {
+    R3Element<Length> const coordinates =
+        ((k < n ? subsystem->absolute_positions[k]
+                : InterpolateSlowGroupPosition(
+                      subsystem->spherical_perturbers[k - n], t)) -
+         Frame::origin).coordinates();
+    positions_soa.x[k] = coordinates.x / SIUnit<Length>();
+    positions_soa.y[k] = coordinates.y / SIUnit<Length>();
+    positions_soa.z[k] = coordinates.z / SIUnit<Length>();
+  }
+  accelerations_soa.Clear(0, size);
+  for (std::size_t b = 0; b < n; ++b) {
+    internal::AddGravitationalAccelerationsBetweenPointMasses(
+        b,
+        n /*b2_begin*/,
+        size /*b2_end*/,
+        positions_soa,
+        subsystem->perturbers_gravitational_parameters,
+        &accelerations_soa);
+    external_accelerations[b] += Vector<Acceleration, Frame>(
+        {accelerations_soa.x[b] * SIUnit<Acceleration>(),
+         accelerations_soa.y[b] * SIUnit<Acceleration>(),
+         accelerations_soa.z[b] * SIUnit<Acceleration>()});
+  }
+
+  // Subtract the acceleration of the barycentre, which is accounted for by the
+  // slow group.  Only the tidal part of the external accelerations remains.
+  // The internal accelerations would cancel out if it were not for the
+  // exemptions from Newton's third law.
+  Vector<Acceleration, Frame> barycentre_acceleration;
+  for (std::size_t b = 0; b < n; ++b) {
+    (*accelerations)[b] += external_accelerations[b];
+    barycentre_acceleration +=
+        subsystem->mass_fractions[b] * (*accelerations)[b];
+  }
+  for (std::size_t b = 0; b < n; ++b) {
+    (*accelerations)[b] -= barycentre_acceleration;
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations) {
+  accelerations->assign(accelerations->size(), Vector<Acceleration, Frame>());
+
+  // Pack the positions of the spherical bodies for the vectorized kernel.
+  for (std::size_t b = number_of_oblate_bodies_; b < positions.size(); ++b) {
+    R3Element<Length> const coordinates =
+        (positions[b] - Frame::origin).coordinates();
+    positions_soa_.x[b] = coordinates.x / SIUnit<Length>();
+    positions_soa_.y[b] = coordinates.y / SIUnit<Length>();
+    positions_soa_.z[b] = coordinates.z / SIUnit<Length>();
+  }
+
+  if (tree_ != nullptr) {
+    AddMinorBodiesGravitationalAccelerations(accelerations);
+  }
+
+  if (thread_pool_ == nullptr) {
+    ComputeGravitationalAccelerationsBetweenMassiveBodies(
+        0 /*b1_begin*/,
+        number_of_oblate_bodies_ + number_of_spherical_bodies_ /*b1_end*/,
+        positions,
+        positions_soa_,
+        accelerations,
+        &worker_accelerations_soa_[0]);
+    return;
+  }
+
+  // Each worker accumulates the accelerations for its pairs in its own
+  // buffer, so there is no contention between the workers.
+  std::vector<std::future<void>> futures;
+  futures.reserve(worker_accelerations_.size());
+  for (int w = 0; w < worker_accelerations_.size(); ++w) {
+    futures.push_back(thread_pool_->Add([this, w, &positions]() {
+      std::vector<Vector<Acceleration, Frame>>& worker_accelerations =
+          worker_accelerations_[w];
+      worker_accelerations.assign(positions.size(),
+                                  Vector<Acceleration, Frame>());
+      ComputeGravitationalAccelerationsBetweenMassiveBodies(
+          worker_b1_begin_[w],
+          worker_b1_begin_[w + 1],
+          positions,
+          positions_soa_,
+          &worker_accelerations,
+          &worker_accelerations_soa_[w]);
+    }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+
+  // The reduction is done in worker order, irrespective of the order in which
+  // the workers completed, so that the result is reproducible.
+  for (auto const& worker_accelerations : worker_accelerations_) {
+    for (std::size_t b = 0; b < worker_accelerations.size(); ++b) {
+      (*accelerations)[b] += worker_accelerations[b];
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::
+ComputeMassiveBodiesGravitationalAccelerationsConcurrently(
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations)
+    const {
+  CHECK(tree_ == nullptr);
+  accelerations->assign(accelerations->size(), Vector<Acceleration, Frame>());
+
+  // Same packing as |ComputeMassiveBodiesGravitationalAccelerations|, but in
+  // scratch space local to the thread.  These objects are static to avoid
+  // reallocation at each evaluation.  They are thread-local because the slices
+  // are integrated by different threads.
+  static thread_local internal::R3ElementsSoA positions_soa;
+  static thread_local internal::R3ElementsSoA spherical_accelerations;
+  positions_soa.resize(positions.size());
+  spherical_accelerations.resize(positions.size());
+  for (std::size_t b = number_of_oblate_bodies_; b < positions.size(); ++b) {
+    R3Element<Length> const coordinates =
+        (positions[b] - Frame::origin).coordinates();
+    positions_soa.x[b] = coordinates.x / SIUnit<Length>();
+    positions_soa.y[b] = coordinates.y / SIUnit<Length>();
+    positions_soa.z[b] = coordinates.z / SIUnit<Length>();
+  }
+
+  ComputeGravitationalAccelerationsBetweenMassiveBodies(
+      0 /*b1_begin*/,
+      number_of_oblate_bodies_ + number_of_spherical_bodies_ /*b1_end*/,
+      positions,
+      positions_soa,
+      accelerations,
+      &spherical_accelerations);
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
       std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
@@ -459,20 +2345,38 @@ void Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
       std::vector<Position<Frame>> const& positions,
       not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
       not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
-          const hints) {
+          const hints,
+      not_null<std::vector<Position<Frame>>*> const massive_bodies_positions,
+      PrunedPerturbers* const pruned_perturbers) {
   CHECK_EQ(trajectories.size(), positions.size());
   CHECK_EQ(trajectories.size(), accelerations->size());
+  CHECK_EQ(bodies_.size(), massive_bodies_positions->size());
   accelerations->assign(accelerations->size(), Vector<Acceleration, Frame>());
 
+  bool reevaluate = false;
+  if (pruned_perturbers != nullptr) {
+    ++pruned_perturbers->evaluations;
+    reevaluate = t < pruned_perturbers->last_reevaluation ||
+                 t >= pruned_perturbers->next_reevaluation;
+    if (reevaluate) {
+      pruned_perturbers->largest_accelerations.assign(bodies_.size(),
+                                                      Acceleration());
+    }
+  }
+
+  // The Чебышёв series of each massive body is evaluated once for all the
+  // massless bodies.
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *oblate_bodies_[b1];
-    ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+    AddGravitationalAccelerationByMassiveBodyOnMasslessBodies<
         true /*body1_is_oblate*/>(
-        t,
-        body1, b1,
+        body1, b1, t,
         positions,
         accelerations,
-        hints);
+        hints,
+        massive_bodies_positions,
+        pruned_perturbers,
+        reevaluate);
   }
   for (std::size_t b1 = number_of_oblate_bodies_;
        b1 < number_of_oblate_bodies_ +
@@ -480,13 +2384,18 @@ void Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
        ++b1) {
     MassiveBody const& body1 =
         *spherical_bodies_[b1 - number_of_oblate_bodies_];
-    ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+    AddGravitationalAccelerationByMassiveBodyOnMasslessBodies<
         false /*body1_is_oblate*/>(
-        t,
-        body1, b1,
+        body1, b1, t,
         positions,
         accelerations,
-        hints);
+        hints,
+        massive_bodies_positions,
+        pruned_perturbers,
+        reevaluate);
+  }
+  if (reevaluate) {
+    PrunePerturbers(t, pruned_perturbers);
   }
   // Finally, take into account the intrinsic accelerations.
   for (std::size_t b2 = 0; b2 < trajectories.size(); ++b2) {
@@ -499,6 +2408,249 @@ void Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::ComputeEnsembleGravitationalAccelerations(
+    std::vector<not_null<Trajectory<Frame>*>> const& trajectories,
+    Instant const& t,
+    std::vector<Position<Frame>> const& positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints,
+    not_null<internal::R3ElementsSoA*> const positions_soa,
+    not_null<internal::R3ElementsSoA*> const accelerations_soa) const {
+  std::size_t const size = positions.size();
+  CHECK_EQ(trajectories.size(), size);
+  CHECK_EQ(trajectories.size(), accelerations->size());
+  accelerations->assign(size, Vector<Acceleration, Frame>());
+
+  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+    ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+        true /*body1_is_oblate*/>(
+        *oblate_bodies_[b1],
+        trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]),
+        positions,
+        accelerations);
+  }
+
+  // The accelerations of the oblate bodies are packed with the positions so
+  // that the contributions are summed in the same order as in
+  // |ComputeMasslessBodiesGravitationalAccelerations|.
+  for (std::size_t k = 0; k < size; ++k) {
+    R3Element<Length> const coordinates =
+        (positions[k] - Frame::origin).coordinates();
+    positions_soa->x[k] = coordinates.x / SIUnit<Length>();
+    positions_soa->y[k] = coordinates.y / SIUnit<Length>();
+    positions_soa->z[k] = coordinates.z / SIUnit<Length>();
+    R3Element<Acceleration> const acceleration =
+        (*accelerations)[k].coordinates();
+    accelerations_soa->x[k] = acceleration.x / SIUnit<Acceleration>();
+    accelerations_soa->y[k] = acceleration.y / SIUnit<Acceleration>();
+    accelerations_soa->z[k] = acceleration.z / SIUnit<Acceleration>();
+  }
+  for (std::size_t b1 = number_of_oblate_bodies_;
+       b1 < number_of_oblate_bodies_ +
+            number_of_spherical_bodies_;
+       ++b1) {
+    R3Element<Length> const coordinates =
+        (trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]) -
+         Frame::origin).coordinates();
+    internal::AddGravitationalAccelerationsOnTestParticles(
+        coordinates.x / SIUnit<Length>(),
+        coordinates.y / SIUnit<Length>(),
+        coordinates.z / SIUnit<Length>(),
+        gravitational_parameters_[b1],
+        0 /*begin*/,
+        size /*end*/,
+        *positions_soa,
+        accelerations_soa);
+  }
+  for (std::size_t k = 0; k < size; ++k) {
+    (*accelerations)[k] = Vector<Acceleration, Frame>(
+        {accelerations_soa->x[k] * SIUnit<Acceleration>(),
+         accelerations_soa->y[k] * SIUnit<Acceleration>(),
+         accelerations_soa->z[k] * SIUnit<Acceleration>()});
+  }
+
+  for (std::size_t b2 = 0; b2 < trajectories.size(); ++b2) {
+    auto const& trajectory = trajectories[b2];
+    if (trajectory->has_intrinsic_acceleration()) {
+      Vector<Acceleration, Frame> const intrinsic_acceleration =
+          trajectory->evaluate_intrinsic_acceleration(t);
+      (*accelerations)[b2] += intrinsic_acceleration;
+    }
+  }
+}
+
+template<typename Frame>
+std::size_t Ephemeris<Frame>::DominantBody(
+    Instant const& t,
+    Position<Frame> const& position,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints) const {
+  std::size_t dominant_body = 0;
+  Acceleration largest_acceleration;
+  for (std::size_t b = 0; b < bodies_.size(); ++b) {
+    Length const distance =
+        (trajectories_[b]->EvaluatePosition(t, &(*hints)[b]) - position).Norm();
+    Acceleration const acceleration =
+        bodies_[b]->gravitational_parameter() / (distance * distance);
+    if (acceleration > largest_acceleration) {
+      dominant_body = b;
+      largest_acceleration = acceleration;
+    }
+  }
+  return dominant_body;
+}
+
+template<typename Frame>
+Vector<Acceleration, Frame>
+Ephemeris<Frame>::ComputeMasslessBodyDeviationAcceleration(
+    Trajectory<Frame> const& trajectory,
+    std::size_t const primary,
+    Instant const& t,
+    Displacement<Frame> const& ρ,
+    Displacement<Frame> const& δ,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints,
+    not_null<std::vector<Position<Frame>>*> const positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+    const {
+  CHECK_EQ(2, positions->size());
+  CHECK_EQ(2, perturbations->size());
+
+  // The position of the massless body relative to the primary.
+  Displacement<Frame> const r = ρ + δ;
+  Position<Frame> const primary_position =
+      trajectories_[primary]->EvaluatePosition(t, &(*hints)[primary]);
+
+  // The difference between the Keplerian accelerations at r and ρ, written as
+  // -μ / ρ³ (δ + f(q) r) with q = δ · (δ - 2 r) / r² and f(q) = (1 + q)^3/2 - 1
+  // to avoid the cancellation (Battin, An Introduction to the Mathematics and
+  // Methods of Astrodynamics, 1999, section 10.2).
+  Exponentiation<Length, 2> const r_squared = InnerProduct(r, r);
+  double const q = InnerProduct(δ, δ - 2 * r) / r_squared;
+  double const f = q * (3 + q * (3 + q)) / (1 + std::sqrt(1 + q) * (1 + q));
+  Length const ρ_norm = ρ.Norm();
+  Vector<Acceleration, Frame> acceleration =
+      -bodies_[primary]->gravitational_parameter() /
+          (ρ_norm * ρ_norm * ρ_norm) * (δ + f * r);
+
+  // The oblateness of the primary is a perturbation of the reference orbit.
+  if (primary < number_of_oblate_bodies_) {
+    Exponentiation<Length, -2> const one_over_r_squared = 1 / r_squared;
+    acceleration += Order2ZonalAcceleration<Frame>(
+        static_cast<OblateBody<Frame> const&>(*bodies_[primary]),
+        -r,
+        one_over_r_squared,
+        Sqrt(one_over_r_squared) * one_over_r_squared);
+  }
+
+  // The other bodies act through the difference between their accelerations on
+  // the massless body and on the primary.
+  (*positions)[0] = primary_position + r;
+  (*positions)[1] = primary_position;
+  perturbations->assign(2, Vector<Acceleration, Frame>());
+  for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
+    if (b1 != primary) {
+      ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+          true /*body1_is_oblate*/>(
+          *bodies_[b1],
+          trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]),
+          *positions,
+          perturbations);
+    }
+  }
+  for (std::size_t b1 = number_of_oblate_bodies_; b1 < bodies_.size(); ++b1) {
+    if (b1 != primary) {
+      ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+          false /*body1_is_oblate*/>(
+          *bodies_[b1],
+          trajectories_[b1]->EvaluatePosition(t, &(*hints)[b1]),
+          *positions,
+          perturbations);
+    }
+  }
+  acceleration += (*perturbations)[0] - (*perturbations)[1];
+
+  if (trajectory.has_intrinsic_acceleration()) {
+    acceleration += trajectory.evaluate_intrinsic_acceleration(t);
+  }
+  return acceleration;
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMasslessBodyDeviationAccelerations(
+    Trajectory<Frame> const& trajectory,
+    std::size_t const primary,
+    KeplerOrbit<Frame> const& reference_orbit,
+    Instant const& t,
+    std::vector<Position<Frame>> const& deviations,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints,
+    not_null<std::vector<Position<Frame>>*> const positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+    const {
+  CHECK_EQ(1, deviations.size());
+  CHECK_EQ(1, accelerations->size());
+  (*accelerations)[0] = ComputeMasslessBodyDeviationAcceleration(
+      trajectory,
+      primary,
+      t,
+      reference_orbit.EvaluateRelativeDegreesOfFreedom(t).displacement(),
+      deviations[0] - Frame::origin,
+      hints,
+      positions,
+      perturbations);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::ComputeMasslessBodyRegularizedDeviationAccelerations(
+    Trajectory<Frame> const& trajectory,
+    std::size_t const primary,
+    KeplerOrbit<Frame> const& reference_orbit,
+    Instant const& sundman_time,
+    std::vector<Position<Frame>> const& scaled_deviations,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const accelerations,
+    not_null<std::vector<typename ContinuousTrajectory<Frame>::Hint>*>
+        const hints,
+    not_null<std::vector<Position<Frame>>*> const positions,
+    not_null<std::vector<Vector<Acceleration, Frame>>*> const perturbations)
+    const {
+  CHECK_EQ(1, scaled_deviations.size());
+  CHECK_EQ(1, accelerations->size());
+
+  Instant t;
+  RelativeDegreesOfFreedom<Frame> const reference =
+      reference_orbit.EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+          sundman_time - reference_orbit.epoch(), &t);
+  double dt_ds;
+  Exponentiation<Time, -1> d2t_ds2;
+  Exponentiation<Time, -2> d3t_ds3;
+  SundmanTimeDerivatives(reference_orbit, reference,
+                         &dt_ds, &d2t_ds2, &d3t_ds3);
+
+  // With t' = dt / ds, the substitution δ = √t' w eliminates the first
+  // derivative from the transformed equation, which becomes
+  //   w" = t'^3/2 δ̈ - (t‴ / 2 t' - 3/4 (t" / t')²) w.
+  double const sqrt_dt_ds = std::sqrt(dt_ds);
+  Displacement<Frame> const w = scaled_deviations[0] - Frame::origin;
+  Vector<Acceleration, Frame> const δ_acceleration =
+      ComputeMasslessBodyDeviationAcceleration(trajectory,
+                                               primary,
+                                               t,
+                                               reference.displacement(),
+                                               sqrt_dt_ds * w,
+                                               hints,
+                                               positions,
+                                               perturbations);
+  Exponentiation<Time, -1> const d2t_ds2_over_dt_ds = d2t_ds2 / dt_ds;
+  (*accelerations)[0] =
+      dt_ds * sqrt_dt_ds * δ_acceleration -
+      (d3t_ds3 / (2 * dt_ds) - 0.75 * d2t_ds2_over_dt_ds * d2t_ds2_over_dt_ds) *
+          w;
+}
+
 template<typename Frame>
 double Ephemeris<Frame>::ToleranceToErrorRatio(
     Length const& length_integration_tolerance,
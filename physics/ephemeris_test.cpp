@@ -1,6 +1,9 @@
 ﻿#include "physics/ephemeris.hpp"
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <map>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
 
 #include "geometry/frame.hpp"
@@ -8,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "integrators/wisdom_holman_integrator.hpp"
 #include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/si.hpp"
@@ -18,13 +22,19 @@
 
 namespace principia {
 
+using base::make_not_null_unique;
 using integrators::DormandElMikkawyPrince1986RKN434FM;
+using integrators::McLachlanAtela1992Order4Optimal;
 using integrators::McLachlanAtela1992Order5Optimal;
+using integrators::kProportionalIntegral;
+using integrators::WisdomHolman1991;
 using quantities::Abs;
 using quantities::ArcTan;
 using quantities::Area;
+using quantities::GravitationalParameter;
 using quantities::Pow;
 using quantities::Sqrt;
+using si::Day;
 using si::Kilogram;
 using si::Metre;
 using si::Milli;
@@ -36,6 +46,7 @@ using testing_utilities::kSolarSystemBarycentre;
 using testing_utilities::RelativeError;
 using testing_utilities::SolarSystem;
 using ::testing::Eq;
+using ::testing::Ge;
 using ::testing::Gt;
 using ::testing::Lt;
 
@@ -86,6 +97,91 @@ class EphemerisTest : public testing::Test {
     initial_state->push_back(DegreesOfFreedom<EarthMoonOrbitPlane>(q2, v2));
   }
 
+  // An ephemeris of the system of |SetUpEarthMoonSystem| with a step of a
+  // hundredth of the period, and the massless probes flowed with it.
+  struct EarthMoonEphemeris {
+    std::unique_ptr<Ephemeris<EarthMoonOrbitPlane>> ephemeris;
+    MassiveBody const* earth;
+    MassiveBody const* moon;
+    std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+    Position<EarthMoonOrbitPlane> centre_of_mass;
+    Time period;
+    std::vector<std::unique_ptr<MasslessBody>> probes;
+    std::vector<std::unique_ptr<Trajectory<EarthMoonOrbitPlane>>> trajectories;
+  };
+
+  EarthMoonEphemeris MakeEarthMoonEphemeris(int const number_of_threads) {
+    EarthMoonEphemeris result;
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    SetUpEarthMoonSystem(&bodies,
+                         &result.initial_state,
+                         &result.centre_of_mass,
+                         &result.period);
+    result.earth = bodies[0].get();
+    result.moon = bodies[1].get();
+    result.ephemeris = std::make_unique<Ephemeris<EarthMoonOrbitPlane>>(
+        std::move(bodies),
+        result.initial_state,
+        t0_,
+        McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>(),
+        result.period / 100,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre),
+        number_of_threads);
+    return result;
+  }
+
+  // Adds to |ephemeris| a probe whose trajectory starts at |t0_| with the
+  // given |degrees_of_freedom|, and returns that trajectory.
+  not_null<Trajectory<EarthMoonOrbitPlane>*> AddProbe(
+      DegreesOfFreedom<EarthMoonOrbitPlane> const& degrees_of_freedom,
+      not_null<EarthMoonEphemeris*> const ephemeris) {
+    ephemeris->probes.push_back(std::make_unique<MasslessBody>());
+    ephemeris->trajectories.push_back(
+        std::make_unique<Trajectory<EarthMoonOrbitPlane>>(
+            ephemeris->probes.back().get()));
+    ephemeris->trajectories.back()->Append(t0_, degrees_of_freedom);
+    return ephemeris->trajectories.back().get();
+  }
+
+  // Adds |count| probes to |ephemeris|, the i-th of which starts (i + 1) 1E8 m
+  // from the centre of mass with a speed of (i + 1) 100 m/s, and returns their
+  // trajectories.
+  std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> AddProbes(
+      int const count,
+      not_null<EarthMoonEphemeris*> const ephemeris) {
+    std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> trajectories;
+    for (int i = 0; i < count; ++i) {
+      trajectories.push_back(AddProbe(
+          DegreesOfFreedom<EarthMoonOrbitPlane>(
+              ephemeris->centre_of_mass +
+                  Vector<Length, EarthMoonOrbitPlane>({(i + 1) * 1E8 * Metre,
+                                                       0 * Metre,
+                                                       0 * Metre}),
+              Velocity<EarthMoonOrbitPlane>({0 * SIUnit<Speed>(),
+                                             (i + 1) * 100 * SIUnit<Speed>(),
+                                             0 * SIUnit<Speed>()})),
+          ephemeris));
+    }
+    return trajectories;
+  }
+
+  // Checks that the probes of |actual| took the same steps as those of
+  // |expected| and ended in exactly the same states.
+  void ExpectSameProbes(EarthMoonEphemeris const& expected,
+                        EarthMoonEphemeris const& actual) {
+    ASSERT_THAT(actual.trajectories.size(), Eq(expected.trajectories.size()));
+    for (int i = 0; i < expected.trajectories.size(); ++i) {
+      EXPECT_THAT(actual.trajectories[i]->Times().size(),
+                  Eq(expected.trajectories[i]->Times().size())) << i;
+      EXPECT_THAT(actual.trajectories[i]->last().time(),
+                  Eq(expected.trajectories[i]->last().time())) << i;
+      EXPECT_THAT(actual.trajectories[i]->last().degrees_of_freedom(),
+                  Eq(expected.trajectories[i]->last().degrees_of_freedom()))
+          << i;
+    }
+  }
+
   Instant t0_;
 };
 
@@ -143,6 +239,42 @@ TEST_F(EphemerisTest, EarthMoon) {
   EXPECT_THAT(Abs(moon_positions[100].coordinates().x), Lt(2 * Metre));
 }
 
+// The Wisdom-Holman map is usable as the planetary integrator.  For two bodies
+// its error is proportional to the mass ratio, so with 10 steps per orbit it is
+// much more accurate than a fifth-order method.
+TEST_F(EphemerisTest, WisdomHolman) {
+  auto const moon_position_error = [this](
+      FixedStepSizeIntegrator<
+          Ephemeris<EarthMoonOrbitPlane>::NewtonianMotionEquation> const&
+          planetary_integrator) {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+    Position<EarthMoonOrbitPlane> centre_of_mass;
+    Time period;
+    SetUpEarthMoonSystem(&bodies, &initial_state, &centre_of_mass, &period);
+    MassiveBody const* const moon = bodies[1].get();
+    Position<EarthMoonOrbitPlane> const moon_initial_position =
+        initial_state[1].position();
+    Ephemeris<EarthMoonOrbitPlane> ephemeris(std::move(bodies),
+                                             initial_state,
+                                             t0_,
+                                             planetary_integrator,
+                                             period / 10,
+                                             0.1 * Milli(Metre),
+                                             5 * Milli(Metre));
+    ephemeris.Prolong(t0_ + period);
+    return (ephemeris.trajectory(moon).EvaluatePosition(t0_ + period,
+                                                        nullptr) -
+            moon_initial_position).Norm();
+  };
+  Length const wisdom_holman_error =
+      moon_position_error(WisdomHolman1991<EarthMoonOrbitPlane>());
+  Length const order_5_error = moon_position_error(
+      McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>());
+  EXPECT_THAT(wisdom_holman_error, Lt(5E4 * Metre));
+  EXPECT_THAT(order_5_error, Gt(10 * wisdom_holman_error));
+}
+
 // The Moon alone.  It moves in straight line.
 TEST_F(EphemerisTest, Moon) {
   Position<EarthMoonOrbitPlane> const reference_position;
@@ -418,6 +550,800 @@ TEST_F(EphemerisTest, EarthTwoProbes) {
               Eq(q_probe2));
 }
 
+// The accelerations between the massive bodies computed by multiple threads are
+// reproducible and agree with those computed by a single thread.
+TEST_F(EphemerisTest, ParallelMassiveBodies) {
+  auto const make_ephemeris = [](int const number_of_threads) {
+    not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+        SolarSystem::AtСпутник1Launch(
+            SolarSystem::Accuracy::kAllBodiesAndOblateness);
+    return std::make_unique<Ephemeris<ICRFJ2000Ecliptic>>(
+        at_спутник_1_launch->massive_bodies(),
+        at_спутник_1_launch->initial_state(),
+        at_спутник_1_launch->time(),
+        McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>(),
+        45 * Minute,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre),
+        number_of_threads);
+  };
+  Instant const final_time =
+      SolarSystem::AtСпутник1Launch(
+          SolarSystem::Accuracy::kMajorBodiesOnly)->time() + 30 * Day;
+  auto const sequential_ephemeris = make_ephemeris(1);
+  auto const parallel_ephemeris1 = make_ephemeris(4);
+  auto const parallel_ephemeris2 = make_ephemeris(4);
+  sequential_ephemeris->Prolong(final_time);
+  parallel_ephemeris1->Prolong(final_time);
+  parallel_ephemeris2->Prolong(final_time);
+
+  for (std::size_t i = 0; i < sequential_ephemeris->bodies().size(); ++i) {
+    Position<ICRFJ2000Ecliptic> const sequential_position =
+        sequential_ephemeris->trajectory(sequential_ephemeris->bodies()[i]).
+            EvaluatePosition(final_time, nullptr);
+    Position<ICRFJ2000Ecliptic> const parallel_position1 =
+        parallel_ephemeris1->trajectory(parallel_ephemeris1->bodies()[i]).
+            EvaluatePosition(final_time, nullptr);
+    Position<ICRFJ2000Ecliptic> const parallel_position2 =
+        parallel_ephemeris2->trajectory(parallel_ephemeris2->bodies()[i]).
+            EvaluatePosition(final_time, nullptr);
+    EXPECT_THAT(parallel_position1, Eq(parallel_position2))
+        << SolarSystem::name(i);
+    EXPECT_THAT(RelativeError(sequential_position - kSolarSystemBarycentre,
+                              parallel_position1 - kSolarSystemBarycentre),
+                Lt(1E-13)) << SolarSystem::name(i);
+  }
+}
+
+// A probe in low orbit around the Earth doesn't feel a small, distant body,
+// which is skipped almost all the time.  The Earth and the Moon are never
+// skipped, and the trajectory is essentially unaffected.
+TEST_F(EphemerisTest, PerturberPruning) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+  Position<EarthMoonOrbitPlane> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(&bodies, &initial_state, &centre_of_mass, &period);
+  bodies.push_back(make_not_null_unique<MassiveBody const>(1E16 * Kilogram));
+  initial_state.emplace_back(
+      initial_state[0].position() +
+          Vector<Length, EarthMoonOrbitPlane>(
+              {1E11 * Metre, 0 * Metre, 0 * Metre}),
+      initial_state[0].velocity());
+
+  MassiveBody const* const earth = bodies[0].get();
+  MassiveBody const* const moon = bodies[1].get();
+  MassiveBody const* const asteroid = bodies[2].get();
+
+  Ephemeris<EarthMoonOrbitPlane>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>(),
+          period / 100,
+          0.1 * Milli(Metre),
+          5 * Milli(Metre));
+
+  Length const radius = 7E6 * Metre;
+  Speed const speed = Sqrt(earth->gravitational_parameter() / radius);
+  DegreesOfFreedom<EarthMoonOrbitPlane> const probe_initial_state(
+      initial_state[0].position() +
+          Vector<Length, EarthMoonOrbitPlane>(
+              {radius, 0 * Metre, 0 * Metre}),
+      initial_state[0].velocity() +
+          Velocity<EarthMoonOrbitPlane>(
+              {0 * SIUnit<Speed>(), speed, 0 * SIUnit<Speed>()}));
+  MasslessBody probe;
+  std::vector<std::unique_ptr<Trajectory<EarthMoonOrbitPlane>>> trajectories;
+  for (int i = 0; i < 4; ++i) {
+    trajectories.push_back(
+        std::make_unique<Trajectory<EarthMoonOrbitPlane>>(&probe));
+    trajectories.back()->Append(t0_, probe_initial_state);
+  }
+
+  Ephemeris<EarthMoonOrbitPlane>::PerturberPruning const pruning =
+      {1 * Minute /*reevaluation_interval*/, 0.1 /*tolerance_fraction*/};
+  Instant const t_final = t0_ + period / 10;
+  ephemeris.FlowWithAdaptiveStep(
+      trajectories[0].get(),
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final);
+  EXPECT_THAT(ephemeris.number_of_pruned_evaluations(), Eq(0));
+  ephemeris.FlowWithAdaptiveStep(
+      trajectories[1].get(),
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final,
+      &pruning);
+  std::int64_t const adaptive_step_evaluations =
+      ephemeris.number_of_pruned_evaluations();
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(earth), Eq(0));
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(moon), Eq(0));
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(asteroid),
+              Gt(0.9 * adaptive_step_evaluations));
+  EXPECT_THAT(trajectories[1]->last().time(),
+              Eq(trajectories[0]->last().time()));
+  EXPECT_THAT((trajectories[1]->last().degrees_of_freedom().position() -
+               trajectories[0]->last().degrees_of_freedom().position()).Norm(),
+              Lt(1 * Milli(Metre)));
+
+  ephemeris.FlowWithFixedStep({trajectories[2].get()}, 10 * Second, t_final);
+  ephemeris.FlowWithFixedStep({trajectories[3].get()},
+                              10 * Second,
+                              t_final,
+                              &pruning);
+  EXPECT_THAT(ephemeris.number_of_pruned_evaluations(),
+              Gt(adaptive_step_evaluations));
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(earth), Eq(0));
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(moon), Eq(0));
+  EXPECT_THAT(ephemeris.number_of_skipped_evaluations(asteroid),
+              Gt(0.9 * ephemeris.number_of_pruned_evaluations()));
+  EXPECT_THAT((trajectories[3]->last().degrees_of_freedom().position() -
+               trajectories[2]->last().degrees_of_freedom().position()).Norm(),
+              Lt(1 * Milli(Metre)));
+}
+
+// For a probe in low orbit around the Earth, Encke's method gives a more
+// accurate trajectory than Cowell's method with far fewer steps.  Choosing the
+// primary automatically is the same as choosing the Earth.
+TEST_F(EphemerisTest, Encke) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+  Position<EarthMoonOrbitPlane> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(&bodies, &initial_state, &centre_of_mass, &period);
+
+  MassiveBody const* const earth = bodies[0].get();
+
+  Ephemeris<EarthMoonOrbitPlane>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>(),
+          period / 100,
+          0.1 * Milli(Metre),
+          5 * Milli(Metre));
+
+  Length const radius = 7E6 * Metre;
+  Speed const speed = Sqrt(earth->gravitational_parameter() / radius);
+  DegreesOfFreedom<EarthMoonOrbitPlane> const probe_initial_state(
+      initial_state[0].position() +
+          Vector<Length, EarthMoonOrbitPlane>(
+              {radius, 0 * Metre, 0 * Metre}),
+      initial_state[0].velocity() +
+          Velocity<EarthMoonOrbitPlane>(
+              {0 * SIUnit<Speed>(), 1.1 * speed, 0.1 * speed}));
+  MasslessBody probe;
+  Trajectory<EarthMoonOrbitPlane> reference(&probe);
+  Trajectory<EarthMoonOrbitPlane> cowell(&probe);
+  Trajectory<EarthMoonOrbitPlane> encke(&probe);
+  Trajectory<EarthMoonOrbitPlane> automatic_encke(&probe);
+  for (auto const trajectory :
+       {&reference, &cowell, &encke, &automatic_encke}) {
+    trajectory->Append(t0_, probe_initial_state);
+  }
+
+  Instant const t_final = t0_ + period / 10;
+  ephemeris.FlowWithAdaptiveStep(
+      &reference,
+      1E-3 * Milli(Metre),
+      1E-3 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final);
+  ephemeris.FlowWithAdaptiveStep(
+      &cowell,
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final);
+  ephemeris.FlowWithAdaptiveStepRelativeToPrimary(
+      &encke,
+      1E-2 * Milli(Metre),
+      1E-2 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final,
+      {earth /*primary*/, 1E-3 /*rectification_threshold*/});
+  ephemeris.FlowWithAdaptiveStepRelativeToPrimary(
+      &automatic_encke,
+      1E-2 * Milli(Metre),
+      1E-2 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final,
+      {nullptr /*primary*/, 1E-3 /*rectification_threshold*/});
+
+  EXPECT_THAT(encke.last().time(), Eq(t_final));
+  EXPECT_THAT(encke.Times().size(), Lt(cowell.Times().size() / 4));
+  Position<EarthMoonOrbitPlane> const& reference_position =
+      reference.last().degrees_of_freedom().position();
+  EXPECT_THAT((encke.last().degrees_of_freedom().position() -
+               reference_position).Norm(),
+              Lt((cowell.last().degrees_of_freedom().position() -
+                  reference_position).Norm() / 2));
+  EXPECT_THAT(automatic_encke.last().degrees_of_freedom(),
+              Eq(encke.last().degrees_of_freedom()));
+}
+
+// A hyperbolic flyby of the Earth that grazes its surface.  With the close
+// encounter regularized, the trajectory is more accurate and takes far fewer
+// steps than with Cowell's method, which spends most of its steps near the
+// periapsis.
+TEST_F(EphemerisTest, CloseEncounterRegularization) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+  Position<EarthMoonOrbitPlane> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(&bodies, &initial_state, &centre_of_mass, &period);
+
+  MassiveBody const* const earth = bodies[0].get();
+
+  Ephemeris<EarthMoonOrbitPlane>
+      ephemeris(
+          std::move(bodies),
+          initial_state,
+          t0_,
+          McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>(),
+          period / 100,
+          0.1 * Milli(Metre),
+          5 * Milli(Metre));
+
+  // The probe starts 200 000 km from the Earth, with a speed of 4 km/s and an
+  // impact parameter such that the periapsis is 6 600 km from the centre.
+  Length const distance = 2E8 * Metre;
+  Speed const speed = 4E3 * Metre / Second;
+  Length const periapsis = 6.6E6 * Metre;
+  GravitationalParameter const& μ = earth->gravitational_parameter();
+  // Conservation of energy and angular momentum give the periapsis speed and
+  // the impact parameter.
+  Speed const periapsis_speed =
+      Sqrt(speed * speed + 2 * μ / periapsis - 2 * μ / distance);
+  Length const impact_parameter = periapsis * periapsis_speed / speed;
+  DegreesOfFreedom<EarthMoonOrbitPlane> const probe_initial_state(
+      initial_state[0].position() +
+          Vector<Length, EarthMoonOrbitPlane>(
+              {Sqrt(distance * distance - impact_parameter * impact_parameter),
+               impact_parameter,
+               0 * Metre}),
+      initial_state[0].velocity() +
+          Velocity<EarthMoonOrbitPlane>(
+              {-speed, 0 * SIUnit<Speed>(), 0 * SIUnit<Speed>()}));
+  MasslessBody probe;
+  Trajectory<EarthMoonOrbitPlane> reference(&probe);
+  Trajectory<EarthMoonOrbitPlane> cowell(&probe);
+  Trajectory<EarthMoonOrbitPlane> regularized(&probe);
+  for (auto const trajectory : {&reference, &cowell, &regularized}) {
+    trajectory->Append(t0_, probe_initial_state);
+  }
+
+  Instant const t_final = t0_ + 2 * distance / speed;
+  Ephemeris<EarthMoonOrbitPlane>::CloseEncounterRegularization const
+      regularization = {5E7 * Metre /*radius*/,
+                        1E-3 /*rectification_threshold*/};
+  ephemeris.FlowWithAdaptiveStep(
+      &reference,
+      1E-3 * Milli(Metre),
+      1E-3 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final);
+  ephemeris.FlowWithAdaptiveStep(
+      &cowell,
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final);
+  ephemeris.FlowWithAdaptiveStep(
+      &regularized,
+      1 * Milli(Metre),
+      1 * Milli(Metre) / Second,
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+      t_final,
+      nullptr /*pruning*/,
+      &regularization);
+
+  Position<EarthMoonOrbitPlane> const& reference_position =
+      reference.last().degrees_of_freedom().position();
+  EXPECT_THAT(regularized.last().time(), Eq(t_final));
+  EXPECT_THAT(regularized.Times().size(), Lt(cowell.Times().size() / 2));
+  EXPECT_THAT((regularized.last().degrees_of_freedom().position() -
+               reference_position).Norm(),
+              Lt((cowell.last().degrees_of_freedom().position() -
+                  reference_position).Norm()));
+}
+
+// With a zero opening angle the tree computes the same accelerations as the
+// direct kernel, up to the order of summation.  With a positive opening angle
+// the error stays small because the minor bodies are dominated by the major
+// ones, and the parallel computation is reproducible.
+TEST_F(EphemerisTest, TreeGravity) {
+  GravitationalParameter const minor_body_gravitational_parameter =
+      5E12 * Pow<3>(Metre) / Pow<2>(Second);
+  auto const make_ephemeris = [minor_body_gravitational_parameter](
+      int const number_of_threads,
+      double const opening_angle) {
+    not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+        SolarSystem::AtСпутник1Launch(
+            SolarSystem::Accuracy::kAllBodiesAndOblateness);
+    auto ephemeris = std::make_unique<Ephemeris<ICRFJ2000Ecliptic>>(
+        at_спутник_1_launch->massive_bodies(),
+        at_спутник_1_launch->initial_state(),
+        at_спутник_1_launch->time(),
+        McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>(),
+        45 * Minute,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre),
+        number_of_threads);
+    if (opening_angle >= 0) {
+      ephemeris->UseTreeGravityForMinorBodies(
+          minor_body_gravitational_parameter, opening_angle);
+    }
+    return ephemeris;
+  };
+  Instant const final_time =
+      SolarSystem::AtСпутник1Launch(
+          SolarSystem::Accuracy::kMajorBodiesOnly)->time() + 30 * Day;
+  auto const direct_ephemeris = make_ephemeris(1, -1);
+  auto const exact_tree_ephemeris = make_ephemeris(1, 0);
+  auto const tree_ephemeris1 = make_ephemeris(4, 0.5);
+  auto const tree_ephemeris2 = make_ephemeris(4, 0.5);
+  direct_ephemeris->Prolong(final_time);
+  exact_tree_ephemeris->Prolong(final_time);
+  tree_ephemeris1->Prolong(final_time);
+  tree_ephemeris2->Prolong(final_time);
+
+  for (std::size_t i = 0; i < direct_ephemeris->bodies().size(); ++i) {
+    auto const position = [i, &final_time](
+        std::unique_ptr<Ephemeris<ICRFJ2000Ecliptic>> const& ephemeris) {
+      return ephemeris->trajectory(ephemeris->bodies()[i]).
+                 EvaluatePosition(final_time, nullptr) -
+             kSolarSystemBarycentre;
+    };
+    EXPECT_THAT(position(tree_ephemeris1), Eq(position(tree_ephemeris2)))
+        << SolarSystem::name(i);
+    EXPECT_THAT(RelativeError(position(direct_ephemeris),
+                              position(exact_tree_ephemeris)),
+                Lt(1E-12)) << SolarSystem::name(i);
+    EXPECT_THAT(RelativeError(position(direct_ephemeris),
+                              position(tree_ephemeris1)),
+                Lt(1E-10)) << SolarSystem::name(i);
+  }
+}
+
+// Tree gravity moves the minor bodies after the major ones, and the integrator
+// must see their gravitational parameters in the new order.  Here Eris is given
+// where Venus should be, so that the bodies are actually reordered, and the
+// Wisdom-Holman integrator uses the gravitational parameters of the equation.
+TEST_F(EphemerisTest, TreeGravityWisdomHolman) {
+  auto const make_ephemeris = [](bool const tree) {
+    not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+        SolarSystem::AtСпутник1Launch(
+            SolarSystem::Accuracy::kMinorAndMajorBodies);
+    SolarSystem::Bodies bodies = at_спутник_1_launch->massive_bodies();
+    std::vector<DegreesOfFreedom<ICRFJ2000Ecliptic>> initial_state =
+        at_спутник_1_launch->initial_state();
+    std::swap(bodies[SolarSystem::kVenus], bodies[SolarSystem::kEris]);
+    std::swap(initial_state[SolarSystem::kVenus],
+              initial_state[SolarSystem::kEris]);
+    auto ephemeris = std::make_unique<Ephemeris<ICRFJ2000Ecliptic>>(
+        std::move(bodies),
+        initial_state,
+        at_спутник_1_launch->time(),
+        WisdomHolman1991<ICRFJ2000Ecliptic>(),
+        45 * Minute,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre));
+    if (tree) {
+      ephemeris->UseTreeGravityForMinorBodies(
+          5E12 * Pow<3>(Metre) / Pow<2>(Second), 0 /*opening_angle*/);
+    }
+    return ephemeris;
+  };
+  Instant const final_time =
+      SolarSystem::AtСпутник1Launch(
+          SolarSystem::Accuracy::kMajorBodiesOnly)->time() + 30 * Day;
+  auto const direct_ephemeris = make_ephemeris(false);
+  auto const tree_ephemeris = make_ephemeris(true);
+  direct_ephemeris->Prolong(final_time);
+  tree_ephemeris->Prolong(final_time);
+
+  for (std::size_t i = 0; i < direct_ephemeris->bodies().size(); ++i) {
+    auto const position = [i, &final_time](
+        std::unique_ptr<Ephemeris<ICRFJ2000Ecliptic>> const& ephemeris) {
+      return ephemeris->trajectory(ephemeris->bodies()[i]).
+                 EvaluatePosition(final_time, nullptr) -
+             kSolarSystemBarycentre;
+    };
+    EXPECT_THAT(RelativeError(position(direct_ephemeris),
+                              position(tree_ephemeris)),
+                Lt(1E-12)) << i;
+  }
+}
+
+// The multirate integration agrees with the single-rate one to much better
+// than the truncation error of the latter, and is reproducible when the
+// subsystems are integrated concurrently.
+TEST_F(EphemerisTest, Multirate) {
+  auto const make_ephemeris = [](int const number_of_threads,
+                                 bool const multirate) {
+    not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+        SolarSystem::AtСпутник1Launch(
+            SolarSystem::Accuracy::kAllBodiesAndOblateness);
+    auto ephemeris = std::make_unique<Ephemeris<ICRFJ2000Ecliptic>>(
+        at_спутник_1_launch->massive_bodies(),
+        at_спутник_1_launch->initial_state(),
+        at_спутник_1_launch->time(),
+        McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>(),
+        45 * Minute,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre),
+        number_of_threads);
+    if (multirate) {
+      ephemeris->UseMultirateIntegration(8 /*maximum_step_multiple*/);
+    }
+    return ephemeris;
+  };
+  Instant const final_time =
+      SolarSystem::AtСпутник1Launch(
+          SolarSystem::Accuracy::kMajorBodiesOnly)->time() + 365 * Day;
+  auto const single_rate_ephemeris = make_ephemeris(1, false);
+  auto const multirate_ephemeris1 = make_ephemeris(4, true);
+  auto const multirate_ephemeris2 = make_ephemeris(4, true);
+  single_rate_ephemeris->Prolong(final_time);
+  multirate_ephemeris1->Prolong(final_time);
+  multirate_ephemeris2->Prolong(final_time);
+
+  for (std::size_t i = 0; i < single_rate_ephemeris->bodies().size(); ++i) {
+    auto const position = [i, &final_time](
+        std::unique_ptr<Ephemeris<ICRFJ2000Ecliptic>> const& ephemeris) {
+      return ephemeris->trajectory(ephemeris->bodies()[i]).
+                 EvaluatePosition(final_time, nullptr) -
+             kSolarSystemBarycentre;
+    };
+    EXPECT_THAT(position(multirate_ephemeris1),
+                Eq(position(multirate_ephemeris2))) << SolarSystem::name(i);
+    EXPECT_THAT(RelativeError(position(single_rate_ephemeris),
+                              position(multirate_ephemeris1)),
+                Lt(1E-9)) << SolarSystem::name(i);
+  }
+}
+
+// The Parareal integration of the Earth-Moon system converges to the serial
+// integration, including for the prolongations that don't fill a window.
+TEST_F(EphemerisTest, Parareal) {
+  Time period;
+  auto const make_ephemeris = [this, &period](int const number_of_threads,
+                                              bool const parareal) {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    std::vector<DegreesOfFreedom<EarthMoonOrbitPlane>> initial_state;
+    Position<EarthMoonOrbitPlane> centre_of_mass;
+    SetUpEarthMoonSystem(&bodies, &initial_state, &centre_of_mass, &period);
+    auto ephemeris = std::make_unique<Ephemeris<EarthMoonOrbitPlane>>(
+        std::move(bodies),
+        initial_state,
+        t0_,
+        McLachlanAtela1992Order5Optimal<Position<EarthMoonOrbitPlane>>(),
+        period / 100,
+        0.1 * Milli(Metre),
+        5 * Milli(Metre),
+        number_of_threads);
+    if (parareal) {
+      ephemeris->UsePararealIntegration(
+          McLachlanAtela1992Order4Optimal<Position<EarthMoonOrbitPlane>>(),
+          4 /*number_of_slices*/,
+          10 /*steps_per_slice*/,
+          2 /*coarse_steps_per_slice*/,
+          1 * Milli(Metre) /*length_integration_tolerance*/,
+          1 * Milli(Metre) / Second /*speed_integration_tolerance*/);
+    }
+    return ephemeris;
+  };
+  auto const serial_ephemeris = make_ephemeris(1, false);
+  auto const parareal_ephemeris = make_ephemeris(3, true);
+  serial_ephemeris->Prolong(t0_ + 2 * period);
+  parareal_ephemeris->Prolong(t0_ + 2 * period);
+  // A prolongation shorter than a window.
+  serial_ephemeris->Prolong(t0_ + 2.1 * period);
+  parareal_ephemeris->Prolong(t0_ + 2.1 * period);
+
+  for (std::size_t i = 0; i < serial_ephemeris->bodies().size(); ++i) {
+    for (Instant const& t : {t0_ + 0.3 * period,
+                             t0_ + 1.7 * period,
+                             t0_ + 2.1 * period}) {
+      auto const position = [i, &t](
+          std::unique_ptr<Ephemeris<EarthMoonOrbitPlane>> const& ephemeris) {
+        return ephemeris->trajectory(ephemeris->bodies()[i]).
+                   EvaluatePosition(t, nullptr);
+      };
+      EXPECT_THAT((position(parareal_ephemeris) -
+                   position(serial_ephemeris)).Norm(),
+                  Lt(1 * Metre)) << i << " " << t;
+    }
+  }
+}
+
+// The massless bodies don't interact, so integrating them in shards on
+// multiple threads must give exactly the same result as integrating them
+// together.
+TEST_F(EphemerisTest, ParallelFlowWithFixedStep) {
+  int const kProbes = 10;
+  std::vector<EarthMoonEphemeris> ephemerides;
+  for (int const number_of_threads : {1, 3}) {
+    EarthMoonEphemeris ephemeris = MakeEarthMoonEphemeris(number_of_threads);
+    ephemeris.ephemeris->FlowWithFixedStep(AddProbes(kProbes, &ephemeris),
+                                           ephemeris.period / 1000,
+                                           t0_ + ephemeris.period);
+    ephemerides.push_back(std::move(ephemeris));
+  }
+
+  ExpectSameProbes(ephemerides[0], ephemerides[1]);
+}
+
+// Flowing a batch of massless bodies with different tolerances and final
+// times, possibly concurrently, must give exactly the same result as flowing
+// them one at a time.
+TEST_F(EphemerisTest, BatchFlowWithAdaptiveStep) {
+  int const kProbes = 7;
+  std::vector<EarthMoonEphemeris> ephemerides;
+  for (int const number_of_threads : {1, 3}) {
+    EarthMoonEphemeris ephemeris = MakeEarthMoonEphemeris(number_of_threads);
+    Time const period = ephemeris.period;
+    std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> const probes =
+        AddProbes(kProbes, &ephemeris);
+    std::vector<Ephemeris<EarthMoonOrbitPlane>::AdaptiveStepFlow> flows;
+    for (int i = 0; i < kProbes; ++i) {
+      flows.push_back({probes[i],
+                       (i + 1) * Metre,
+                       (i + 1) * Metre / Second,
+                       t0_ + (i + 1) * period / kProbes});
+    }
+    if (number_of_threads == 1) {
+      for (auto const& flow : flows) {
+        ephemeris.ephemeris->FlowWithAdaptiveStep(
+            flow.trajectory,
+            flow.length_integration_tolerance,
+            flow.speed_integration_tolerance,
+            DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>(),
+            flow.t);
+      }
+    } else {
+      ephemeris.ephemeris->FlowWithAdaptiveStep(
+          flows,
+          DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>());
+    }
+    ephemerides.push_back(std::move(ephemeris));
+  }
+
+  ExpectSameProbes(ephemerides[0], ephemerides[1]);
+  for (int i = 0; i < kProbes; ++i) {
+    EXPECT_THAT(ephemerides[1].trajectories[i]->last().time(),
+                Eq(t0_ + (i + 1) * ephemerides[1].period / kProbes));
+  }
+}
+
+// The statistics of a flow account for all of its steps, with either
+// controller, and those of a batch of flows are kept separate.
+TEST_F(EphemerisTest, FlowWithAdaptiveStepStatistics) {
+  EarthMoonEphemeris ephemeris = MakeEarthMoonEphemeris(3);
+  std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> const probes =
+      AddProbes(3, &ephemeris);
+  Instant const t = t0_ + ephemeris.period;
+  auto const& integrator =
+      DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>();
+
+  AdaptiveStepSizeStatistics elementary_statistics;
+  ephemeris.ephemeris->FlowWithAdaptiveStep(probes[0],
+                                            1 * Milli(Metre),
+                                            1 * Milli(Metre) / Second,
+                                            integrator,
+                                            t,
+                                            nullptr /*pruning*/,
+                                            nullptr /*regularization*/,
+                                            kElementary,
+                                            &elementary_statistics);
+  EXPECT_THAT(elementary_statistics.accepted_steps,
+              Eq(probes[0]->Times().size() - 1));
+  EXPECT_THAT(elementary_statistics.rejected_evaluations,
+              Ge(3 * elementary_statistics.rejected_steps));
+  EXPECT_THAT(elementary_statistics.evaluations,
+              Ge(3 * (elementary_statistics.accepted_steps +
+                      elementary_statistics.rejected_steps)));
+
+  std::vector<AdaptiveStepSizeStatistics> statistics(2);
+  std::vector<Ephemeris<EarthMoonOrbitPlane>::AdaptiveStepFlow> flows;
+  for (int i = 1; i < 3; ++i) {
+    flows.push_back({probes[i],
+                     1 * Milli(Metre),
+                     1 * Milli(Metre) / Second,
+                     t,
+                     kProportionalIntegral,
+                     &statistics[i - 1]});
+  }
+  ephemeris.ephemeris->FlowWithAdaptiveStep(flows, integrator);
+  for (int i = 1; i < 3; ++i) {
+    EXPECT_THAT(statistics[i - 1].accepted_steps,
+                Eq(probes[i]->Times().size() - 1)) << i;
+  }
+}
+
+// An ensemble of massless bodies at very different distances from the Earth.
+// When each member is alone in its group, the ensemble must give exactly the
+// same result as flowing the members one at a time, since the vectorized
+// kernel is bitwise identical to the scalar computation.  When all the members
+// are in the same group, they move in lockstep with the steps of the closest
+// one, and the result doesn't depend on the number of threads.
+TEST_F(EphemerisTest, EnsembleFlowWithAdaptiveStep) {
+  int const kMembers = 6;
+  std::vector<EarthMoonEphemeris> ephemerides;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+  for (int e = 0; e < 4; ++e) {
+    EarthMoonEphemeris ephemeris =
+        MakeEarthMoonEphemeris(e == 3 ? 3 : 1 /*number_of_threads*/);
+    GravitationalParameter const μ_earth =
+        ephemeris.earth->gravitational_parameter();
+
+    // Roughly circular orbits around the Earth, whose dynamical timescales
+    // differ by a factor 3^(3/2) from one member to the next.
+    std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> members;
+    Length r = 1E7 * Metre;
+    for (int i = 0; i < kMembers; ++i, r *= 3) {
+      members.push_back(AddProbe(
+          ephemeris.initial_state.front() +
+              RelativeDegreesOfFreedom<EarthMoonOrbitPlane>(
+                  Vector<Length, EarthMoonOrbitPlane>(
+                      {r, 0 * Metre, 0 * Metre}),
+                  Velocity<EarthMoonOrbitPlane>(
+                      {0 * SIUnit<Speed>(),
+                       Sqrt(μ_earth / r),
+                       0 * SIUnit<Speed>()})),
+          &ephemeris));
+    }
+
+    auto const& integrator =
+        DormandElMikkawyPrince1986RKN434FM<Position<EarthMoonOrbitPlane>>();
+    Instant const t = t0_ + ephemeris.period / 40;
+    if (e == 0) {
+      for (auto const member : members) {
+        ephemeris.ephemeris->FlowWithAdaptiveStep(
+            member, length_tolerance, speed_tolerance, integrator, t);
+      }
+    } else {
+      Ephemeris<EarthMoonOrbitPlane>::EnsembleIntegration ensemble;
+      ensemble.regrouping_interval = ephemeris.period;
+      ensemble.grouping_ratio = e == 1 ? 1 : 1E6;
+      ephemeris.ephemeris->FlowEnsembleWithAdaptiveStep(members,
+                                                        length_tolerance,
+                                                        speed_tolerance,
+                                                        integrator,
+                                                        t,
+                                                        ensemble);
+    }
+    for (auto const member : members) {
+      EXPECT_THAT(member->last().time(), Eq(t));
+    }
+    ephemerides.push_back(std::move(ephemeris));
+  }
+
+  // Singleton groups.
+  ExpectSameProbes(ephemerides[0], ephemerides[1]);
+  // A single group.
+  ExpectSameProbes(ephemerides[2], ephemerides[3]);
+  auto const& individual = ephemerides[0].trajectories;
+  auto const& grouped = ephemerides[2].trajectories;
+  for (int i = 0; i < kMembers; ++i) {
+    EXPECT_THAT(grouped[i]->Times().size(), Eq(grouped[0]->Times().size()));
+    Position<EarthMoonOrbitPlane> const individual_position =
+        individual[i]->last().degrees_of_freedom().position();
+    Position<EarthMoonOrbitPlane> const ensemble_position =
+        grouped[i]->last().degrees_of_freedom().position();
+    EXPECT_THAT(
+        (ensemble_position - individual_position).Norm(),
+        Lt(1E-3 * (individual_position -
+                   ephemerides[0].centre_of_mass).Norm()));
+  }
+  // The farthest member needs far fewer steps than the closest one.
+  EXPECT_THAT(10 * individual[kMembers - 1]->Times().size(),
+              Lt(grouped[kMembers - 1]->Times().size()));
+}
+
+// Prolonging in the background, while massless bodies are flowed, must give
+// exactly the same result as prolonging synchronously.
+TEST_F(EphemerisTest, BackgroundProlongation) {
+  int const kProbes = 5;
+  std::vector<EarthMoonEphemeris> ephemerides;
+  for (bool const background : {false, true}) {
+    EarthMoonEphemeris ephemeris =
+        MakeEarthMoonEphemeris(1 /*number_of_threads*/);
+    Time const period = ephemeris.period;
+    if (background) {
+      ephemeris.ephemeris->StartBackgroundProlongation(period);
+    }
+    std::vector<not_null<Trajectory<EarthMoonOrbitPlane>*>> const probes =
+        AddProbes(kProbes, &ephemeris);
+    for (int j = 1; j <= 4; ++j) {
+      ephemeris.ephemeris->FlowWithFixedStep(probes,
+                                             period / 1000,
+                                             t0_ + j * period / 2);
+    }
+    ephemerides.push_back(std::move(ephemeris));
+  }
+
+  // The background thread keeps going until it is |period| ahead of the last
+  // request.
+  Time const period = ephemerides[0].period;
+  Ephemeris<EarthMoonOrbitPlane>& synchronous = *ephemerides[0].ephemeris;
+  Ephemeris<EarthMoonOrbitPlane>& background = *ephemerides[1].ephemeris;
+  while (background.t_max() < t0_ + 3 * period) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  background.StopBackgroundProlongation();
+  synchronous.Prolong(background.t_max());
+  EXPECT_THAT(background.t_max(), Eq(synchronous.t_max()));
+
+  for (Instant t = t0_; t <= background.t_max(); t += period / 7) {
+    EXPECT_THAT(
+        background.trajectory(ephemerides[1].moon).EvaluateDegreesOfFreedom(
+            t, nullptr),
+        Eq(synchronous.trajectory(ephemerides[0].moon).EvaluateDegreesOfFreedom(
+            t, nullptr)));
+  }
+  ExpectSameProbes(ephemerides[0], ephemerides[1]);
+}
+
+// An ephemeris read from a message must be prolonged exactly like the original
+// one.
+TEST_F(EphemerisTest, Serialization) {
+  not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
+      SolarSystem::AtСпутник1Launch(
+          SolarSystem::Accuracy::kAllBodiesAndOblateness);
+  Ephemeris<ICRFJ2000Ecliptic> ephemeris(
+      at_спутник_1_launch->massive_bodies(),
+      at_спутник_1_launch->initial_state(),
+      at_спутник_1_launch->time(),
+      McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>(),
+      45 * Minute,
+      0.1 * Milli(Metre),
+      5 * Milli(Metre));
+  Instant const t1 = at_спутник_1_launch->time() + 10 * Day;
+  Instant const t2 = at_спутник_1_launch->time() + 20 * Day;
+  ephemeris.Prolong(t1);
+
+  serialization::Ephemeris message;
+  ephemeris.WriteToMessage(&message);
+  EXPECT_EQ(ephemeris.bodies().size(), message.body_size());
+  EXPECT_EQ(ephemeris.bodies().size(), message.trajectory_size());
+  EXPECT_EQ(ephemeris.bodies().size(), message.last_state_size());
+
+  not_null<std::unique_ptr<Ephemeris<ICRFJ2000Ecliptic>>> const
+      deserialized_ephemeris =
+          Ephemeris<ICRFJ2000Ecliptic>::ReadFromMessage(
+              message,
+              McLachlanAtela1992Order5Optimal<Position<ICRFJ2000Ecliptic>>());
+  serialization::Ephemeris second_message;
+  deserialized_ephemeris->WriteToMessage(&second_message);
+  EXPECT_EQ(message.SerializeAsString(), second_message.SerializeAsString());
+  EXPECT_EQ(ephemeris.t_min(), deserialized_ephemeris->t_min());
+  EXPECT_EQ(ephemeris.t_max(), deserialized_ephemeris->t_max());
+
+  ephemeris.Prolong(t2);
+  deserialized_ephemeris->Prolong(t2);
+  for (std::size_t i = 0; i < ephemeris.bodies().size(); ++i) {
+    EXPECT_EQ(ephemeris.bodies()[i]->gravitational_parameter(),
+              deserialized_ephemeris->bodies()[i]->gravitational_parameter());
+    EXPECT_EQ(ephemeris.bodies()[i]->is_oblate(),
+              deserialized_ephemeris->bodies()[i]->is_oblate());
+    EXPECT_EQ(ephemeris.trajectory(ephemeris.bodies()[i]).
+                  EvaluateDegreesOfFreedom(t2, nullptr),
+              deserialized_ephemeris->trajectory(
+                  deserialized_ephemeris->bodies()[i]).
+                      EvaluateDegreesOfFreedom(t2, nullptr))
+        << SolarSystem::name(i);
+  }
+}
+
 TEST_F(EphemerisTest, Sputnik1ToSputnik2) {
   not_null<std::unique_ptr<SolarSystem>> const at_спутник_1_launch =
       SolarSystem::AtСпутник1Launch(
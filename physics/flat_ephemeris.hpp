@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/mapped_file.hpp"
+#include "base/not_null.hpp"
+#include "physics/continuous_trajectory.hpp"
+#include "physics/flat_ephemeris_format.hpp"
+
+namespace principia {
+
+using base::MappedFile;
+using base::not_null;
+
+namespace physics {
+
+// A read-only set of |ContinuousTrajectory|s stored in a flat binary file (see
+// flat_ephemeris_format.hpp for the layout).  The file is memory-mapped and the
+// trajectories are evaluated directly from the mapping, without copying the
+// coefficients of the series.  Therefore, the construction cost only depends
+// on the number of trajectories, not on their length, and processes that map
+// the same file share its pages.
+template<typename Frame>
+class FlatEphemeris {
+ public:
+  // Maps the file |filename|, which must have been written by |WriteToFile|.
+  // Only the header and the trajectory entries are validated; the rest of the
+  // file is trusted.
+  explicit FlatEphemeris(std::string const& filename);
+
+  FlatEphemeris(FlatEphemeris const&) = delete;
+  FlatEphemeris(FlatEphemeris&&) = delete;  // NOLINT(build/c++11)
+  FlatEphemeris& operator=(FlatEphemeris const&) = delete;
+  FlatEphemeris& operator=(FlatEphemeris&&) = delete;  // NOLINT(build/c++11)
+
+  int number_of_trajectories() const;
+
+  // Returns the trajectory that was at position |index| in the vector passed to
+  // |WriteToFile|.  It evaluates exactly like the original, has the same
+  // |t_min| and |t_max|, and cannot be appended to.  It must not be used after
+  // this object has been destroyed.
+  not_null<ContinuousTrajectory<Frame> const*> trajectory(
+      int const index) const;
+
+  // Writes the series of the given |trajectories| to the file |filename|.  The
+  // points that are not yet part of a series are not written.
+  static void WriteToFile(
+      std::string const& filename,
+      std::vector<not_null<ContinuousTrajectory<Frame> const*>> const&
+          trajectories);
+
+ private:
+  MappedFile const file_;
+  std::vector<not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
+      trajectories_;
+};
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/flat_ephemeris_body.hpp"
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "physics/flat_ephemeris.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+
+using base::make_not_null_unique;
+
+namespace physics {
+
+namespace {
+
+template<typename T>
+void WriteFlat(T const& t, not_null<std::ofstream*> const file) {
+  file->write(reinterpret_cast<char const*>(&t), sizeof(T));
+}
+
+}  // namespace
+
+template<typename Frame>
+FlatEphemeris<Frame>::FlatEphemeris(std::string const& filename)
+    : file_(filename) {
+  CHECK_LE(sizeof(internal::FlatEphemerisHeader), file_.size())
+      << filename << " is truncated";
+  auto const& header =
+      *reinterpret_cast<internal::FlatEphemerisHeader const*>(file_.data());
+  CHECK(std::equal(std::begin(header.magic),
+                   std::end(header.magic),
+                   std::begin(internal::kFlatEphemerisMagic)))
+      << filename << " is not a flat ephemeris file";
+  CHECK_EQ(internal::kFlatEphemerisVersion, header.version)
+      << filename << " has an unsupported version";
+  CHECK_LE(sizeof(internal::FlatEphemerisHeader) +
+               header.number_of_trajectories *
+                   sizeof(internal::FlatTrajectoryEntry),
+           file_.size())
+      << filename << " is truncated";
+
+  auto const* const entries =
+      reinterpret_cast<internal::FlatTrajectoryEntry const*>(
+          file_.data() + sizeof(internal::FlatEphemerisHeader));
+  for (std::uint32_t i = 0; i < header.number_of_trajectories; ++i) {
+    internal::FlatTrajectoryEntry const& entry = entries[i];
+    trajectories_.emplace_back(make_not_null_unique<ContinuousTrajectory<Frame>>(
+        entry.step * SIUnit<Time>(),
+        entry.low_tolerance * SIUnit<Length>(),
+        entry.high_tolerance * SIUnit<Length>()));
+    ContinuousTrajectory<Frame>& trajectory = *trajectories_.back();
+    if (entry.number_of_series > 0) {
+      CHECK_LE(entry.series_offset +
+                   entry.number_of_series * sizeof(internal::FlatSeriesEntry),
+               file_.size())
+          << filename << " is truncated";
+      trajectory.first_time_ =
+          std::make_unique<Instant>(Instant() + entry.first_time * SIUnit<Time>());
+      trajectory.mapped_file_ = file_.data();
+      trajectory.mapped_series_ =
+          reinterpret_cast<internal::FlatSeriesEntry const*>(
+              file_.data() + entry.series_offset);
+      trajectory.number_of_mapped_series_ =
+          static_cast<int>(entry.number_of_series);
+    }
+  }
+}
+
+template<typename Frame>
+int FlatEphemeris<Frame>::number_of_trajectories() const {
+  return static_cast<int>(trajectories_.size());
+}
+
+template<typename Frame>
+not_null<ContinuousTrajectory<Frame> const*> FlatEphemeris<Frame>::trajectory(
+    int const index) const {
+  return trajectories_[index].get();
+}
+
+template<typename Frame>
+void FlatEphemeris<Frame>::WriteToFile(
+    std::string const& filename,
+    std::vector<not_null<ContinuousTrajectory<Frame> const*>> const&
+        trajectories) {
+  // The mapped coefficients are used in place as |Displacement|s.
+  static_assert(sizeof(Displacement<Frame>) == 3 * sizeof(double),
+                "Unexpected layout for Displacement");
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  CHECK(file.good()) << "Cannot open " << filename;
+
+  internal::FlatEphemerisHeader header;
+  std::copy(std::begin(internal::kFlatEphemerisMagic),
+            std::end(internal::kFlatEphemerisMagic),
+            std::begin(header.magic));
+  header.version = internal::kFlatEphemerisVersion;
+  header.number_of_trajectories =
+      static_cast<std::uint32_t>(trajectories.size());
+  WriteFlat(header, &file);
+
+  // The trajectory entries, followed by all the series entries.
+  std::uint64_t series_offset =
+      sizeof(internal::FlatEphemerisHeader) +
+      trajectories.size() * sizeof(internal::FlatTrajectoryEntry);
+  std::uint64_t total_number_of_series = 0;
+  for (auto const trajectory : trajectories) {
+    CHECK(trajectory->mapped_series_ == nullptr)
+        << "Cannot write a mapped trajectory";
+    internal::FlatTrajectoryEntry entry;
+    entry.step = trajectory->step_ / SIUnit<Time>();
+    entry.low_tolerance = trajectory->low_tolerance_ / SIUnit<Length>();
+    entry.high_tolerance = trajectory->high_tolerance_ / SIUnit<Length>();
+    entry.first_time = trajectory->empty()
+                           ? 0.0
+                           : (trajectory->t_min() - Instant()) / SIUnit<Time>();
+    entry.series_offset = series_offset;
+    entry.number_of_series = trajectory->series_.size();
+    WriteFlat(entry, &file);
+    series_offset +=
+        entry.number_of_series * sizeof(internal::FlatSeriesEntry);
+    total_number_of_series += entry.number_of_series;
+  }
+
+  // The series entries, followed by all the coefficients.
+  std::uint64_t coefficients_offset = series_offset;
+  for (auto const trajectory : trajectories) {
+    for (auto const& series : trajectory->series_) {
+      Time const duration = series.t_max() - series.t_min();
+      internal::FlatSeriesEntry entry;
+      entry.t_min = (series.t_min() - Instant()) / SIUnit<Time>();
+      entry.t_max = (series.t_max() - Instant()) / SIUnit<Time>();
+      // Same computations as in the constructor of |ЧебышёвSeries|.
+      entry.t_mean =
+          (series.t_min() + 0.5 * duration - Instant()) / SIUnit<Time>();
+      entry.two_over_duration = (2 / duration) * SIUnit<Time>();
+      entry.coefficients_offset = coefficients_offset;
+      entry.degree =
+          static_cast<std::int32_t>(series.coefficients().size()) - 1;
+      entry.unused = 0;
+      WriteFlat(entry, &file);
+      coefficients_offset +=
+          (entry.degree + 1) * sizeof(Displacement<Frame>);
+    }
+  }
+
+  for (auto const trajectory : trajectories) {
+    for (auto const& series : trajectory->series_) {
+      for (auto const& coefficient : series.coefficients()) {
+        WriteFlat(coefficient.coordinates().x / SIUnit<Length>(), &file);
+        WriteFlat(coefficient.coordinates().y / SIUnit<Length>(), &file);
+        WriteFlat(coefficient.coordinates().z / SIUnit<Length>(), &file);
+      }
+    }
+  }
+  CHECK(file.good()) << "Cannot write " << filename;
+}
+
+}  // namespace physics
+}  // namespace principia
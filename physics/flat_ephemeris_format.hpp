@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "base/macros.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal {
+
+// The layout of the files written by |FlatEphemeris::WriteToFile|.  The file is
+// made of:
+// - a |FlatEphemerisHeader|;
+// - |number_of_trajectories| |FlatTrajectoryEntry|s;
+// - for each trajectory, |number_of_series| consecutive |FlatSeriesEntry|s in
+//   increasing time order;
+// - for each series, |degree + 1| coefficients, starting with the one of T₀,
+//   each made of the 3 coordinates of a |Displacement|.
+// All the numbers are little-endian and all the items are 8-byte aligned, so
+// that a mapped file may be used in place.  Times are in seconds from
+// |Instant()|, lengths in metres and offsets in bytes from the beginning of the
+// file.
+
+#if !ARCH_CPU_LITTLE_ENDIAN
+#error "Flat ephemeris files are little-endian"
+#endif
+
+char const kFlatEphemerisMagic[8] = {'P', 'r', 'i', 'n', 'E', 'p', 'h', 'm'};
+
+// Must be incremented whenever the layout changes.
+std::uint32_t const kFlatEphemerisVersion = 1;
+
+struct FlatEphemerisHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t number_of_trajectories;
+};
+
+struct FlatTrajectoryEntry {
+  // The construction parameters of the |ContinuousTrajectory|.
+  double step;
+  double low_tolerance;
+  double high_tolerance;
+  double first_time;
+  std::uint64_t series_offset;
+  std::uint64_t number_of_series;
+};
+
+struct FlatSeriesEntry {
+  double t_min;
+  double t_max;
+  // Computed as in the |ЧебышёвSeries| constructor, so that evaluation doesn't
+  // need to recompute them and gives bitwise identical results.
+  double t_mean;
+  double two_over_duration;
+  std::uint64_t coefficients_offset;
+  std::int32_t degree;
+  std::int32_t unused;
+};
+
+static_assert(sizeof(FlatEphemerisHeader) == 16,
+              "Unexpected padding in FlatEphemerisHeader");
+static_assert(sizeof(FlatTrajectoryEntry) == 48,
+              "Unexpected padding in FlatTrajectoryEntry");
+static_assert(sizeof(FlatSeriesEntry) == 48,
+              "Unexpected padding in FlatSeriesEntry");
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,135 @@
+#include "physics/flat_ephemeris.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+
+namespace principia {
+
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::Velocity;
+using quantities::Angle;
+using quantities::AngularFrequency;
+using quantities::Cos;
+using quantities::Sin;
+using quantities::Time;
+using si::Kilo;
+using si::Metre;
+using si::Milli;
+using si::Radian;
+using si::Second;
+using ::testing::Eq;
+
+namespace physics {
+
+class FlatEphemerisTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST1, true>;
+
+  FlatEphemerisTest() : filename_("flat_ephemeris_test.bin") {}
+
+  ~FlatEphemerisTest() override {
+    std::remove(filename_.c_str());
+  }
+
+  // A trajectory on a circular orbit of the given |radius| and |period|,
+  // sampled |number_of_steps| times.
+  not_null<std::unique_ptr<ContinuousTrajectory<World>>> CircularTrajectory(
+      Length const& radius,
+      Time const& period,
+      int const number_of_steps) {
+    AngularFrequency const ω = 2 * π * Radian / period;
+    auto trajectory = make_not_null_unique<ContinuousTrajectory<World>>(
+                          kStep,
+                          1 * Milli(Metre) /*low_tolerance*/,
+                          5 * Milli(Metre) /*high_tolerance*/);
+    Instant time;
+    for (int i = 0; i < number_of_steps; ++i) {
+      time += kStep;
+      Angle const angle = ω * (time - Instant());
+      trajectory->Append(
+          time,
+          DegreesOfFreedom<World>(
+              World::origin + Displacement<World>({radius * Cos(angle),
+                                                   radius * Sin(angle),
+                                                   0 * Metre}),
+              Velocity<World>({-ω * radius * Sin(angle) / Radian,
+                               ω * radius * Cos(angle) / Radian,
+                               0 * Metre / Second})));
+    }
+    return trajectory;
+  }
+
+  Time const kStep = 3600 * Second;
+  std::string const filename_;
+};
+
+TEST_F(FlatEphemerisTest, Evaluation) {
+  auto const trajectory1 =
+      CircularTrajectory(421700 * Kilo(Metre), 40 * kStep, 100);
+  auto const trajectory2 =
+      CircularTrajectory(1070400 * Kilo(Metre), 170 * kStep, 203);
+  trajectory2->ForgetBefore(Instant() + 30.5 * kStep);
+  auto const empty_trajectory =
+      CircularTrajectory(1882700 * Kilo(Metre), 400 * kStep, 5);
+  ASSERT_TRUE(empty_trajectory->empty());
+
+  FlatEphemeris<World>::WriteToFile(
+      filename_,
+      {trajectory1.get(), trajectory2.get(), empty_trajectory.get()});
+  FlatEphemeris<World> const flat_ephemeris(filename_);
+  ASSERT_THAT(flat_ephemeris.number_of_trajectories(), Eq(3));
+  EXPECT_TRUE(flat_ephemeris.trajectory(2)->empty());
+
+  std::vector<ContinuousTrajectory<World> const*> const originals =
+      {trajectory1.get(), trajectory2.get()};
+  for (int i = 0; i < originals.size(); ++i) {
+    ContinuousTrajectory<World> const& original = *originals[i];
+    ContinuousTrajectory<World> const& mapped = *flat_ephemeris.trajectory(i);
+    ASSERT_FALSE(mapped.empty());
+    EXPECT_THAT(mapped.t_min(), Eq(original.t_min()));
+    EXPECT_THAT(mapped.t_max(), Eq(original.t_max()));
+    ContinuousTrajectory<World>::Hint original_hint;
+    ContinuousTrajectory<World>::Hint mapped_hint;
+    for (Instant time = original.t_min();
+         time <= original.t_max();
+         time += kStep / 7) {
+      EXPECT_THAT(mapped.EvaluatePosition(time, &mapped_hint),
+                  Eq(original.EvaluatePosition(time, &original_hint)));
+      EXPECT_THAT(mapped.EvaluateVelocity(time, nullptr),
+                  Eq(original.EvaluateVelocity(time, nullptr)));
+      EXPECT_THAT(mapped.EvaluateDegreesOfFreedom(time, &mapped_hint),
+                  Eq(original.EvaluateDegreesOfFreedom(time, &original_hint)));
+    }
+  }
+}
+
+using FlatEphemerisDeathTest = FlatEphemerisTest;
+
+TEST_F(FlatEphemerisDeathTest, Error) {
+  EXPECT_DEATH({
+    {
+      std::ofstream file(filename_, std::ios::binary);
+      file << "This is not an ephemeris";
+    }
+    FlatEphemeris<World> const flat_ephemeris(filename_);
+  }, "not a flat ephemeris");
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "numerics/universal_kepler_equation.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+
+using base::not_null;
+using geometry::Instant;
+using numerics::UniversalKeplerEquation;
+using quantities::GravitationalParameter;
+using quantities::Time;
+
+namespace physics {
+
+// The motion of a massless body around a point mass, computed in closed form
+// using the universal variable formulation of Kepler's equation, see
+// |UniversalKeplerEquation|.
+template<typename Frame>
+class KeplerOrbit {
+ public:
+  // The orbit of a massless body whose state relative to a point mass with
+  // the given |gravitational_parameter| is |initial_state| at |epoch|.
+  KeplerOrbit(GravitationalParameter const& gravitational_parameter,
+              RelativeDegreesOfFreedom<Frame> const& initial_state,
+              Instant const& epoch);
+
+  // The state of the massless body relative to the point mass at time |t|,
+  // which may be before the |epoch()|.
+  RelativeDegreesOfFreedom<Frame> EvaluateRelativeDegreesOfFreedom(
+      Instant const& t) const;
+
+  // The Sundman time s of the orbit is defined by ds / dt = r₀ / r and s = 0 at
+  // the |epoch()|, where r is the distance to the point mass and r₀ its value
+  // at the |epoch()|.  It is proportional to the universal anomaly, so
+  // evaluating the orbit at a given Sundman time doesn't require solving
+  // Kepler's equation.  Returns the state at Sundman time |s| and sets |*t| to
+  // the corresponding time.
+  RelativeDegreesOfFreedom<Frame> EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+      Time const& s,
+      not_null<Instant*> const t) const;
+
+  // Returns the Sundman time at time |t|.
+  Time SundmanTime(Instant const& t) const;
+
+  GravitationalParameter const& gravitational_parameter() const;
+  RelativeDegreesOfFreedom<Frame> const& initial_state() const;
+  Instant const& epoch() const;
+
+ private:
+  // The state at the universal anomaly |χ|, which is reached |Δt| after the
+  // |epoch_|, both in SI units.
+  RelativeDegreesOfFreedom<Frame> EvaluateAtUniversalAnomaly(
+      double const χ,
+      double const Δt) const;
+
+  GravitationalParameter const gravitational_parameter_;
+  RelativeDegreesOfFreedom<Frame> const initial_state_;
+  Instant const epoch_;
+  UniversalKeplerEquation const kepler_equation_;
+};
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/kepler_orbit_body.hpp"
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "physics/kepler_orbit.hpp"
+
+#include "base/not_null.hpp"
+#include "geometry/grassmann.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+
+using base::not_null;
+using geometry::InnerProduct;
+using numerics::LagrangeCoefficients;
+using quantities::Length;
+using quantities::SIUnit;
+using quantities::Speed;
+using quantities::Time;
+
+namespace physics {
+
+template<typename Frame>
+KeplerOrbit<Frame>::KeplerOrbit(
+    GravitationalParameter const& gravitational_parameter,
+    RelativeDegreesOfFreedom<Frame> const& initial_state,
+    Instant const& epoch)
+    : gravitational_parameter_(gravitational_parameter),
+      initial_state_(initial_state),
+      epoch_(epoch),
+      kepler_equation_(
+          gravitational_parameter / SIUnit<GravitationalParameter>(),
+          initial_state.displacement().Norm() / SIUnit<Length>(),
+          InnerProduct(initial_state.displacement(),
+                       initial_state.velocity()) /
+              (SIUnit<Length>() * SIUnit<Speed>()),
+          InnerProduct(initial_state.velocity(), initial_state.velocity()) /
+              (SIUnit<Speed>() * SIUnit<Speed>())) {}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame>
+KeplerOrbit<Frame>::EvaluateRelativeDegreesOfFreedom(Instant const& t) const {
+  double const Δt = (t - epoch_) / SIUnit<Time>();
+  if (Δt == 0) {
+    return initial_state_;
+  }
+  return EvaluateAtUniversalAnomaly(kepler_equation_.UniversalAnomaly(Δt), Δt);
+}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame>
+KeplerOrbit<Frame>::EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+    Time const& s,
+    not_null<Instant*> const t) const {
+  // dχ / dt = √μ / r, so χ = √μ s / r₀, and Δt is given by the universal
+  // Kepler equation.
+  double const χ =
+      kepler_equation_.sqrt_μ() * (s / SIUnit<Time>()) / kepler_equation_.r0();
+  double const Δt = kepler_equation_.ElapsedTime(χ);
+  *t = epoch_ + Δt * SIUnit<Time>();
+  return EvaluateAtUniversalAnomaly(χ, Δt);
+}
+
+template<typename Frame>
+Time KeplerOrbit<Frame>::SundmanTime(Instant const& t) const {
+  double const Δt = (t - epoch_) / SIUnit<Time>();
+  if (Δt == 0) {
+    return Time();
+  }
+  return kepler_equation_.r0() * kepler_equation_.UniversalAnomaly(Δt) /
+         kepler_equation_.sqrt_μ() * SIUnit<Time>();
+}
+
+template<typename Frame>
+GravitationalParameter const&
+KeplerOrbit<Frame>::gravitational_parameter() const {
+  return gravitational_parameter_;
+}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame> const&
+KeplerOrbit<Frame>::initial_state() const {
+  return initial_state_;
+}
+
+template<typename Frame>
+Instant const& KeplerOrbit<Frame>::epoch() const {
+  return epoch_;
+}
+
+template<typename Frame>
+RelativeDegreesOfFreedom<Frame> KeplerOrbit<Frame>::EvaluateAtUniversalAnomaly(
+    double const χ,
+    double const Δt) const {
+  LagrangeCoefficients const coefficients =
+      kepler_equation_.Coefficients(χ, Δt);
+  Time const g = coefficients.g * SIUnit<Time>();
+  Time::Inverse const ḟ = coefficients.ḟ / SIUnit<Time>();
+  Displacement<Frame> const& r0 = initial_state_.displacement();
+  Velocity<Frame> const& v0 = initial_state_.velocity();
+  return RelativeDegreesOfFreedom<Frame>(coefficients.f * r0 + g * v0,
+                                         ḟ * r0 + coefficients.ġ * v0);
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,192 @@
+#include "physics/kepler_orbit.hpp"
+
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/astronomy.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+
+using geometry::Frame;
+using geometry::InnerProduct;
+using geometry::Wedge;
+using quantities::Pow;
+using quantities::Sqrt;
+using quantities::Time;
+using si::Day;
+using si::Kilo;
+using si::Metre;
+using si::Second;
+using testing_utilities::RelativeError;
+using ::testing::Gt;
+using ::testing::Lt;
+
+namespace physics {
+
+class KeplerOrbitTest : public testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      serialization::Frame::TEST, true>;
+
+  KeplerOrbitTest()
+      : μ_(3.986004418E14 * Pow<3>(Metre) / Pow<2>(Second)),
+        r0_({7000 * Kilo(Metre), 0 * Metre, 0 * Metre}) {}
+
+  // Checks that the energy and the angular momentum of |orbit| are conserved
+  // at a few times before and after the epoch, including several revolutions
+  // away for elliptic orbits.
+  void ExpectConservation(KeplerOrbit<World> const& orbit,
+                          Time const& time_scale) {
+    auto const energy = [this](RelativeDegreesOfFreedom<World> const& state) {
+      return InnerProduct(state.velocity(), state.velocity()) / 2 -
+             μ_ / state.displacement().Norm();
+    };
+    auto const angular_momentum =
+        [](RelativeDegreesOfFreedom<World> const& state) {
+          return Wedge(state.displacement(), state.velocity());
+        };
+    for (double const fraction : {-7.3, -1.0, -0.01, 1E-9, 0.3, 2.5, 11.1}) {
+      RelativeDegreesOfFreedom<World> const state =
+          orbit.EvaluateRelativeDegreesOfFreedom(orbit.epoch() +
+                                                 fraction * time_scale);
+      EXPECT_THAT(RelativeError(energy(orbit.initial_state()), energy(state)),
+                  Lt(1E-12)) << fraction;
+      EXPECT_THAT(RelativeError(angular_momentum(orbit.initial_state()),
+                                angular_momentum(state)),
+                  Lt(1E-12)) << fraction;
+    }
+  }
+
+  GravitationalParameter const μ_;
+  Displacement<World> const r0_;
+  Instant const epoch_;
+};
+
+// A circular orbit is periodic, and after a quarter of a period the body is a
+// quarter of the way around.
+TEST_F(KeplerOrbitTest, Circular) {
+  Speed const v = Sqrt(μ_ / r0_.Norm());
+  Time const period = 2 * π * r0_.Norm() / v;
+  KeplerOrbit<World> const orbit(
+      μ_,
+      RelativeDegreesOfFreedom<World>(
+          r0_, Velocity<World>({0 * Metre / Second, v, 0 * Metre / Second})),
+      epoch_);
+
+  RelativeDegreesOfFreedom<World> const after_one_period =
+      orbit.EvaluateRelativeDegreesOfFreedom(epoch_ + period);
+  EXPECT_THAT(RelativeError(r0_, after_one_period.displacement()),
+              Lt(1E-13));
+  EXPECT_THAT(RelativeError(orbit.initial_state().velocity(),
+                            after_one_period.velocity()),
+              Lt(1E-13));
+
+  RelativeDegreesOfFreedom<World> const after_a_quarter =
+      orbit.EvaluateRelativeDegreesOfFreedom(epoch_ + period / 4);
+  EXPECT_THAT(
+      RelativeError(Displacement<World>({0 * Metre, r0_.Norm(), 0 * Metre}),
+                    after_a_quarter.displacement()),
+      Lt(1E-13));
+  ExpectConservation(orbit, period);
+}
+
+TEST_F(KeplerOrbitTest, Elliptic) {
+  Speed const v = 1.3 * Sqrt(μ_ / r0_.Norm());
+  KeplerOrbit<World> const orbit(
+      μ_,
+      RelativeDegreesOfFreedom<World>(
+          r0_, Velocity<World>({0.2 * v, v, 0.1 * v})),
+      epoch_);
+  ExpectConservation(orbit, 1 * Day);
+}
+
+TEST_F(KeplerOrbitTest, Hyperbolic) {
+  Speed const v = 2 * Sqrt(μ_ / r0_.Norm());
+  KeplerOrbit<World> const orbit(
+      μ_,
+      RelativeDegreesOfFreedom<World>(
+          r0_, Velocity<World>({-0.3 * v, v, 0 * Metre / Second})),
+      epoch_);
+  ExpectConservation(orbit, 1 * Day);
+}
+
+// Propagating in two legs gives the same result as propagating directly.
+TEST_F(KeplerOrbitTest, Composition) {
+  Speed const v = 1.1 * Sqrt(μ_ / r0_.Norm());
+  KeplerOrbit<World> const orbit(
+      μ_,
+      RelativeDegreesOfFreedom<World>(
+          r0_, Velocity<World>({0.1 * v, v, 0.2 * v})),
+      epoch_);
+  Instant const t1 = epoch_ + 0.37 * Day;
+  Instant const t2 = epoch_ + 1.61 * Day;
+  KeplerOrbit<World> const second_leg(
+      μ_, orbit.EvaluateRelativeDegreesOfFreedom(t1), t1);
+  RelativeDegreesOfFreedom<World> const direct =
+      orbit.EvaluateRelativeDegreesOfFreedom(t2);
+  RelativeDegreesOfFreedom<World> const composed =
+      second_leg.EvaluateRelativeDegreesOfFreedom(t2);
+  EXPECT_THAT(RelativeError(direct.displacement(), composed.displacement()),
+              Lt(1E-11));
+  EXPECT_THAT(RelativeError(direct.velocity(), composed.velocity()),
+              Lt(1E-11));
+}
+
+// The evaluation at a Sundman time is consistent with the evaluation at the
+// corresponding time, and the Sundman time runs slower near the periapsis.
+TEST_F(KeplerOrbitTest, SundmanTime) {
+  for (double const speed_factor : {1.3, 2.0}) {
+    Speed const v = speed_factor * Sqrt(μ_ / r0_.Norm());
+    KeplerOrbit<World> const orbit(
+        μ_,
+        RelativeDegreesOfFreedom<World>(
+            r0_, Velocity<World>({0.1 * v, v, 0 * Metre / Second})),
+        epoch_);
+    Time const s = 1000 * Second;
+    Instant t;
+    RelativeDegreesOfFreedom<World> const at_sundman_time =
+        orbit.EvaluateRelativeDegreesOfFreedomAtSundmanTime(s, &t);
+    RelativeDegreesOfFreedom<World> const at_time =
+        orbit.EvaluateRelativeDegreesOfFreedom(t);
+    EXPECT_THAT(RelativeError(at_time.displacement(),
+                              at_sundman_time.displacement()),
+                Lt(1E-13)) << speed_factor;
+    EXPECT_THAT(RelativeError(at_time.velocity(), at_sundman_time.velocity()),
+                Lt(1E-13)) << speed_factor;
+    EXPECT_THAT(RelativeError(s, orbit.SundmanTime(t)), Lt(1E-13))
+        << speed_factor;
+    // The body moves away from the periapsis, so time runs faster than Sundman
+    // time.
+    EXPECT_THAT(t - epoch_, Gt(s)) << speed_factor;
+  }
+}
+
+// For a barely hyperbolic orbit, the first corrections of the iteration for
+// the universal anomaly don't decrease monotonically.  The iteration must not
+// stop there: evaluating at the Sundman time of |t| must give back |t|.
+TEST_F(KeplerOrbitTest, NearParabolicSundmanTime) {
+  Speed const v = 1.42 * Sqrt(μ_ / r0_.Norm());
+  KeplerOrbit<World> const orbit(
+      μ_,
+      RelativeDegreesOfFreedom<World>(
+          r0_, Velocity<World>({0 * Metre / Second, v, 0.1 * v})),
+      epoch_);
+  for (double const seconds : {-3E9, -1E5, -1.0, 5E2, 4E4, 1E6, 3E9}) {
+    Time const Δt = seconds * Second;
+    Instant t;
+    orbit.EvaluateRelativeDegreesOfFreedomAtSundmanTime(
+        orbit.SundmanTime(epoch_ + Δt), &t);
+    EXPECT_THAT(RelativeError(Δt, t - epoch_), Lt(1E-13)) << Δt;
+  }
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "base/macros.hpp"
+#include "base/not_null.hpp"
+
+namespace principia {
+
+using base::not_null;
+
+namespace physics {
+namespace internal {
+
+// The coordinates of a set of vectors, in SI units, stored as a structure of
+// arrays so that the loops over pairs of bodies may be vectorized.  This is
+// only meant to be used in the innermost loops of the gravitational
+// computations; the rest of the code uses |Vector|s and |Position|s.
+struct R3ElementsSoA {
+  explicit R3ElementsSoA(std::size_t const size = 0);
+
+  void resize(std::size_t const size);
+
+  // Sets the elements with indices in [begin, end[ to zero.
+  void Clear(std::size_t const begin, std::size_t const end);
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+};
+
+// Adds to |*accelerations| the Newtonian accelerations between the body |b1|
+// and the bodies with indices in [b2_begin, b2_end[, which must all be greater
+// than |b1|.  The |positions| are in metres, the |gravitational_parameters| in
+// m³/s², and the |accelerations| in m/s².  Uses AVX or SSE2 instructions if
+// the compiler is allowed to emit them, and a scalar loop otherwise.
+void AddGravitationalAccelerationsBetweenPointMasses(
+    std::size_t const b1,
+    std::size_t const b2_begin,
+    std::size_t const b2_end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations);
+
+// Same as above, but never uses vector instructions.  The accelerations on the
+// bodies |b2| are bitwise identical to those computed by the vectorized
+// version; the acceleration on |b1| may differ in the last bits because the
+// vectorized version sums the contributions in a different order.
+void AddGravitationalAccelerationsBetweenPointMassesScalar(
+    std::size_t const b1,
+    std::size_t const b2_begin,
+    std::size_t const b2_end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations);
+
+// Adds to |*accelerations| the Newtonian accelerations exerted by a point mass
+// of gravitational parameter |μ1| located at (|x1|, |y1|, |z1|) on the test
+// particles with indices in [begin, end[, e.g., the massless bodies of an
+// ensemble.  The units and the instructions are as above.
+void AddGravitationalAccelerationsOnTestParticles(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const begin,
+    std::size_t const end,
+    R3ElementsSoA const& positions,
+    not_null<R3ElementsSoA*> const accelerations);
+
+// Same as above, but never uses vector instructions.  The results are bitwise
+// identical to those of the vectorized version, and to those of the
+// computation on |Vector|s done by |Ephemeris| for the massless bodies.
+void AddGravitationalAccelerationsOnTestParticlesScalar(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const begin,
+    std::size_t const end,
+    R3ElementsSoA const& positions,
+    not_null<R3ElementsSoA*> const accelerations);
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/pairwise_gravity_body.hpp"
@@ -0,0 +1,386 @@
+#pragma once
+
+#include "physics/pairwise_gravity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if ARCH_CPU_HAS_AVX
+#include <immintrin.h>
+#elif ARCH_CPU_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace physics {
+namespace internal {
+
+namespace {
+
+// The loop body of the scalar kernel, also used for the iterations that don't
+// fill a vector register in the vectorized kernels.  The reaction on |b1| is
+// accumulated in |*a1x|, |*a1y|, |*a1z|.  The operations are performed in the
+// same order as in the vectorized kernels, so that the accelerations on the
+// |b2|s are bitwise identical.
+FORCE_INLINE void AddGravitationalAccelerationsBetweenTwoPointMasses(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const b2,
+    double const* const x,
+    double const* const y,
+    double const* const z,
+    double const* const μ,
+    double* const ax,
+    double* const ay,
+    double* const az,
+    double* const a1x,
+    double* const a1y,
+    double* const a1z) {
+  double const Δqx = x1 - x[b2];
+  double const Δqy = y1 - y[b2];
+  double const Δqz = z1 - z[b2];
+  double const Δq_squared = Δqx * Δqx + Δqy * Δqy + Δqz * Δqz;
+  double const one_over_Δq_cubed =
+      std::sqrt(Δq_squared) / (Δq_squared * Δq_squared);
+
+  double const μ1_over_Δq_cubed = μ1 * one_over_Δq_cubed;
+  ax[b2] += Δqx * μ1_over_Δq_cubed;
+  ay[b2] += Δqy * μ1_over_Δq_cubed;
+  az[b2] += Δqz * μ1_over_Δq_cubed;
+
+  double const μ2_over_Δq_cubed = μ[b2] * one_over_Δq_cubed;
+  *a1x -= Δqx * μ2_over_Δq_cubed;
+  *a1y -= Δqy * μ2_over_Δq_cubed;
+  *a1z -= Δqz * μ2_over_Δq_cubed;
+}
+
+// The loop body of the scalar kernel for the test particles.  The operations
+// are performed in the same order as in the vectorized kernels.
+FORCE_INLINE void AddGravitationalAccelerationOnTestParticle(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const b2,
+    double const* const x,
+    double const* const y,
+    double const* const z,
+    double* const ax,
+    double* const ay,
+    double* const az) {
+  double const Δqx = x1 - x[b2];
+  double const Δqy = y1 - y[b2];
+  double const Δqz = z1 - z[b2];
+  double const Δq_squared = Δqx * Δqx + Δqy * Δqy + Δqz * Δqz;
+  double const one_over_Δq_cubed =
+      std::sqrt(Δq_squared) / (Δq_squared * Δq_squared);
+
+  double const μ1_over_Δq_cubed = μ1 * one_over_Δq_cubed;
+  ax[b2] += Δqx * μ1_over_Δq_cubed;
+  ay[b2] += Δqy * μ1_over_Δq_cubed;
+  az[b2] += Δqz * μ1_over_Δq_cubed;
+}
+
+}  // namespace
+
+inline R3ElementsSoA::R3ElementsSoA(std::size_t const size)
+    : x(size),
+      y(size),
+      z(size) {}
+
+inline void R3ElementsSoA::resize(std::size_t const size) {
+  x.resize(size);
+  y.resize(size);
+  z.resize(size);
+}
+
+inline void R3ElementsSoA::Clear(std::size_t const begin,
+                                 std::size_t const end) {
+  std::fill(x.begin() + begin, x.begin() + end, 0.0);
+  std::fill(y.begin() + begin, y.begin() + end, 0.0);
+  std::fill(z.begin() + begin, z.begin() + end, 0.0);
+}
+
+inline void AddGravitationalAccelerationsBetweenPointMasses(
+    std::size_t const b1,
+    std::size_t const b2_begin,
+    std::size_t const b2_end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations) {
+#if ARCH_CPU_HAS_AVX || ARCH_CPU_HAS_SSE2
+  CHECK_LT(b1, b2_begin);
+  double const* const x = positions.x.data();
+  double const* const y = positions.y.data();
+  double const* const z = positions.z.data();
+  double const* const μ = gravitational_parameters.data();
+  double* const ax = accelerations->x.data();
+  double* const ay = accelerations->y.data();
+  double* const az = accelerations->z.data();
+
+  std::size_t b2 = b2_begin;
+
+  // The reaction on |b1| is accumulated separately in each lane, and the lanes
+  // are summed at the end.
+#if ARCH_CPU_HAS_AVX
+  // 4 pairs per iteration.
+  int const kLanes = 4;
+  __m256d const x1 = _mm256_set1_pd(x[b1]);
+  __m256d const y1 = _mm256_set1_pd(y[b1]);
+  __m256d const z1 = _mm256_set1_pd(z[b1]);
+  __m256d const μ1 = _mm256_set1_pd(μ[b1]);
+  __m256d a1x = _mm256_setzero_pd();
+  __m256d a1y = _mm256_setzero_pd();
+  __m256d a1z = _mm256_setzero_pd();
+  for (; b2 + kLanes <= b2_end; b2 += kLanes) {
+    __m256d const Δqx = _mm256_sub_pd(x1, _mm256_loadu_pd(&x[b2]));
+    __m256d const Δqy = _mm256_sub_pd(y1, _mm256_loadu_pd(&y[b2]));
+    __m256d const Δqz = _mm256_sub_pd(z1, _mm256_loadu_pd(&z[b2]));
+    __m256d const Δq_squared =
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(Δqx, Δqx),
+                                    _mm256_mul_pd(Δqy, Δqy)),
+                      _mm256_mul_pd(Δqz, Δqz));
+    __m256d const one_over_Δq_cubed =
+        _mm256_div_pd(_mm256_sqrt_pd(Δq_squared),
+                      _mm256_mul_pd(Δq_squared, Δq_squared));
+
+    __m256d const μ1_over_Δq_cubed = _mm256_mul_pd(μ1, one_over_Δq_cubed);
+    _mm256_storeu_pd(&ax[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&ax[b2]),
+                                   _mm256_mul_pd(Δqx, μ1_over_Δq_cubed)));
+    _mm256_storeu_pd(&ay[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&ay[b2]),
+                                   _mm256_mul_pd(Δqy, μ1_over_Δq_cubed)));
+    _mm256_storeu_pd(&az[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&az[b2]),
+                                   _mm256_mul_pd(Δqz, μ1_over_Δq_cubed)));
+
+    __m256d const μ2_over_Δq_cubed =
+        _mm256_mul_pd(_mm256_loadu_pd(&μ[b2]), one_over_Δq_cubed);
+    a1x = _mm256_sub_pd(a1x, _mm256_mul_pd(Δqx, μ2_over_Δq_cubed));
+    a1y = _mm256_sub_pd(a1y, _mm256_mul_pd(Δqy, μ2_over_Δq_cubed));
+    a1z = _mm256_sub_pd(a1z, _mm256_mul_pd(Δqz, μ2_over_Δq_cubed));
+  }
+  double a1x_lanes[kLanes];
+  double a1y_lanes[kLanes];
+  double a1z_lanes[kLanes];
+  _mm256_storeu_pd(a1x_lanes, a1x);
+  _mm256_storeu_pd(a1y_lanes, a1y);
+  _mm256_storeu_pd(a1z_lanes, a1z);
+#else
+  // 2 pairs per iteration.
+  int const kLanes = 2;
+  __m128d const x1 = _mm_set1_pd(x[b1]);
+  __m128d const y1 = _mm_set1_pd(y[b1]);
+  __m128d const z1 = _mm_set1_pd(z[b1]);
+  __m128d const μ1 = _mm_set1_pd(μ[b1]);
+  __m128d a1x = _mm_setzero_pd();
+  __m128d a1y = _mm_setzero_pd();
+  __m128d a1z = _mm_setzero_pd();
+  for (; b2 + kLanes <= b2_end; b2 += kLanes) {
+    __m128d const Δqx = _mm_sub_pd(x1, _mm_loadu_pd(&x[b2]));
+    __m128d const Δqy = _mm_sub_pd(y1, _mm_loadu_pd(&y[b2]));
+    __m128d const Δqz = _mm_sub_pd(z1, _mm_loadu_pd(&z[b2]));
+    __m128d const Δq_squared =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(Δqx, Δqx), _mm_mul_pd(Δqy, Δqy)),
+                   _mm_mul_pd(Δqz, Δqz));
+    __m128d const one_over_Δq_cubed =
+        _mm_div_pd(_mm_sqrt_pd(Δq_squared),
+                   _mm_mul_pd(Δq_squared, Δq_squared));
+
+    __m128d const μ1_over_Δq_cubed = _mm_mul_pd(μ1, one_over_Δq_cubed);
+    _mm_storeu_pd(&ax[b2], _mm_add_pd(_mm_loadu_pd(&ax[b2]),
+                                      _mm_mul_pd(Δqx, μ1_over_Δq_cubed)));
+    _mm_storeu_pd(&ay[b2], _mm_add_pd(_mm_loadu_pd(&ay[b2]),
+                                      _mm_mul_pd(Δqy, μ1_over_Δq_cubed)));
+    _mm_storeu_pd(&az[b2], _mm_add_pd(_mm_loadu_pd(&az[b2]),
+                                      _mm_mul_pd(Δqz, μ1_over_Δq_cubed)));
+
+    __m128d const μ2_over_Δq_cubed =
+        _mm_mul_pd(_mm_loadu_pd(&μ[b2]), one_over_Δq_cubed);
+    a1x = _mm_sub_pd(a1x, _mm_mul_pd(Δqx, μ2_over_Δq_cubed));
+    a1y = _mm_sub_pd(a1y, _mm_mul_pd(Δqy, μ2_over_Δq_cubed));
+    a1z = _mm_sub_pd(a1z, _mm_mul_pd(Δqz, μ2_over_Δq_cubed));
+  }
+  double a1x_lanes[kLanes];
+  double a1y_lanes[kLanes];
+  double a1z_lanes[kLanes];
+  _mm_storeu_pd(a1x_lanes, a1x);
+  _mm_storeu_pd(a1y_lanes, a1y);
+  _mm_storeu_pd(a1z_lanes, a1z);
+#endif
+
+  // The remaining pairs, if any.
+  double a1x_remainder = 0.0;
+  double a1y_remainder = 0.0;
+  double a1z_remainder = 0.0;
+  for (; b2 < b2_end; ++b2) {
+    AddGravitationalAccelerationsBetweenTwoPointMasses(
+        x[b1], y[b1], z[b1], μ[b1],
+        b2,
+        x, y, z, μ,
+        ax, ay, az,
+        &a1x_remainder, &a1y_remainder, &a1z_remainder);
+  }
+
+  for (int lane = 0; lane < kLanes; ++lane) {
+    ax[b1] += a1x_lanes[lane];
+    ay[b1] += a1y_lanes[lane];
+    az[b1] += a1z_lanes[lane];
+  }
+  ax[b1] += a1x_remainder;
+  ay[b1] += a1y_remainder;
+  az[b1] += a1z_remainder;
+#else
+  AddGravitationalAccelerationsBetweenPointMassesScalar(
+      b1, b2_begin, b2_end,
+      positions,
+      gravitational_parameters,
+      accelerations);
+#endif
+}
+
+inline void AddGravitationalAccelerationsBetweenPointMassesScalar(
+    std::size_t const b1,
+    std::size_t const b2_begin,
+    std::size_t const b2_end,
+    R3ElementsSoA const& positions,
+    std::vector<double> const& gravitational_parameters,
+    not_null<R3ElementsSoA*> const accelerations) {
+  CHECK_LT(b1, b2_begin);
+  double* const ax = accelerations->x.data();
+  double* const ay = accelerations->y.data();
+  double* const az = accelerations->z.data();
+  for (std::size_t b2 = b2_begin; b2 < b2_end; ++b2) {
+    AddGravitationalAccelerationsBetweenTwoPointMasses(
+        positions.x[b1], positions.y[b1], positions.z[b1],
+        gravitational_parameters[b1],
+        b2,
+        positions.x.data(), positions.y.data(), positions.z.data(),
+        gravitational_parameters.data(),
+        ax, ay, az,
+        &ax[b1], &ay[b1], &az[b1]);
+  }
+}
+
+inline void AddGravitationalAccelerationsOnTestParticles(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const begin,
+    std::size_t const end,
+    R3ElementsSoA const& positions,
+    not_null<R3ElementsSoA*> const accelerations) {
+#if ARCH_CPU_HAS_AVX || ARCH_CPU_HAS_SSE2
+  double const* const x = positions.x.data();
+  double const* const y = positions.y.data();
+  double const* const z = positions.z.data();
+  double* const ax = accelerations->x.data();
+  double* const ay = accelerations->y.data();
+  double* const az = accelerations->z.data();
+
+  std::size_t b2 = begin;
+
+#if ARCH_CPU_HAS_AVX
+  // 4 particles per iteration.
+  int const kLanes = 4;
+  __m256d const x1_lanes = _mm256_set1_pd(x1);
+  __m256d const y1_lanes = _mm256_set1_pd(y1);
+  __m256d const z1_lanes = _mm256_set1_pd(z1);
+  __m256d const μ1_lanes = _mm256_set1_pd(μ1);
+  for (; b2 + kLanes <= end; b2 += kLanes) {
+    __m256d const Δqx = _mm256_sub_pd(x1_lanes, _mm256_loadu_pd(&x[b2]));
+    __m256d const Δqy = _mm256_sub_pd(y1_lanes, _mm256_loadu_pd(&y[b2]));
+    __m256d const Δqz = _mm256_sub_pd(z1_lanes, _mm256_loadu_pd(&z[b2]));
+    __m256d const Δq_squared =
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(Δqx, Δqx),
+                                    _mm256_mul_pd(Δqy, Δqy)),
+                      _mm256_mul_pd(Δqz, Δqz));
+    __m256d const one_over_Δq_cubed =
+        _mm256_div_pd(_mm256_sqrt_pd(Δq_squared),
+                      _mm256_mul_pd(Δq_squared, Δq_squared));
+
+    __m256d const μ1_over_Δq_cubed =
+        _mm256_mul_pd(μ1_lanes, one_over_Δq_cubed);
+    _mm256_storeu_pd(&ax[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&ax[b2]),
+                                   _mm256_mul_pd(Δqx, μ1_over_Δq_cubed)));
+    _mm256_storeu_pd(&ay[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&ay[b2]),
+                                   _mm256_mul_pd(Δqy, μ1_over_Δq_cubed)));
+    _mm256_storeu_pd(&az[b2],
+                     _mm256_add_pd(_mm256_loadu_pd(&az[b2]),
+                                   _mm256_mul_pd(Δqz, μ1_over_Δq_cubed)));
+  }
+#else
+  // 2 particles per iteration.
+  int const kLanes = 2;
+  __m128d const x1_lanes = _mm_set1_pd(x1);
+  __m128d const y1_lanes = _mm_set1_pd(y1);
+  __m128d const z1_lanes = _mm_set1_pd(z1);
+  __m128d const μ1_lanes = _mm_set1_pd(μ1);
+  for (; b2 + kLanes <= end; b2 += kLanes) {
+    __m128d const Δqx = _mm_sub_pd(x1_lanes, _mm_loadu_pd(&x[b2]));
+    __m128d const Δqy = _mm_sub_pd(y1_lanes, _mm_loadu_pd(&y[b2]));
+    __m128d const Δqz = _mm_sub_pd(z1_lanes, _mm_loadu_pd(&z[b2]));
+    __m128d const Δq_squared =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(Δqx, Δqx), _mm_mul_pd(Δqy, Δqy)),
+                   _mm_mul_pd(Δqz, Δqz));
+    __m128d const one_over_Δq_cubed =
+        _mm_div_pd(_mm_sqrt_pd(Δq_squared),
+                   _mm_mul_pd(Δq_squared, Δq_squared));
+
+    __m128d const μ1_over_Δq_cubed = _mm_mul_pd(μ1_lanes, one_over_Δq_cubed);
+    _mm_storeu_pd(&ax[b2], _mm_add_pd(_mm_loadu_pd(&ax[b2]),
+                                      _mm_mul_pd(Δqx, μ1_over_Δq_cubed)));
+    _mm_storeu_pd(&ay[b2], _mm_add_pd(_mm_loadu_pd(&ay[b2]),
+                                      _mm_mul_pd(Δqy, μ1_over_Δq_cubed)));
+    _mm_storeu_pd(&az[b2], _mm_add_pd(_mm_loadu_pd(&az[b2]),
+                                      _mm_mul_pd(Δqz, μ1_over_Δq_cubed)));
+  }
+#endif
+
+  // The remaining particles, if any.
+  for (; b2 < end; ++b2) {
+    AddGravitationalAccelerationOnTestParticle(x1, y1, z1, μ1,
+                                               b2,
+                                               x, y, z,
+                                               ax, ay, az);
+  }
+#else
+  AddGravitationalAccelerationsOnTestParticlesScalar(x1, y1, z1, μ1,
+                                                     begin, end,
+                                                     positions,
+                                                     accelerations);
+#endif
+}
+
+inline void AddGravitationalAccelerationsOnTestParticlesScalar(
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    std::size_t const begin,
+    std::size_t const end,
+    R3ElementsSoA const& positions,
+    not_null<R3ElementsSoA*> const accelerations) {
+  for (std::size_t b2 = begin; b2 < end; ++b2) {
+    AddGravitationalAccelerationOnTestParticle(
+        x1, y1, z1, μ1,
+        b2,
+        positions.x.data(), positions.y.data(), positions.z.data(),
+        accelerations->x.data(),
+        accelerations->y.data(),
+        accelerations->z.data());
+  }
+}
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia
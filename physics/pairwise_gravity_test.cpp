@@ -0,0 +1,142 @@
+#include "physics/pairwise_gravity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "testing_utilities/almost_equals.hpp"
+
+namespace principia {
+
+using testing_utilities::AlmostEquals;
+using ::testing::Eq;
+using ::testing::Ne;
+
+namespace physics {
+namespace internal {
+
+class PairwiseGravityTest : public testing::Test {
+ protected:
+  // The rows have all the lengths from 0 to |kBodies - 1|, so the vectorized
+  // kernel has to deal with all possible remainders.
+  PairwiseGravityTest()
+      : positions_(kBodies),
+        vectorized_accelerations_(kBodies),
+        scalar_accelerations_(kBodies) {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<> position_distribution(-1E12, 1E12);
+    std::uniform_real_distribution<> μ_distribution(1E10, 1E20);
+    for (int b = 0; b < kBodies; ++b) {
+      positions_.x[b] = position_distribution(random);
+      positions_.y[b] = position_distribution(random);
+      positions_.z[b] = position_distribution(random);
+      gravitational_parameters_.push_back(μ_distribution(random));
+    }
+  }
+
+  static int const kBodies = 23;
+
+  R3ElementsSoA positions_;
+  std::vector<double> gravitational_parameters_;
+  R3ElementsSoA vectorized_accelerations_;
+  R3ElementsSoA scalar_accelerations_;
+};
+
+TEST_F(PairwiseGravityTest, Clear) {
+  positions_.Clear(3, 5);
+  EXPECT_THAT(positions_.x[2], Ne(0.0));
+  EXPECT_THAT(positions_.x[3], Eq(0.0));
+  EXPECT_THAT(positions_.y[4], Eq(0.0));
+  EXPECT_THAT(positions_.z[4], Eq(0.0));
+  EXPECT_THAT(positions_.z[5], Ne(0.0));
+}
+
+// The vectorized and scalar kernels agree: exactly for the accelerations on the
+// |b2|s, and up to the order of summation for the acceleration on |b1|.
+TEST_F(PairwiseGravityTest, VectorizedAndScalar) {
+  for (int b1 = 0; b1 < kBodies; ++b1) {
+    AddGravitationalAccelerationsBetweenPointMasses(
+        b1, b1 + 1, kBodies,
+        positions_,
+        gravitational_parameters_,
+        &vectorized_accelerations_);
+    AddGravitationalAccelerationsBetweenPointMassesScalar(
+        b1, b1 + 1, kBodies,
+        positions_,
+        gravitational_parameters_,
+        &scalar_accelerations_);
+    for (int b = b1 + 1; b < kBodies; ++b) {
+      EXPECT_THAT(vectorized_accelerations_.x[b],
+                  Eq(scalar_accelerations_.x[b]));
+      EXPECT_THAT(vectorized_accelerations_.y[b],
+                  Eq(scalar_accelerations_.y[b]));
+      EXPECT_THAT(vectorized_accelerations_.z[b],
+                  Eq(scalar_accelerations_.z[b]));
+    }
+    EXPECT_THAT(vectorized_accelerations_.x[b1],
+                AlmostEquals(scalar_accelerations_.x[b1], 0, 20));
+    EXPECT_THAT(vectorized_accelerations_.y[b1],
+                AlmostEquals(scalar_accelerations_.y[b1], 0, 20));
+    EXPECT_THAT(vectorized_accelerations_.z[b1],
+                AlmostEquals(scalar_accelerations_.z[b1], 0, 20));
+    // Make the acceleration on |b1| exact again for the next rows.
+    vectorized_accelerations_.x[b1] = scalar_accelerations_.x[b1];
+    vectorized_accelerations_.y[b1] = scalar_accelerations_.y[b1];
+    vectorized_accelerations_.z[b1] = scalar_accelerations_.z[b1];
+  }
+}
+
+// The vectorized and scalar kernels for the test particles agree exactly.
+TEST_F(PairwiseGravityTest, TestParticles) {
+  for (int begin = 0; begin < kBodies; ++begin) {
+    AddGravitationalAccelerationsOnTestParticles(
+        positions_.x[0], positions_.y[0], positions_.z[0],
+        gravitational_parameters_[0],
+        begin + 1, kBodies,
+        positions_,
+        &vectorized_accelerations_);
+    AddGravitationalAccelerationsOnTestParticlesScalar(
+        positions_.x[0], positions_.y[0], positions_.z[0],
+        gravitational_parameters_[0],
+        begin + 1, kBodies,
+        positions_,
+        &scalar_accelerations_);
+  }
+  EXPECT_THAT(vectorized_accelerations_.x[0], Eq(0.0));
+  for (int b = 1; b < kBodies; ++b) {
+    EXPECT_THAT(vectorized_accelerations_.x[b], Ne(0.0));
+    EXPECT_THAT(vectorized_accelerations_.x[b],
+                Eq(scalar_accelerations_.x[b]));
+    EXPECT_THAT(vectorized_accelerations_.y[b],
+                Eq(scalar_accelerations_.y[b]));
+    EXPECT_THAT(vectorized_accelerations_.z[b],
+                Eq(scalar_accelerations_.z[b]));
+  }
+}
+
+// Newton's third law: the total force vanishes.
+TEST_F(PairwiseGravityTest, Momentum) {
+  for (int b1 = 0; b1 < kBodies; ++b1) {
+    AddGravitationalAccelerationsBetweenPointMasses(
+        b1, b1 + 1, kBodies,
+        positions_,
+        gravitational_parameters_,
+        &vectorized_accelerations_);
+  }
+  double total_x = 0;
+  double max_x = 0;
+  for (int b = 0; b < kBodies; ++b) {
+    double const force_x =
+        gravitational_parameters_[b] * vectorized_accelerations_.x[b];
+    total_x += force_x;
+    max_x = std::max(max_x, std::abs(force_x));
+  }
+  EXPECT_LT(std::abs(total_x), 1E-14 * kBodies * max_x);
+}
+
+}  // namespace internal
+}  // namespace physics
+}  // namespace principia